@@ -125,12 +125,14 @@ class FwupdTest(dbusmock.DBusTestCase):
     # Daemon control and D-BUS I/O
     #
 
-    def start_daemon(self):
+    def start_daemon(self, extra_env=None):
         """Start daemon and create DBus proxy.
 
         When done, this sets self.proxy as the Gio.DBusProxy for power-profiles-daemon.
         """
         env = os.environ.copy()
+        if extra_env:
+            env.update(extra_env)
         env["G_DEBUG"] = "fatal-criticals"
         env["G_MESSAGES_DEBUG"] = "all"
         # note: Python doesn't propagate the setenv from Testbed.new(), so we
@@ -322,6 +324,113 @@ class VeryBasicTest(FwupdTest):
         self.assertGreater(len(devices), 0)
 
 
+class SignalOrderTest(FwupdTest):
+    """Test that signals are not reordered with method replies."""
+
+    DEVICE_ID = "08d460be0f1f9f128413f816022a6439e0078018"
+    DEVICE_FLAG_NEEDS_REBOOT = 1 << 8
+
+    def setUp(self):
+        super().setUp()
+        self.confdir = tempfile.TemporaryDirectory()  # pylint: disable=consider-using-with
+        with open(
+            os.path.join(self.confdir.name, "fwupd.conf"), "w", encoding="utf-8"
+        ) as tmpf:
+            tmpf.write(
+                "[fwupd]\n"
+                "TestDevices=true\n"
+                "OnlyTrusted=false\n"
+                "IgnorePower=true\n"
+                "SignalCoalesceWindow=10000\n"
+                "[test]\n"
+                "NeedsReboot=true\n"
+            )
+
+    def tearDown(self):
+        super().tearDown()
+        self.confdir.cleanup()
+
+    def test_install_needs_reboot(self):
+        """Test DeviceChanged with NEEDS_REBOOT is emitted before the Install reply."""
+        if "INSTALLED_TESTS_DIR" in os.environ:
+            testsdir = os.environ["INSTALLED_TESTS_DIR"]
+        else:
+            testsdir = "@INSTALLEDTESTSDIR@"
+        filename = os.path.join(testsdir, "fakedevice124.cab")
+        if not os.path.exists(filename):
+            self.skipTest(f"{filename} not found")
+
+        # a long coalesce window means the signal would still be pending without a flush
+        self.start_daemon(extra_env={"LOCALCONF_DIRECTORY": self.confdir.name})
+
+        flags_seen = []
+        replies = []
+
+        def device_changed_cb(_conn, _sender, _path, _iface, _signal, params):
+            (device,) = params.unpack()
+            if device.get("DeviceId") == self.DEVICE_ID:
+                flags_seen.append(device.get("Flags", 0))
+
+        self.addCleanup(
+            self.dbus.signal_unsubscribe,
+            self.dbus.signal_subscribe(
+                self.DBUS_NAME,
+                self.DBUS_INTERFACE,
+                "DeviceChanged",
+                self.DBUS_PATH,
+                None,
+                Gio.DBusSignalFlags.NONE,
+                device_changed_cb,
+            ),
+        )
+
+        def install_cb(conn, res):
+            try:
+                conn.call_with_unix_fd_list_finish(res)
+                replies.append(list(flags_seen))
+            except GLib.Error as exc:
+                replies.append(exc)
+
+        fd_list = Gio.UnixFDList.new_from_array([os.open(filename, os.O_RDONLY)])
+        self.dbus.call_with_unix_fd_list(
+            self.DBUS_NAME,
+            self.DBUS_PATH,
+            self.DBUS_INTERFACE,
+            "Install",
+            GLib.Variant("(sha{sv})", (self.DEVICE_ID, 0, {})),
+            None,
+            Gio.DBusCallFlags.NONE,
+            -1,
+            fd_list,
+            None,
+            install_cb,
+        )
+        self.assert_eventually(lambda: replies, timeout=30000)
+        self.assertNotIsInstance(replies[0], GLib.Error)
+
+        # the client only sees the flags that were sent before the reply
+        self.assertTrue(
+            any(flags & self.DEVICE_FLAG_NEEDS_REBOOT for flags in replies[0]),
+            "NEEDS_REBOOT not emitted before the Install reply",
+        )
+
+        # the metric is recorded when the authorized method returns
+        (metrics,) = self.dbus.call_sync(
+            self.DBUS_NAME,
+            self.DBUS_PATH,
+            self.DBUS_INTERFACE,
+            "GetMetrics",
+            None,
+            GLib.VariantType("(aa{sv})"),
+            Gio.DBusCallFlags.NONE,
+            -1,
+            None,
+        ).unpack()
+        install = [m for m in metrics if m["Kind"] == "dbus" and m["Name"] == "Install"]
+        self.assertEqual(len(install), 1)
+        self.assertEqual(install[0]["Count"], 1)
+
+
 if __name__ == "__main__":
     # run ourselves under umockdev
     if "umockdev" not in os.environ.get("LD_PRELOAD", ""):
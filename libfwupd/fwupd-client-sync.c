@@ -1923,6 +1923,50 @@ fwupd_client_get_report_metadata(FwupdClient *self, GCancellable *cancellable, G
 	return g_steal_pointer(&helper->hash);
 }
 
+static void
+fwupd_client_get_metrics_cb(GObject *source, GAsyncResult *res, gpointer user_data)
+{
+	FwupdClientHelper *helper = (FwupdClientHelper *)user_data;
+	helper->val = fwupd_client_get_metrics_finish(FWUPD_CLIENT(source), res, &helper->error);
+	g_main_loop_quit(helper->loop);
+}
+
+/**
+ * fwupd_client_get_metrics:
+ * @self: a #FwupdClient
+ * @cancellable: (nullable): optional #GCancellable
+ * @error: (nullable): optional return location for an error
+ *
+ * Gets the call counts and latency histograms recorded by the daemon.
+ *
+ * Returns: (transfer full): a #GVariant of type `aa{sv}`, or %NULL for error
+ *
+ * Since: 2.0.0
+ **/
+GVariant *
+fwupd_client_get_metrics(FwupdClient *self, GCancellable *cancellable, GError **error)
+{
+	g_autoptr(FwupdClientHelper) helper = NULL;
+
+	g_return_val_if_fail(FWUPD_IS_CLIENT(self), NULL);
+	g_return_val_if_fail(cancellable == NULL || G_IS_CANCELLABLE(cancellable), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* connect */
+	if (!fwupd_client_connect(self, cancellable, error))
+		return NULL;
+
+	/* call async version and run loop until complete */
+	helper = fwupd_client_helper_new(self);
+	fwupd_client_get_metrics_async(self, cancellable, fwupd_client_get_metrics_cb, helper);
+	g_main_loop_run(helper->loop);
+	if (helper->val == NULL) {
+		g_propagate_error(error, g_steal_pointer(&helper->error));
+		return NULL;
+	}
+	return g_steal_pointer(&helper->val);
+}
+
 static void
 fwupd_client_modify_device_cb(GObject *source, GAsyncResult *res, gpointer user_data)
 {
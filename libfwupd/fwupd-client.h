@@ -401,6 +401,14 @@ fwupd_client_get_report_metadata_finish(FwupdClient *self,
 					GError **error) G_GNUC_WARN_UNUSED_RESULT
     G_GNUC_NON_NULL(1, 2);
 void
+fwupd_client_get_metrics_async(FwupdClient *self,
+			       GCancellable *cancellable,
+			       GAsyncReadyCallback callback,
+			       gpointer callback_data) G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_client_get_metrics_finish(FwupdClient *self, GAsyncResult *res, GError **error)
+    G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 2);
+void
 fwupd_client_inhibit_async(FwupdClient *self,
 			   const gchar *reason,
 			   GCancellable *cancellable,
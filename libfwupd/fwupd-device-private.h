@@ -16,9 +16,13 @@ GVariant *
 fwupd_device_to_variant(FwupdDevice *self) G_GNUC_NON_NULL(1);
 GVariant *
 fwupd_device_to_variant_full(FwupdDevice *self, FwupdDeviceFlags flags) G_GNUC_NON_NULL(1);
+GVariant *
+fwupd_device_to_variant_cached(FwupdDevice *self, FwupdDeviceFlags flags) G_GNUC_NON_NULL(1);
 void
 fwupd_device_incorporate(FwupdDevice *self, FwupdDevice *donor) G_GNUC_NON_NULL(1, 2);
 void
+fwupd_device_clear_instance_ids(FwupdDevice *self) G_GNUC_NON_NULL(1);
+void
 fwupd_device_to_json(FwupdDevice *self, JsonBuilder *builder) G_GNUC_NON_NULL(1, 2);
 void
 fwupd_device_to_json_full(FwupdDevice *self, JsonBuilder *builder, FwupdDeviceFlags flags)
@@ -70,7 +70,8 @@ typedef struct {
 	FwupdStatus status;
 	guint percentage;
 	GPtrArray *releases;
-	FwupdDevice *parent; /* noref */
+	FwupdDevice *parent;        /* noref */
+	GVariant *variant_cache[2]; /* indexed by FWUPD_DEVICE_FLAG_TRUSTED */
 } FwupdDevicePrivate;
 
 enum {
@@ -97,6 +98,14 @@ G_DEFINE_TYPE_WITH_PRIVATE(FwupdDevice, fwupd_device, G_TYPE_OBJECT)
 
 #define FWUPD_BATTERY_THRESHOLD_DEFAULT 10 /* % */
 
+static void
+fwupd_device_variant_cache_clear(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	for (guint i = 0; i < G_N_ELEMENTS(priv->variant_cache); i++)
+		g_clear_pointer(&priv->variant_cache[i], g_variant_unref);
+}
+
 /**
  * fwupd_device_get_checksums:
  * @self: a #FwupdDevice
@@ -160,6 +169,7 @@ fwupd_device_add_checksum(FwupdDevice *self, const gchar *checksum)
 
 	if (fwupd_device_has_checksum(self, checksum))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	g_ptr_array_add(priv->checksums, g_strdup(checksum));
 }
 
@@ -196,6 +206,7 @@ fwupd_device_add_issue(FwupdDevice *self, const gchar *issue)
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	g_return_if_fail(issue != NULL);
+	fwupd_device_variant_cache_clear(self);
 	for (guint i = 0; i < priv->issues->len; i++) {
 		const gchar *issue_tmp = g_ptr_array_index(priv->issues, i);
 		if (g_strcmp0(issue_tmp, issue) == 0)
@@ -258,6 +269,7 @@ fwupd_device_set_summary(FwupdDevice *self, const gchar *summary)
 	/* not changed */
 	if (g_strcmp0(priv->summary, summary) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->summary);
 	priv->summary = g_strdup(summary);
@@ -299,6 +311,7 @@ fwupd_device_set_branch(FwupdDevice *self, const gchar *branch)
 	/* not changed */
 	if (g_strcmp0(priv->branch, branch) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->branch);
 	priv->branch = g_strdup(branch);
@@ -340,6 +353,7 @@ fwupd_device_set_serial(FwupdDevice *self, const gchar *serial)
 	/* not changed */
 	if (g_strcmp0(priv->serial, serial) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->serial);
 	priv->serial = g_strdup(serial);
@@ -381,6 +395,7 @@ fwupd_device_set_id(FwupdDevice *self, const gchar *id)
 	/* not changed */
 	if (g_strcmp0(priv->id, id) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->id);
 	priv->id = g_strdup(id);
@@ -422,6 +437,7 @@ fwupd_device_set_parent_id(FwupdDevice *self, const gchar *parent_id)
 	/* not changed */
 	if (g_strcmp0(priv->parent_id, parent_id) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->parent_id);
 	priv->parent_id = g_strdup(parent_id);
@@ -469,6 +485,7 @@ fwupd_device_set_composite_id(FwupdDevice *self, const gchar *composite_id)
 	/* not changed */
 	if (g_strcmp0(priv->composite_id, composite_id) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->composite_id);
 	priv->composite_id = g_strdup(composite_id);
@@ -531,6 +548,8 @@ fwupd_device_set_parent(FwupdDevice *self, FwupdDevice *parent)
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	g_return_if_fail(self != parent);
 
+	fwupd_device_variant_cache_clear(self);
+
 	if (priv->parent != NULL)
 		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
 	if (parent != NULL)
@@ -572,6 +591,8 @@ fwupd_device_add_child(FwupdDevice *self, FwupdDevice *child)
 	g_return_if_fail(FWUPD_IS_DEVICE(child));
 	g_return_if_fail(self != child);
 
+	fwupd_device_variant_cache_clear(self);
+
 	/* add if the child does not already exist */
 	for (guint i = 0; i < priv->children->len; i++) {
 		FwupdDevice *devtmp = g_ptr_array_index(priv->children, i);
@@ -599,6 +620,8 @@ fwupd_device_remove_child(FwupdDevice *self, FwupdDevice *child)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 
+	fwupd_device_variant_cache_clear(self);
+
 	/* remove if the child exists */
 	for (guint i = 0; i < priv->children->len; i++) {
 		FwupdDevice *child_tmp = g_ptr_array_index(priv->children, i);
@@ -672,6 +695,7 @@ fwupd_device_add_guid(FwupdDevice *self, const gchar *guid)
 	g_return_if_fail(guid != NULL);
 	if (fwupd_device_has_guid(self, guid))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	g_ptr_array_add(priv->guids, g_strdup(guid));
 }
 
@@ -757,9 +781,27 @@ fwupd_device_add_instance_id(FwupdDevice *self, const gchar *instance_id)
 	g_return_if_fail(instance_id != NULL);
 	if (fwupd_device_has_instance_id(self, instance_id))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	g_ptr_array_add(priv->instance_ids, g_strdup(instance_id));
 }
 
+/**
+ * fwupd_device_clear_instance_ids:
+ * @self: a #FwupdDevice
+ *
+ * Removes all the instance IDs.
+ *
+ * Since: 2.0.0
+ **/
+void
+fwupd_device_clear_instance_ids(FwupdDevice *self)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
+	g_ptr_array_set_size(priv->instance_ids, 0);
+}
+
 /**
  * fwupd_device_get_icons:
  * @self: a #FwupdDevice
@@ -821,6 +863,7 @@ fwupd_device_add_icon(FwupdDevice *self, const gchar *icon)
 	g_return_if_fail(icon != NULL);
 	if (fwupd_device_has_icon(self, icon))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	g_ptr_array_add(priv->icons, g_strdup(icon));
 }
 
@@ -860,6 +903,7 @@ fwupd_device_set_name(FwupdDevice *self, const gchar *name)
 	/* not changed */
 	if (g_strcmp0(priv->name, name) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->name);
 	priv->name = g_strdup(name);
@@ -901,6 +945,7 @@ fwupd_device_set_vendor(FwupdDevice *self, const gchar *vendor)
 	/* not changed */
 	if (g_strcmp0(priv->vendor, vendor) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->vendor);
 	priv->vendor = g_strdup(vendor);
@@ -971,6 +1016,7 @@ fwupd_device_add_vendor_id(FwupdDevice *self, const gchar *vendor_id)
 
 	if (fwupd_device_has_vendor_id(self, vendor_id))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	g_ptr_array_add(priv->vendor_ids, g_strdup(vendor_id));
 
 	/* build for compatibility */
@@ -1019,6 +1065,7 @@ fwupd_device_set_version(FwupdDevice *self, const gchar *version)
 	/* not changed */
 	if (g_strcmp0(priv->version, version) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->version);
 	priv->version = g_strdup(version);
@@ -1061,6 +1108,7 @@ fwupd_device_set_version_lowest(FwupdDevice *self, const gchar *version_lowest)
 	/* not changed */
 	if (g_strcmp0(priv->version_lowest, version_lowest) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->version_lowest);
 	priv->version_lowest = g_strdup(version_lowest);
@@ -1098,6 +1146,7 @@ fwupd_device_set_version_lowest_raw(FwupdDevice *self, guint64 version_lowest_ra
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->version_lowest_raw = version_lowest_raw;
 }
 
@@ -1137,6 +1186,7 @@ fwupd_device_set_version_bootloader(FwupdDevice *self, const gchar *version_boot
 	/* not changed */
 	if (g_strcmp0(priv->version_bootloader, version_bootloader) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->version_bootloader);
 	priv->version_bootloader = g_strdup(version_bootloader);
@@ -1174,6 +1224,7 @@ fwupd_device_set_version_bootloader_raw(FwupdDevice *self, guint64 version_bootl
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->version_bootloader_raw = version_bootloader_raw;
 }
 
@@ -1209,6 +1260,7 @@ fwupd_device_set_flashes_left(FwupdDevice *self, guint32 flashes_left)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->flashes_left = flashes_left;
 }
 
@@ -1252,6 +1304,7 @@ fwupd_device_set_battery_level(FwupdDevice *self, guint32 battery_level)
 
 	if (priv->battery_level == battery_level)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->battery_level = battery_level;
 	g_object_notify(G_OBJECT(self), "battery-level");
 }
@@ -1306,6 +1359,7 @@ fwupd_device_set_battery_threshold(FwupdDevice *self, guint32 battery_threshold)
 
 	if (priv->battery_threshold == battery_threshold)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->battery_threshold = battery_threshold;
 	g_object_notify(G_OBJECT(self), "battery-threshold");
 }
@@ -1342,6 +1396,7 @@ fwupd_device_set_install_duration(FwupdDevice *self, guint32 duration)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->install_duration = duration;
 }
 
@@ -1381,6 +1436,7 @@ fwupd_device_set_plugin(FwupdDevice *self, const gchar *plugin)
 	/* not changed */
 	if (g_strcmp0(priv->plugin, plugin) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->plugin);
 	priv->plugin = g_strdup(plugin);
@@ -1450,6 +1506,7 @@ fwupd_device_add_protocol(FwupdDevice *self, const gchar *protocol)
 
 	if (fwupd_device_has_protocol(self, protocol))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	g_ptr_array_add(priv->protocols, g_strdup(protocol));
 }
 
@@ -1487,6 +1544,7 @@ fwupd_device_set_flags(FwupdDevice *self, guint64 flags)
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	if (priv->flags == flags)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->flags = flags;
 	g_object_notify(G_OBJECT(self), "flags");
 }
@@ -1509,6 +1567,7 @@ fwupd_device_add_flag(FwupdDevice *self, FwupdDeviceFlags flag)
 		return;
 	if ((priv->flags | flag) == priv->flags)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->flags |= flag;
 	g_object_notify(G_OBJECT(self), "flags");
 }
@@ -1531,6 +1590,7 @@ fwupd_device_remove_flag(FwupdDevice *self, FwupdDeviceFlags flag)
 		return;
 	if ((priv->flags & flag) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->flags &= ~flag;
 	g_object_notify(G_OBJECT(self), "flags");
 }
@@ -1588,6 +1648,7 @@ fwupd_device_set_problems(FwupdDevice *self, guint64 problems)
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	if (priv->problems == problems)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->problems = problems;
 	g_object_notify(G_OBJECT(self), "problems");
 }
@@ -1610,6 +1671,7 @@ fwupd_device_add_problem(FwupdDevice *self, FwupdDeviceProblem problem)
 		return;
 	if (fwupd_device_has_problem(self, problem))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->problems |= problem;
 	g_object_notify(G_OBJECT(self), "problems");
 }
@@ -1632,6 +1694,7 @@ fwupd_device_remove_problem(FwupdDevice *self, FwupdDeviceProblem problem)
 		return;
 	if (!fwupd_device_has_problem(self, problem))
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->problems &= ~problem;
 	g_object_notify(G_OBJECT(self), "problems");
 }
@@ -1689,6 +1752,7 @@ fwupd_device_set_request_flags(FwupdDevice *self, guint64 request_flags)
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	if (priv->request_flags == request_flags)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->request_flags = request_flags;
 	g_object_notify(G_OBJECT(self), "request-flags");
 }
@@ -1711,6 +1775,7 @@ fwupd_device_add_request_flag(FwupdDevice *self, FwupdRequestFlags request_flag)
 		return;
 	if ((priv->request_flags | request_flag) == priv->request_flags)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->request_flags |= request_flag;
 	g_object_notify(G_OBJECT(self), "request-flags");
 }
@@ -1733,6 +1798,7 @@ fwupd_device_remove_request_flag(FwupdDevice *self, FwupdRequestFlags request_fl
 		return;
 	if ((priv->request_flags & request_flag) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->request_flags &= ~request_flag;
 	g_object_notify(G_OBJECT(self), "request-flags");
 }
@@ -1788,6 +1854,7 @@ fwupd_device_set_created(FwupdDevice *self, guint64 created)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->created = created;
 }
 
@@ -1823,6 +1890,7 @@ fwupd_device_set_modified(FwupdDevice *self, guint64 modified)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->modified = modified;
 }
 
@@ -2235,6 +2303,36 @@ fwupd_device_to_variant_full(FwupdDevice *self, FwupdDeviceFlags flags)
 	return g_variant_new("a{sv}", &builder);
 }
 
+/**
+ * fwupd_device_to_variant_cached:
+ * @self: a #FwupdDevice
+ * @flags: device flags
+ *
+ * Serialize the device data, reusing the result of the last call with the same trust level if the
+ * device has not been modified since.
+ *
+ * Returns: (transfer full): the serialized data, or %NULL for error
+ *
+ * Since: 2.0.0
+ **/
+GVariant *
+fwupd_device_to_variant_cached(FwupdDevice *self, FwupdDeviceFlags flags)
+{
+	FwupdDevicePrivate *priv = GET_PRIVATE(self);
+	guint idx = (flags & FWUPD_DEVICE_FLAG_TRUSTED) > 0 ? 1 : 0;
+
+	g_return_val_if_fail(FWUPD_IS_DEVICE(self), NULL);
+
+	/* releases can be modified without the device knowing */
+	if (priv->releases->len > 0)
+		return g_variant_ref_sink(fwupd_device_to_variant_full(self, flags));
+	if (priv->variant_cache[idx] == NULL) {
+		priv->variant_cache[idx] =
+		    g_variant_ref_sink(fwupd_device_to_variant_full(self, flags));
+	}
+	return g_variant_ref(priv->variant_cache[idx]);
+}
+
 /**
  * fwupd_device_to_variant:
  * @self: a #FwupdDevice
@@ -2528,6 +2626,7 @@ fwupd_device_set_update_state(FwupdDevice *self, FwupdUpdateState update_state)
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	if (priv->update_state == update_state)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->update_state = update_state;
 	g_object_notify(G_OBJECT(self), "update-state");
 }
@@ -2564,6 +2663,7 @@ fwupd_device_set_version_format(FwupdDevice *self, FwupdVersionFormat version_fo
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->version_format = version_format;
 }
 
@@ -2599,6 +2699,7 @@ fwupd_device_set_version_raw(FwupdDevice *self, guint64 version_raw)
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->version_raw = version_raw;
 }
 
@@ -2634,6 +2735,7 @@ fwupd_device_set_version_build_date(FwupdDevice *self, guint64 version_build_dat
 {
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
+	fwupd_device_variant_cache_clear(self);
 	priv->version_build_date = version_build_date;
 }
 
@@ -2673,6 +2775,7 @@ fwupd_device_set_update_message(FwupdDevice *self, const gchar *update_message)
 	/* not changed */
 	if (g_strcmp0(priv->update_message, update_message) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->update_message);
 	priv->update_message = g_strdup(update_message);
@@ -2715,6 +2818,7 @@ fwupd_device_set_update_image(FwupdDevice *self, const gchar *update_image)
 	/* not changed */
 	if (g_strcmp0(priv->update_image, update_image) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->update_image);
 	priv->update_image = g_strdup(update_image);
@@ -2757,6 +2861,7 @@ fwupd_device_set_update_error(FwupdDevice *self, const gchar *update_error)
 	/* not changed */
 	if (g_strcmp0(priv->update_error, update_error) == 0)
 		return;
+	fwupd_device_variant_cache_clear(self);
 
 	g_free(priv->update_error);
 	priv->update_error = g_strdup(update_error);
@@ -2816,6 +2921,7 @@ fwupd_device_add_release(FwupdDevice *self, FwupdRelease *release)
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	g_return_if_fail(FWUPD_IS_RELEASE(release));
+	fwupd_device_variant_cache_clear(self);
 	g_ptr_array_add(priv->releases, g_object_ref(release));
 }
 
@@ -2853,6 +2959,7 @@ fwupd_device_set_status(FwupdDevice *self, FwupdStatus status)
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	if (priv->status == status)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->status = status;
 	g_object_notify(G_OBJECT(self), "status");
 }
@@ -2891,6 +2998,7 @@ fwupd_device_set_percentage(FwupdDevice *self, guint percentage)
 	g_return_if_fail(FWUPD_IS_DEVICE(self));
 	if (priv->percentage == percentage)
 		return;
+	fwupd_device_variant_cache_clear(self);
 	priv->percentage = percentage;
 	g_object_notify(G_OBJECT(self), "percentage");
 }
@@ -3946,6 +4054,7 @@ fwupd_device_finalize(GObject *object)
 	FwupdDevice *self = FWUPD_DEVICE(object);
 	FwupdDevicePrivate *priv = GET_PRIVATE(self);
 
+	fwupd_device_variant_cache_clear(self);
 	if (priv->parent != NULL)
 		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
 	for (guint i = 0; i < priv->children->len; i++) {
@@ -534,6 +534,110 @@ fwupd_device_filter_func(void)
 					       FWUPD_DEVICE_FLAG_ANOTHER_WRITE_REQUIRED));
 }
 
+static void
+fwupd_device_variant_cache_func(void)
+{
+	g_autoptr(FwupdDevice) dev = fwupd_device_new();
+	g_autoptr(GVariant) val1 = NULL;
+	g_autoptr(GVariant) val2 = NULL;
+	g_autoptr(GVariant) val3 = NULL;
+	g_autoptr(GVariant) val4 = NULL;
+	g_autoptr(GVariant) val5 = NULL;
+	g_autoptr(GVariant) val6 = NULL;
+	g_autofree gchar *str = NULL;
+	g_autofree gchar *str2 = NULL;
+	g_autofree gchar *str3 = NULL;
+
+	fwupd_device_set_id(dev, "362301da643102b9f38477387e2193e57abaa590");
+	fwupd_device_set_name(dev, "ColorHug2");
+	fwupd_device_set_serial(dev, "ABCDEF");
+
+	/* unchanged device reuses the same serialized data */
+	val1 = fwupd_device_to_variant_cached(dev, FWUPD_DEVICE_FLAG_NONE);
+	val2 = fwupd_device_to_variant_cached(dev, FWUPD_DEVICE_FLAG_NONE);
+	g_assert_true(val1 == val2);
+
+	/* the trust level is cached separately */
+	val3 = fwupd_device_to_variant_cached(dev, FWUPD_DEVICE_FLAG_TRUSTED);
+	g_assert_true(val1 != val3);
+	g_assert_false(g_variant_equal(val1, val3));
+
+	/* modifying the device invalidates the cache */
+	fwupd_device_set_name(dev, "ColorHug3");
+	val4 = fwupd_device_to_variant_cached(dev, FWUPD_DEVICE_FLAG_NONE);
+	g_assert_true(val1 != val4);
+	str = g_variant_print(val4, FALSE);
+	g_assert_nonnull(g_strstr_len(str, -1, "ColorHug3"));
+
+	/* so does removing the instance IDs */
+	fwupd_device_add_instance_id(dev, "USB\\VID_273F&PID_1004");
+	val5 = fwupd_device_to_variant_cached(dev, FWUPD_DEVICE_FLAG_TRUSTED);
+	str2 = g_variant_print(val5, FALSE);
+	g_assert_nonnull(g_strstr_len(str2, -1, "PID_1004"));
+	fwupd_device_clear_instance_ids(dev);
+	g_assert_cmpint(fwupd_device_get_instance_ids(dev)->len, ==, 0);
+	val6 = fwupd_device_to_variant_cached(dev, FWUPD_DEVICE_FLAG_TRUSTED);
+	g_assert_true(val5 != val6);
+	str3 = g_variant_print(val6, FALSE);
+	g_assert_null(g_strstr_len(str3, -1, "PID_1004"));
+}
+
+static void
+fwupd_device_variant_cache_performance_func(void)
+{
+	const guint ndevices = 500;
+	const guint loops = 100;
+	g_autoptr(GPtrArray) devices = g_ptr_array_new_with_free_func(g_object_unref);
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	for (guint i = 0; i < ndevices; i++) {
+		g_autoptr(FwupdDevice) dev = fwupd_device_new();
+		g_autofree gchar *id = g_strdup_printf("%040x", i);
+		fwupd_device_set_id(dev, id);
+		fwupd_device_set_name(dev, "ColorHug2");
+		fwupd_device_set_vendor(dev, "Hughski Limited");
+		fwupd_device_set_version(dev, "1.2.3");
+		fwupd_device_set_plugin(dev, "colorhug");
+		fwupd_device_add_guid(dev, "2082b5e0-7a64-478a-b1b2-e3404fab6dad");
+		fwupd_device_add_instance_id(dev, "USB\\VID_273F&PID_1004");
+		fwupd_device_add_protocol(dev, "com.hughski.colorhug");
+		fwupd_device_add_icon(dev, "input-tablet");
+		fwupd_device_add_flag(dev, FWUPD_DEVICE_FLAG_UPDATABLE);
+		g_ptr_array_add(devices, g_steal_pointer(&dev));
+	}
+
+	/* rebuild every time */
+	for (guint j = 0; j < loops; j++) {
+		GVariantBuilder builder;
+		g_autoptr(GVariant) val = NULL;
+		g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+		for (guint i = 0; i < devices->len; i++) {
+			FwupdDevice *dev = g_ptr_array_index(devices, i);
+			GVariant *tmp = fwupd_device_to_variant_full(dev, FWUPD_DEVICE_FLAG_NONE);
+			g_variant_builder_add_value(&builder, tmp);
+		}
+		val = g_variant_ref_sink(g_variant_builder_end(&builder));
+	}
+	g_print("full=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f / loops);
+
+	/* only one device changes between calls */
+	g_timer_reset(timer);
+	for (guint j = 0; j < loops; j++) {
+		GVariantBuilder builder;
+		g_autoptr(GVariant) val = NULL;
+		fwupd_device_set_percentage(g_ptr_array_index(devices, 0), j);
+		g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+		for (guint i = 0; i < devices->len; i++) {
+			FwupdDevice *dev = g_ptr_array_index(devices, i);
+			g_autoptr(GVariant) tmp =
+			    fwupd_device_to_variant_cached(dev, FWUPD_DEVICE_FLAG_NONE);
+			g_variant_builder_add_value(&builder, tmp);
+		}
+		val = g_variant_ref_sink(g_variant_builder_end(&builder));
+	}
+	g_print("cached=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f / loops);
+}
+
 static void
 fwupd_common_history_report_func(void)
 {
@@ -1369,6 +1473,11 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/request", fwupd_request_func);
 	g_test_add_func("/fwupd/device", fwupd_device_func);
 	g_test_add_func("/fwupd/device{filter}", fwupd_device_filter_func);
+	g_test_add_func("/fwupd/device{variant-cache}", fwupd_device_variant_cache_func);
+	if (g_test_slow()) {
+		g_test_add_func("/fwupd/device{variant-cache-performance}",
+				fwupd_device_variant_cache_performance_func);
+	}
 	g_test_add_func("/fwupd/security-attr", fwupd_security_attr_func);
 	g_test_add_func("/fwupd/bios-attrs", fwupd_bios_settings_func);
 	if (fwupd_has_system_bus()) {
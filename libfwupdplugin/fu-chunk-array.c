@@ -10,7 +10,8 @@
 
 #include "fu-bytes.h"
 #include "fu-chunk-array.h"
-#include "fu-input-stream.h"
+#include "fu-crc.h"
+#include "fu-input-stream-private.h"
 
 /**
  * FuChunkArray:
@@ -21,6 +22,36 @@
  * e.g. once to split to page size, and once to split to packet size.
  */
 
+/* stream-backed arrays read this much at once, rounded down to a multiple of the packet size */
+#define FU_CHUNK_ARRAY_WINDOW_SIZE 0x40000
+
+/* number of spare window buffers to keep for reuse */
+#define FU_CHUNK_ARRAY_POOL_MAX 2
+
+/* window buffers are recycled when the last chunk that references them is destroyed, which may
+ * be after the array itself has been finalized -- so the pool is refcounted */
+typedef struct {
+	gint refcount;
+	GMutex mutex;
+	GPtrArray *bufs; /* (element-type guint8) */
+	gsize bufsz;
+} FuChunkArrayPool;
+
+typedef struct {
+	FuChunkArrayPool *pool;
+	guint8 *buf;
+} FuChunkArrayPoolBuf;
+
+typedef struct {
+	GInputStream *stream;
+	FuChunkArrayPool *pool;
+	gsize offset;
+	gsize length;
+	GBytes *blob;
+	GError *error;
+	GThread *thread;
+} FuChunkArrayPrefetch;
+
 struct _FuChunkArray {
 	GObject parent_instance;
 	GBytes *blob;
@@ -29,10 +60,228 @@ struct _FuChunkArray {
 	guint32 packet_sz;
 	guint total_chunks;
 	gsize total_size;
+	gboolean prefetch_enabled;
+	gsize window_sz;
+	gsize window_offset;
+	GBytes *window;			/* (nullable) */
+	FuChunkArrayPool *pool;		/* (nullable) */
+	FuChunkArrayPrefetch *prefetch; /* (nullable) */
 };
 
 G_DEFINE_TYPE(FuChunkArray, fu_chunk_array, G_TYPE_OBJECT)
 
+static FuChunkArrayPool *
+fu_chunk_array_pool_new(gsize bufsz)
+{
+	FuChunkArrayPool *pool = g_new0(FuChunkArrayPool, 1);
+	pool->refcount = 1;
+	pool->bufsz = bufsz;
+	pool->bufs = g_ptr_array_new_with_free_func(g_free);
+	g_mutex_init(&pool->mutex);
+	return pool;
+}
+
+static FuChunkArrayPool *
+fu_chunk_array_pool_ref(FuChunkArrayPool *pool)
+{
+	g_atomic_int_inc(&pool->refcount);
+	return pool;
+}
+
+static void
+fu_chunk_array_pool_unref(FuChunkArrayPool *pool)
+{
+	if (!g_atomic_int_dec_and_test(&pool->refcount))
+		return;
+	g_ptr_array_unref(pool->bufs);
+	g_mutex_clear(&pool->mutex);
+	g_free(pool);
+}
+
+static guint8 *
+fu_chunk_array_pool_acquire(FuChunkArrayPool *pool)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&pool->mutex);
+	if (pool->bufs->len > 0)
+		return g_ptr_array_steal_index_fast(pool->bufs, pool->bufs->len - 1);
+	return g_malloc(pool->bufsz);
+}
+
+static void
+fu_chunk_array_pool_release(FuChunkArrayPool *pool, guint8 *buf)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&pool->mutex);
+	if (pool->bufs->len >= FU_CHUNK_ARRAY_POOL_MAX) {
+		g_free(buf);
+		return;
+	}
+	g_ptr_array_add(pool->bufs, buf);
+}
+
+static void
+fu_chunk_array_pool_buf_free(gpointer user_data)
+{
+	FuChunkArrayPoolBuf *pbuf = (FuChunkArrayPoolBuf *)user_data;
+	fu_chunk_array_pool_release(pbuf->pool, pbuf->buf);
+	fu_chunk_array_pool_unref(pbuf->pool);
+	g_free(pbuf);
+}
+
+/* this is called from the prefetch thread, so must not use the FuChunkArray */
+static GBytes *
+fu_chunk_array_read_window(GInputStream *stream,
+			   FuChunkArrayPool *pool,
+			   gsize offset,
+			   gsize length,
+			   GError **error)
+{
+	gsize bytes_read = 0;
+	guint8 *buf;
+	GBytes *blob;
+	FuChunkArrayPoolBuf *pbuf;
+
+	/* mapped files do not need copying at all */
+	blob = fu_input_stream_read_bytes_view(stream, offset, length);
+	if (blob != NULL)
+		return blob;
+
+	buf = fu_chunk_array_pool_acquire(pool);
+	if (!g_seekable_seek(G_SEEKABLE(stream), offset, G_SEEK_SET, NULL, error)) {
+		g_prefix_error(error, "seek to 0x%x: ", (guint)offset);
+		fu_chunk_array_pool_release(pool, buf);
+		return NULL;
+	}
+	if (!g_input_stream_read_all(stream, buf, length, &bytes_read, NULL, error)) {
+		g_prefix_error(error, "failed read of 0x%x: ", (guint)length);
+		fu_chunk_array_pool_release(pool, buf);
+		return NULL;
+	}
+	if (bytes_read != length) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "requested 0x%x and got 0x%x",
+			    (guint)length,
+			    (guint)bytes_read);
+		fu_chunk_array_pool_release(pool, buf);
+		return NULL;
+	}
+	pbuf = g_new0(FuChunkArrayPoolBuf, 1);
+	pbuf->pool = fu_chunk_array_pool_ref(pool);
+	pbuf->buf = buf;
+	return g_bytes_new_with_free_func(buf, length, fu_chunk_array_pool_buf_free, pbuf);
+}
+
+static gpointer
+fu_chunk_array_prefetch_thread_cb(gpointer user_data)
+{
+	FuChunkArrayPrefetch *prefetch = (FuChunkArrayPrefetch *)user_data;
+	prefetch->blob = fu_chunk_array_read_window(prefetch->stream,
+						    prefetch->pool,
+						    prefetch->offset,
+						    prefetch->length,
+						    &prefetch->error);
+	return NULL;
+}
+
+static void
+fu_chunk_array_prefetch_free(FuChunkArrayPrefetch *prefetch)
+{
+	if (prefetch->thread != NULL)
+		g_thread_join(prefetch->thread);
+	if (prefetch->blob != NULL)
+		g_bytes_unref(prefetch->blob);
+	if (prefetch->error != NULL)
+		g_error_free(prefetch->error);
+	fu_chunk_array_pool_unref(prefetch->pool);
+	g_object_unref(prefetch->stream);
+	g_free(prefetch);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuChunkArrayPrefetch, fu_chunk_array_prefetch_free)
+
+static void
+fu_chunk_array_prefetch_start(FuChunkArray *self, gsize offset)
+{
+	FuChunkArrayPrefetch *prefetch = g_new0(FuChunkArrayPrefetch, 1);
+	prefetch->stream = g_object_ref(self->stream);
+	prefetch->pool = fu_chunk_array_pool_ref(self->pool);
+	prefetch->offset = offset;
+	prefetch->length = MIN(self->window_sz, self->total_size - offset);
+	prefetch->thread =
+	    g_thread_new("fu-chunk-array-prefetch", fu_chunk_array_prefetch_thread_cb, prefetch);
+	self->prefetch = prefetch;
+}
+
+/* makes sure the window containing @offset is loaded */
+static gboolean
+fu_chunk_array_ensure_window(FuChunkArray *self, gsize offset, GError **error)
+{
+	gsize window_offset = offset - (offset % self->window_sz);
+	gsize window_length = MIN(self->window_sz, self->total_size - window_offset);
+	g_autoptr(GBytes) blob = NULL;
+
+	/* already loaded */
+	if (self->window != NULL && self->window_offset == window_offset)
+		return TRUE;
+
+	/* use the prefetched window if it is the one we need, and in all cases wait for the thread
+	 * to finish as the stream cannot be shared */
+	if (self->prefetch != NULL) {
+		g_autoptr(FuChunkArrayPrefetch) prefetch = g_steal_pointer(&self->prefetch);
+		g_thread_join(prefetch->thread);
+		prefetch->thread = NULL;
+		if (prefetch->offset == window_offset) {
+			if (prefetch->blob != NULL)
+				blob = g_steal_pointer(&prefetch->blob);
+			else
+				g_debug("prefetch failed, retrying: %s", prefetch->error->message);
+		}
+	}
+	if (blob == NULL) {
+		blob = fu_chunk_array_read_window(self->stream,
+						  self->pool,
+						  window_offset,
+						  window_length,
+						  error);
+		if (blob == NULL)
+			return FALSE;
+	}
+
+	/* drop the old window first so the buffer can be reused for the next prefetch */
+	if (self->window != NULL)
+		g_bytes_unref(self->window);
+	self->window = g_steal_pointer(&blob);
+	self->window_offset = window_offset;
+
+	/* read the next window while the caller is busy with the device */
+	if (self->prefetch_enabled && window_offset + self->window_sz < self->total_size)
+		fu_chunk_array_prefetch_start(self, window_offset + self->window_sz);
+	return TRUE;
+}
+
+/**
+ * fu_chunk_array_set_prefetch:
+ * @self: a #FuChunkArray
+ * @prefetch: boolean
+ *
+ * Reads the next window of a stream-backed array on a worker thread while the chunks of the
+ * current window are being written to the device. This is only useful when iterating through
+ * the chunks in order.
+ *
+ * NOTE: The stream must not be used by anything else until the array has been destroyed.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_chunk_array_set_prefetch(FuChunkArray *self, gboolean prefetch)
+{
+	g_return_if_fail(FU_IS_CHUNK_ARRAY(self));
+	self->prefetch_enabled = prefetch;
+	if (!prefetch)
+		g_clear_pointer(&self->prefetch, fu_chunk_array_prefetch_free);
+}
+
 /**
  * fu_chunk_array_length:
  * @self: a #FuChunkArray
@@ -87,14 +336,15 @@ fu_chunk_array_index(FuChunkArray *self, guint idx, GError **error)
 	if (self->blob != NULL) {
 		blob_chk = g_bytes_new_from_bytes(self->blob, offset, length);
 	} else if (self->stream != NULL) {
-		blob_chk = fu_input_stream_read_bytes(self->stream, offset, length, error);
-		if (blob_chk == NULL) {
+		if (!fu_chunk_array_ensure_window(self, offset, error)) {
 			g_prefix_error(error,
 				       "failed to get stream at 0x%x for 0x%x: ",
 				       (guint)offset,
 				       (guint)length);
 			return NULL;
 		}
+		blob_chk =
+		    g_bytes_new_from_bytes(self->window, offset - self->window_offset, length);
 	} else {
 		blob_chk = g_bytes_new(NULL, 0);
 	}
@@ -104,6 +354,45 @@ fu_chunk_array_index(FuChunkArray *self, guint idx, GError **error)
 	return g_steal_pointer(&chk);
 }
 
+/**
+ * fu_chunk_array_compute_crc32:
+ * @self: a #FuChunkArray
+ * @crc: (out): initial and final CRC value, typically 0x0
+ * @polynomial: CRC polynomial, typically 0xEDB88320
+ * @error: (nullable): optional return location for an error
+ *
+ * Returns the cyclic redundancy check value for all the chunks, without allocating each #FuChunk.
+ *
+ * NOTE: As with fu_input_stream_compute_crc32(), the initial @crc is inverted, so for most uses
+ * you want to use the value of 0x0, not 0xFFFFFFFF.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_chunk_array_compute_crc32(FuChunkArray *self,
+			     guint32 *crc,
+			     guint32 polynomial,
+			     GError **error)
+{
+	g_return_val_if_fail(FU_IS_CHUNK_ARRAY(self), FALSE);
+	g_return_val_if_fail(crc != NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	if (self->stream != NULL) {
+		g_clear_pointer(&self->prefetch, fu_chunk_array_prefetch_free);
+		return fu_input_stream_compute_crc32(self->stream, crc, polynomial, error);
+	}
+	if (self->blob != NULL) {
+		*crc = fu_crc32_full(g_bytes_get_data(self->blob, NULL),
+				     g_bytes_get_size(self->blob),
+				     ~*crc,
+				     polynomial);
+	}
+	return TRUE;
+}
+
 /**
  * fu_chunk_array_new_from_bytes:
  * @blob: data
@@ -144,6 +433,9 @@ fu_chunk_array_new_from_bytes(GBytes *blob, guint32 addr_start, guint32 packet_s
  * Chunks a linear stream into packets, ensuring each packet is less that a specific
  * transfer size.
  *
+ * The stream is read in large aligned windows and each #FuChunk is a slice of the window, so
+ * iterating through the chunks does not need a seek, read and allocation for each packet.
+ *
  * Returns: (transfer full): a #FuChunkArray, or #NULL on error
  *
  * Since: 2.0.0
@@ -169,6 +461,9 @@ fu_chunk_array_new_from_stream(GInputStream *stream,
 	self->total_chunks = self->total_size / self->packet_sz;
 	if (self->total_size % self->packet_sz != 0)
 		self->total_chunks++;
+	self->window_sz = MAX(FU_CHUNK_ARRAY_WINDOW_SIZE - (FU_CHUNK_ARRAY_WINDOW_SIZE % packet_sz),
+			      packet_sz);
+	self->pool = fu_chunk_array_pool_new(MAX(MIN(self->window_sz, self->total_size), 1));
 	return g_steal_pointer(&self);
 }
 
@@ -176,6 +471,12 @@ static void
 fu_chunk_array_finalize(GObject *object)
 {
 	FuChunkArray *self = FU_CHUNK_ARRAY(object);
+	if (self->prefetch != NULL)
+		fu_chunk_array_prefetch_free(self->prefetch);
+	if (self->window != NULL)
+		g_bytes_unref(self->window);
+	if (self->pool != NULL)
+		fu_chunk_array_pool_unref(self->pool);
 	if (self->blob != NULL)
 		g_bytes_unref(self->blob);
 	if (self->stream != NULL)
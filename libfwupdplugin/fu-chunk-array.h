@@ -22,7 +22,14 @@ fu_chunk_array_new_from_stream(GInputStream *stream,
 			       guint32 addr_start,
 			       guint32 packet_sz,
 			       GError **error) G_GNUC_NON_NULL(1);
+void
+fu_chunk_array_set_prefetch(FuChunkArray *self, gboolean prefetch) G_GNUC_NON_NULL(1);
 guint
 fu_chunk_array_length(FuChunkArray *self) G_GNUC_NON_NULL(1);
 FuChunk *
 fu_chunk_array_index(FuChunkArray *self, guint idx, GError **error) G_GNUC_NON_NULL(1);
+gboolean
+fu_chunk_array_compute_crc32(FuChunkArray *self,
+			     guint32 *crc,
+			     guint32 polynomial,
+			     GError **error) G_GNUC_NON_NULL(1, 2);
@@ -1,6 +1,7 @@
 // Copyright 2024 Richard Hughes <richard@hughsie.com>
 // SPDX-License-Identifier: LGPL-2.1-or-later
 
+#[derive(ToString)]
 enum FuCpuVendor {
     Unknown,
     Intel,
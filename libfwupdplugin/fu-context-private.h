@@ -64,5 +64,7 @@ FuHwids *
 fu_context_get_hwids(FuContext *self) G_GNUC_NON_NULL(1);
 FuConfig *
 fu_context_get_config(FuContext *self) G_GNUC_NON_NULL(1);
+FuQuirks *
+fu_context_get_quirks(FuContext *self) G_GNUC_NON_NULL(1);
 void
 fu_context_set_chassis_kind(FuContext *self, FuSmbiosChassisKind chassis_kind) G_GNUC_NON_NULL(1);
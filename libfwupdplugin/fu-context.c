@@ -171,6 +171,24 @@ fu_context_get_hwids(FuContext *self)
 	return priv->hwids;
 }
 
+/**
+ * fu_context_get_quirks:
+ * @self: a #FuContext
+ *
+ * Gets the quirks store.
+ *
+ * Returns: (transfer none): a #FuQuirks
+ *
+ * Since: 2.0.0
+ **/
+FuQuirks *
+fu_context_get_quirks(FuContext *self)
+{
+	FuContextPrivate *priv = GET_PRIVATE(self);
+	g_return_val_if_fail(FU_IS_CONTEXT(self), NULL);
+	return priv->quirks;
+}
+
 /**
  * fu_context_get_config:
  * @self: a #FuContext
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2017 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include "fu-crc.h"
+
+guint8
+fu_crc8_full_bitwise(const guint8 *buf, gsize bufsz, guint8 crc_init, guint8 polynomial);
+guint16
+fu_crc16_full_bitwise(const guint8 *buf, gsize bufsz, guint16 crc, guint16 polynomial);
+guint32
+fu_crc32_full_bitwise(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial);
@@ -8,9 +8,329 @@
 
 #include "config.h"
 
-#include "fu-crc.h"
+#ifdef HAVE_WMMINTRIN_H
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#endif
+#ifdef HAVE_ARM_ACLE_H
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#endif
+
+#include "fu-crc-private.h"
 #include "fu-mem.h"
 
+/* the polynomial the PCLMULQDQ and ARMv8 CRC32 code paths are hardcoded for */
+#define FU_CRC32_POLYNOMIAL_IEEE 0xEDB88320
+
+/* slicing-by-8 tables, the first table is the classic byte-at-a-time lookup table */
+typedef struct {
+	guint8 table[8][256];
+} FuCrc8Tables;
+
+typedef struct {
+	guint16 table[8][256];
+} FuCrc16Tables;
+
+typedef struct {
+	guint32 table[8][256];
+} FuCrc32Tables;
+
+G_LOCK_DEFINE_STATIC(fu_crc_tables);
+static GHashTable *fu_crc8_tables = NULL;  /* (element-type guint FuCrc8Tables) */
+static GHashTable *fu_crc16_tables = NULL; /* (element-type guint FuCrc16Tables) */
+static GHashTable *fu_crc32_tables = NULL; /* (element-type guint FuCrc32Tables) */
+
+typedef enum {
+	FU_CRC_ACCEL_UNKNOWN,
+	FU_CRC_ACCEL_NONE,
+	FU_CRC_ACCEL_PCLMUL,
+	FU_CRC_ACCEL_ARMV8,
+} FuCrcAccel;
+
+/* the tables are never freed as there is only a handful of polynomials in use */
+static GHashTable *
+fu_crc_tables_ensure(GHashTable **tables)
+{
+	if (*tables == NULL)
+		*tables = g_hash_table_new(g_direct_hash, g_direct_equal);
+	return *tables;
+}
+
+static const FuCrc8Tables *
+fu_crc8_tables_get(guint8 polynomial)
+{
+	FuCrc8Tables *tables;
+	GHashTable *hash;
+
+	G_LOCK(fu_crc_tables);
+	hash = fu_crc_tables_ensure(&fu_crc8_tables);
+	tables = g_hash_table_lookup(hash, GUINT_TO_POINTER(polynomial));
+	if (tables == NULL) {
+		tables = g_new0(FuCrc8Tables, 1);
+		for (guint i = 0; i < 256; i++) {
+			guint8 crc = i;
+			for (guint j = 0; j < 8; j++)
+				crc = (crc & 0x80) ? (crc << 1) ^ polynomial : crc << 1;
+			tables->table[0][i] = crc;
+		}
+		for (guint k = 1; k < 8; k++) {
+			for (guint i = 0; i < 256; i++)
+				tables->table[k][i] = tables->table[0][tables->table[k - 1][i]];
+		}
+		g_hash_table_insert(hash, GUINT_TO_POINTER(polynomial), tables);
+	}
+	G_UNLOCK(fu_crc_tables);
+	return tables;
+}
+
+static const FuCrc16Tables *
+fu_crc16_tables_get(guint16 polynomial)
+{
+	FuCrc16Tables *tables;
+	GHashTable *hash;
+
+	G_LOCK(fu_crc_tables);
+	hash = fu_crc_tables_ensure(&fu_crc16_tables);
+	tables = g_hash_table_lookup(hash, GUINT_TO_POINTER(polynomial));
+	if (tables == NULL) {
+		tables = g_new0(FuCrc16Tables, 1);
+		for (guint i = 0; i < 256; i++) {
+			guint16 crc = i;
+			for (guint j = 0; j < 8; j++)
+				crc = (crc & 0x1) ? (crc >> 1) ^ polynomial : crc >> 1;
+			tables->table[0][i] = crc;
+		}
+		for (guint k = 1; k < 8; k++) {
+			for (guint i = 0; i < 256; i++) {
+				guint16 tmp = tables->table[k - 1][i];
+				tables->table[k][i] = (tmp >> 8) ^ tables->table[0][tmp & 0xFF];
+			}
+		}
+		g_hash_table_insert(hash, GUINT_TO_POINTER(polynomial), tables);
+	}
+	G_UNLOCK(fu_crc_tables);
+	return tables;
+}
+
+static const FuCrc32Tables *
+fu_crc32_tables_get(guint32 polynomial)
+{
+	FuCrc32Tables *tables;
+	GHashTable *hash;
+
+	G_LOCK(fu_crc_tables);
+	hash = fu_crc_tables_ensure(&fu_crc32_tables);
+	tables = g_hash_table_lookup(hash, GUINT_TO_POINTER(polynomial));
+	if (tables == NULL) {
+		tables = g_new0(FuCrc32Tables, 1);
+		for (guint i = 0; i < 256; i++) {
+			guint32 crc = i;
+			for (guint j = 0; j < 8; j++)
+				crc = (crc & 0x1) ? (crc >> 1) ^ polynomial : crc >> 1;
+			tables->table[0][i] = crc;
+		}
+		for (guint k = 1; k < 8; k++) {
+			for (guint i = 0; i < 256; i++) {
+				guint32 tmp = tables->table[k - 1][i];
+				tables->table[k][i] = (tmp >> 8) ^ tables->table[0][tmp & 0xFF];
+			}
+		}
+		g_hash_table_insert(hash, GUINT_TO_POINTER(polynomial), tables);
+	}
+	G_UNLOCK(fu_crc_tables);
+	return tables;
+}
+
+#ifdef HAVE_WMMINTRIN_H
+/*
+ * Folds 64 bytes at a time using carry-less multiplication, as described in the Intel whitepaper
+ * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+ * The constants are only valid for the bit-reflected 0xEDB88320 polynomial, and @bufsz has to be
+ * at least 64 bytes and a multiple of 16.
+ */
+__attribute__((target("pclmul,sse4.1"))) static guint32
+fu_crc32_pclmul(const guint8 *buf, gsize bufsz, guint32 crc)
+{
+	static const guint64 __attribute__((aligned(16))) k1k2[] = {0x0154442bd4, 0x01c6e41596};
+	static const guint64 __attribute__((aligned(16))) k3k4[] = {0x01751997d0, 0x00ccaa009e};
+	static const guint64 __attribute__((aligned(16))) k5k0[] = {0x0163cd6124, 0x0000000000};
+	static const guint64 __attribute__((aligned(16))) poly[] = {0x01db710641, 0x01f7011641};
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+	x1 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((gint32)crc));
+	x0 = _mm_load_si128((const __m128i *)k1k2);
+	buf += 64;
+	bufsz -= 64;
+
+	/* fold 64 bytes at a time */
+	while (bufsz >= 64) {
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		y5 = _mm_loadu_si128((const __m128i *)(buf + 0x00));
+		y6 = _mm_loadu_si128((const __m128i *)(buf + 0x10));
+		y7 = _mm_loadu_si128((const __m128i *)(buf + 0x20));
+		y8 = _mm_loadu_si128((const __m128i *)(buf + 0x30));
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+		buf += 64;
+		bufsz -= 64;
+	}
+
+	/* fold into 128 bits */
+	x0 = _mm_load_si128((const __m128i *)k3k4);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	/* fold 16 bytes at a time */
+	while (bufsz >= 16) {
+		x2 = _mm_loadu_si128((const __m128i *)buf);
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+		buf += 16;
+		bufsz -= 16;
+	}
+
+	/* fold 128 bits to 64 bits */
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+	x0 = _mm_loadl_epi64((const __m128i *)k5k0);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction to 32 bits */
+	x0 = _mm_load_si128((const __m128i *)poly);
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	return (guint32)_mm_extract_epi32(x1, 1);
+}
+#endif
+
+#ifdef HAVE_ARM_ACLE_H
+/* the CRC32 instructions are hardcoded to the bit-reflected 0xEDB88320 polynomial */
+__attribute__((target("+crc"))) static guint32
+fu_crc32_armv8(const guint8 *buf, gsize bufsz, guint32 crc)
+{
+	for (; bufsz >= 8; bufsz -= 8, buf += 8)
+		crc = __crc32d(crc, fu_memread_uint64(buf, G_LITTLE_ENDIAN));
+	for (; bufsz > 0; bufsz--)
+		crc = __crc32b(crc, *buf++);
+	return crc;
+}
+#endif
+
+#if defined(HAVE_WMMINTRIN_H) || defined(HAVE_ARM_ACLE_H)
+static FuCrcAccel
+fu_crc32_get_accel(void)
+{
+	static gsize accel = FU_CRC_ACCEL_UNKNOWN;
+	if (g_once_init_enter(&accel)) {
+		FuCrcAccel tmp = FU_CRC_ACCEL_NONE;
+#ifdef HAVE_WMMINTRIN_H
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+			tmp = FU_CRC_ACCEL_PCLMUL;
+#endif
+#ifdef HAVE_ARM_ACLE_H
+		if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+			tmp = FU_CRC_ACCEL_ARMV8;
+#endif
+		g_once_init_leave(&accel, tmp);
+	}
+	return accel;
+}
+#endif
+
+/* buffers smaller than this are not worth the table lookup and locking */
+#define FU_CRC_TABLE_THRESHOLD 16
+
+/**
+ * fu_crc8_full_bitwise: (skip):
+ *
+ * The reference implementation of fu_crc8_full(), processing one bit at a time.
+ **/
+guint8
+fu_crc8_full_bitwise(const guint8 *buf, gsize bufsz, guint8 crc_init, guint8 polynomial)
+{
+	guint32 crc = crc_init;
+	for (gsize j = bufsz; j > 0; j--) {
+		crc ^= (*(buf++) << 8);
+		for (guint32 i = 8; i; i--) {
+			if (crc & 0x8000)
+				crc ^= ((polynomial | 0x100) << 7);
+			crc <<= 1;
+		}
+	}
+	return ~((guint8)(crc >> 8));
+}
+
+/**
+ * fu_crc16_full_bitwise: (skip):
+ *
+ * The reference implementation of fu_crc16_full(), processing one bit at a time.
+ **/
+guint16
+fu_crc16_full_bitwise(const guint8 *buf, gsize bufsz, guint16 crc, guint16 polynomial)
+{
+	for (gsize len = bufsz; len > 0; len--) {
+		crc = (guint16)(crc ^ (*buf++));
+		for (guint8 i = 0; i < 8; i++) {
+			if (crc & 0x1) {
+				crc = (crc >> 1) ^ polynomial;
+			} else {
+				crc >>= 1;
+			}
+		}
+	}
+	return ~crc;
+}
+
+/**
+ * fu_crc32_full_bitwise: (skip):
+ *
+ * The reference implementation of fu_crc32_full(), processing one bit at a time.
+ **/
+guint32
+fu_crc32_full_bitwise(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial)
+{
+	for (guint32 idx = 0; idx < bufsz; idx++) {
+		guint8 data = *buf++;
+		crc = crc ^ data;
+		for (guint32 bit = 0; bit < 8; bit++) {
+			guint32 mask = -(crc & 1);
+			crc = (crc >> 1) ^ (polynomial & mask);
+		}
+	}
+	return ~crc;
+}
+
 /**
  * fu_crc8_full:
  * @buf: memory buffer
@@ -27,16 +347,25 @@
 guint8
 fu_crc8_full(const guint8 *buf, gsize bufsz, guint8 crc_init, guint8 polynomial)
 {
-	guint32 crc = crc_init;
-	for (gsize j = bufsz; j > 0; j--) {
-		crc ^= (*(buf++) << 8);
-		for (guint32 i = 8; i; i--) {
-			if (crc & 0x8000)
-				crc ^= ((polynomial | 0x100) << 7);
-			crc <<= 1;
-		}
+	const FuCrc8Tables *tables;
+	guint8 crc;
+
+	if (bufsz < FU_CRC_TABLE_THRESHOLD)
+		return fu_crc8_full_bitwise(buf, bufsz, crc_init, polynomial);
+
+	/* @crc_init is mixed in *after* the first byte, see fu_crc8_full_bitwise() */
+	tables = fu_crc8_tables_get(polynomial);
+	crc = tables->table[0][*buf++] ^ crc_init;
+	bufsz--;
+	for (; bufsz >= 8; bufsz -= 8, buf += 8) {
+		crc = tables->table[7][crc ^ buf[0]] ^ tables->table[6][buf[1]] ^
+		      tables->table[5][buf[2]] ^ tables->table[4][buf[3]] ^
+		      tables->table[3][buf[4]] ^ tables->table[2][buf[5]] ^
+		      tables->table[1][buf[6]] ^ tables->table[0][buf[7]];
 	}
-	return ~((guint8)(crc >> 8));
+	for (; bufsz > 0; bufsz--)
+		crc = tables->table[0][crc ^ *buf++];
+	return ~crc;
 }
 
 /**
@@ -72,16 +401,21 @@ fu_crc8(const guint8 *buf, gsize bufsz)
 guint16
 fu_crc16_full(const guint8 *buf, gsize bufsz, guint16 crc, guint16 polynomial)
 {
-	for (gsize len = bufsz; len > 0; len--) {
-		crc = (guint16)(crc ^ (*buf++));
-		for (guint8 i = 0; i < 8; i++) {
-			if (crc & 0x1) {
-				crc = (crc >> 1) ^ polynomial;
-			} else {
-				crc >>= 1;
-			}
-		}
+	const FuCrc16Tables *tables;
+
+	if (bufsz < FU_CRC_TABLE_THRESHOLD)
+		return fu_crc16_full_bitwise(buf, bufsz, crc, polynomial);
+
+	tables = fu_crc16_tables_get(polynomial);
+	for (; bufsz >= 8; bufsz -= 8, buf += 8) {
+		crc ^= fu_memread_uint16(buf, G_LITTLE_ENDIAN);
+		crc = tables->table[7][crc & 0xFF] ^ tables->table[6][crc >> 8] ^
+		      tables->table[5][buf[2]] ^ tables->table[4][buf[3]] ^
+		      tables->table[3][buf[4]] ^ tables->table[2][buf[5]] ^
+		      tables->table[1][buf[6]] ^ tables->table[0][buf[7]];
 	}
+	for (; bufsz > 0; bufsz--)
+		crc = (crc >> 8) ^ tables->table[0][(crc ^ *buf++) & 0xFF];
 	return ~crc;
 }
 
@@ -111,6 +445,9 @@ fu_crc16(const guint8 *buf, gsize bufsz)
  *
  * Returns the cyclic redundancy check value for the given memory buffer.
  *
+ * If the CPU supports it, the common 0xEDB88320 polynomial is computed using PCLMULQDQ folding
+ * or the ARMv8 CRC32 instructions.
+ *
  * Returns: CRC value
  *
  * Since: 1.8.2
@@ -118,14 +455,40 @@ fu_crc16(const guint8 *buf, gsize bufsz)
 guint32
 fu_crc32_full(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial)
 {
-	for (guint32 idx = 0; idx < bufsz; idx++) {
-		guint8 data = *buf++;
-		crc = crc ^ data;
-		for (guint32 bit = 0; bit < 8; bit++) {
-			guint32 mask = -(crc & 1);
-			crc = (crc >> 1) ^ (polynomial & mask);
+	const FuCrc32Tables *tables;
+
+	if (bufsz < FU_CRC_TABLE_THRESHOLD)
+		return fu_crc32_full_bitwise(buf, bufsz, crc, polynomial);
+
+#if defined(HAVE_WMMINTRIN_H) || defined(HAVE_ARM_ACLE_H)
+	/* hardware acceleration */
+	if (polynomial == FU_CRC32_POLYNOMIAL_IEEE) {
+		FuCrcAccel accel = fu_crc32_get_accel();
+#ifdef HAVE_WMMINTRIN_H
+		if (accel == FU_CRC_ACCEL_PCLMUL && bufsz >= 64) {
+			gsize bufsz_fold = bufsz & ~((gsize)0xF);
+			crc = fu_crc32_pclmul(buf, bufsz_fold, crc);
+			buf += bufsz_fold;
+			bufsz -= bufsz_fold;
 		}
+#endif
+#ifdef HAVE_ARM_ACLE_H
+		if (accel == FU_CRC_ACCEL_ARMV8)
+			return ~fu_crc32_armv8(buf, bufsz, crc);
+#endif
+	}
+#endif
+
+	tables = fu_crc32_tables_get(polynomial);
+	for (; bufsz >= 8; bufsz -= 8, buf += 8) {
+		guint32 one = crc ^ fu_memread_uint32(buf, G_LITTLE_ENDIAN);
+		crc = tables->table[7][one & 0xFF] ^ tables->table[6][(one >> 8) & 0xFF] ^
+		      tables->table[5][(one >> 16) & 0xFF] ^ tables->table[4][one >> 24] ^
+		      tables->table[3][buf[4]] ^ tables->table[2][buf[5]] ^
+		      tables->table[1][buf[6]] ^ tables->table[0][buf[7]];
 	}
+	for (; bufsz > 0; bufsz--)
+		crc = (crc >> 8) ^ tables->table[0][(crc ^ *buf++) & 0xFF];
 	return ~crc;
 }
 
@@ -143,7 +506,7 @@ fu_crc32_full(const guint8 *buf, gsize bufsz, guint32 crc, guint32 polynomial)
 guint32
 fu_crc32(const guint8 *buf, gsize bufsz)
 {
-	return fu_crc32_full(buf, bufsz, 0xFFFFFFFF, 0xEDB88320);
+	return fu_crc32_full(buf, bufsz, 0xFFFFFFFF, FU_CRC32_POLYNOMIAL_IEEE);
 }
 
 static guint16
@@ -115,7 +115,7 @@ enum {
 	PROP_LAST
 };
 
-enum { SIGNAL_CHILD_ADDED, SIGNAL_CHILD_REMOVED, SIGNAL_REQUEST, SIGNAL_LAST };
+enum { SIGNAL_CHILD_ADDED, SIGNAL_CHILD_REMOVED, SIGNAL_REQUEST, SIGNAL_GUID_ADDED, SIGNAL_LAST };
 
 static guint signals[SIGNAL_LAST] = {0};
 
@@ -2315,13 +2315,23 @@ fu_device_get_firmware_size_max(FuDevice *self)
 	return priv->size_max;
 }
 
+/* emits ::guid-added if the GUID was not already set */
+static void
+fu_device_add_guid_internal(FuDevice *self, const gchar *guid)
+{
+	if (fwupd_device_has_guid(FWUPD_DEVICE(self), guid))
+		return;
+	fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+	g_signal_emit(self, signals[SIGNAL_GUID_ADDED], 0, guid);
+}
+
 static void
 fu_device_add_guid_safe(FuDevice *self, const gchar *guid, FuDeviceInstanceFlags flags)
 {
 	/* add the device GUID before adding additional GUIDs from quirks
 	 * to ensure the bootloader GUID is listed after the runtime GUID */
 	if (flags & FU_DEVICE_INSTANCE_FLAG_VISIBLE)
-		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		fu_device_add_guid_internal(self, guid);
 	if (flags & FU_DEVICE_INSTANCE_FLAG_QUIRKS)
 		fu_device_add_guid_quirks(self, guid);
 }
@@ -2425,7 +2435,7 @@ fu_device_add_instance_id_full(FuDevice *self,
 
 	/* already done by ->setup(), so this must be ->registered() */
 	if (priv->done_setup)
-		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		fu_device_add_guid_internal(self, guid);
 }
 
 /**
@@ -2519,12 +2529,12 @@ fu_device_add_counterpart_guid(FuDevice *self, const gchar *guid)
 	/* make valid */
 	if (!fwupd_guid_is_valid(guid)) {
 		g_autofree gchar *tmp = fwupd_guid_hash_string(guid);
-		fwupd_device_add_guid(FWUPD_DEVICE(self), tmp);
+		fu_device_add_guid_internal(self, tmp);
 		return;
 	}
 
 	/* already valid */
-	fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+	fu_device_add_guid_internal(self, guid);
 }
 
 /**
@@ -5159,7 +5169,7 @@ fu_device_convert_instance_ids(FuDevice *self)
 	for (guint i = 0; i < instance_ids->len; i++) {
 		const gchar *instance_id = g_ptr_array_index(instance_ids, i);
 		g_autofree gchar *guid = fwupd_guid_hash_string(instance_id);
-		fwupd_device_add_guid(FWUPD_DEVICE(self), guid);
+		fu_device_add_guid_internal(self, guid);
 	}
 }
 
@@ -5518,6 +5528,7 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 	GPtrArray *parent_physical_ids = fu_device_get_parent_physical_ids(donor);
 	GPtrArray *parent_backend_ids = fu_device_get_parent_backend_ids(donor);
 	GHashTableIter iter;
+	guint guids_len;
 	gpointer key, value;
 
 	g_return_if_fail(FU_IS_DEVICE(self));
@@ -5583,7 +5594,12 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 	}
 
 	/* now the base class, where all the interesting bits are */
+	guids_len = fu_device_get_guids(self)->len;
 	fwupd_device_incorporate(FWUPD_DEVICE(self), FWUPD_DEVICE(donor));
+	for (guint i = guids_len; i < fu_device_get_guids(self)->len; i++) {
+		const gchar *guid = g_ptr_array_index(fu_device_get_guids(self), i);
+		g_signal_emit(self, signals[SIGNAL_GUID_ADDED], 0, guid);
+	}
 
 	/* remove the baseclass-added serial number if set */
 	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_NO_SERIAL_NUMBER))
@@ -5591,7 +5607,7 @@ fu_device_incorporate(FuDevice *self, FuDevice *donor)
 
 	/* remove the baseclass-added GUIDs */
 	if (fu_device_has_internal_flag(self, FU_DEVICE_INTERNAL_FLAG_NO_GENERIC_GUIDS))
-		g_ptr_array_set_size(fwupd_device_get_instance_ids(FWUPD_DEVICE(self)), 0);
+		fwupd_device_clear_instance_ids(FWUPD_DEVICE(self));
 
 	/* set by the superclass */
 	if (fu_device_get_id(self) != NULL)
@@ -6479,6 +6495,25 @@ fu_device_class_init(FuDeviceClass *klass)
 					       G_TYPE_NONE,
 					       1,
 					       FWUPD_TYPE_REQUEST);
+	/**
+	 * FuDevice::guid-added:
+	 * @self: the #FuDevice instance that emitted the signal
+	 * @guid: the GUID
+	 *
+	 * The ::guid-added signal is emitted when a GUID has been added to the device.
+	 *
+	 * Since: 2.0.0
+	 **/
+	signals[SIGNAL_GUID_ADDED] = g_signal_new("guid-added",
+						  G_TYPE_FROM_CLASS(object_class),
+						  G_SIGNAL_RUN_LAST,
+						  0,
+						  NULL,
+						  NULL,
+						  g_cclosure_marshal_VOID__STRING,
+						  G_TYPE_NONE,
+						  1,
+						  G_TYPE_STRING);
 
 	/**
 	 * FuDevice:physical-id:
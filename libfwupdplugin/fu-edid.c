@@ -424,6 +424,8 @@ fu_edid_class_init(FuEdidClass *klass)
 static void
 fu_edid_init(FuEdid *self)
 {
+	const guint8 magic[] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+	fu_firmware_add_magic(FU_FIRMWARE(self), magic, sizeof(magic), 0x0);
 }
 
 /**
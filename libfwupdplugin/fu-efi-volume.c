@@ -312,6 +312,7 @@ fu_efi_volume_init(FuEfiVolume *self)
 	FuEfiVolumePrivate *priv = GET_PRIVATE(self);
 	priv->attrs = 0xfeff;
 	g_type_ensure(FU_TYPE_EFI_FILESYSTEM);
+	fu_firmware_add_magic(FU_FIRMWARE(self), (const guint8 *)"_FVH", 4, 0x28);
 }
 
 static void
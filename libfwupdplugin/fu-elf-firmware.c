@@ -135,7 +135,9 @@ fu_elf_firmware_parse(FuFirmware *firmware,
 static void
 fu_elf_firmware_init(FuElfFirmware *self)
 {
+	const guint8 magic[] = {0x7F, 'E', 'L', 'F'};
 	fu_firmware_set_images_max(FU_FIRMWARE(self), 1024);
+	fu_firmware_add_magic(FU_FIRMWARE(self), magic, sizeof(magic), 0x0);
 }
 
 static void
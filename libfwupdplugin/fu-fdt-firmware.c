@@ -235,9 +235,9 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GByteArray *str
 		if (token == FDT_PROP) {
 			guint32 prop_len;
 			guint32 prop_nameoff;
+			FuStructFdtPropView st_prp = {0};
 			g_autoptr(GBytes) blob = NULL;
 			g_autoptr(GString) str = NULL;
-			g_autoptr(GByteArray) st_prp = NULL;
 
 			/* sanity check */
 			if (firmware_current == FU_FIRMWARE(self)) {
@@ -249,12 +249,11 @@ fu_fdt_firmware_parse_dt_struct(FuFdtFirmware *self, GBytes *fw, GByteArray *str
 			}
 
 			/* parse */
-			st_prp = fu_struct_fdt_prop_parse(buf, bufsz, offset, error);
-			if (st_prp == NULL)
+			if (!fu_struct_fdt_prop_view_init(&st_prp, buf, bufsz, offset, error))
 				return FALSE;
-			prop_len = fu_struct_fdt_prop_get_len(st_prp);
-			prop_nameoff = fu_struct_fdt_prop_get_nameoff(st_prp);
-			offset += st_prp->len;
+			prop_len = fu_struct_fdt_prop_view_get_len(&st_prp);
+			prop_nameoff = fu_struct_fdt_prop_view_get_nameoff(&st_prp);
+			offset += FU_STRUCT_FDT_PROP_SIZE;
 
 			/* add property */
 			str = fu_string_new_safe(strtab->data, strtab->len, prop_nameoff, error);
@@ -584,8 +583,10 @@ fu_fdt_firmware_build(FuFirmware *firmware, XbNode *n, GError **error)
 static void
 fu_fdt_firmware_init(FuFdtFirmware *self)
 {
+	const guint8 magic[] = {0xD0, 0x0D, 0xFE, 0xED};
 	g_type_ensure(FU_TYPE_FDT_IMAGE);
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_VID_PID);
+	fu_firmware_add_magic(FU_FIRMWARE(self), magic, sizeof(magic), 0x0);
 }
 
 static void
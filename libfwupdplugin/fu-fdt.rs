@@ -21,7 +21,7 @@ struct FuStructFdtReserveEntry {
     size: u64be,
 }
 
-#[derive(New, Parse)]
+#[derive(New, View)]
 struct FuStructFdtProp {
     len: u32be,
     nameoff: u32be,
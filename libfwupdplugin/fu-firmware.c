@@ -14,6 +14,7 @@
 #include "fu-common.h"
 #include "fu-firmware.h"
 #include "fu-input-stream.h"
+#include "fu-mapped-input-stream.h"
 #include "fu-mem.h"
 #include "fu-partial-input-stream.h"
 #include "fu-string.h"
@@ -47,6 +48,7 @@ typedef struct {
 	guint depth;
 	GPtrArray *chunks;  /* nullable, element-type FuChunk */
 	GPtrArray *patches; /* nullable, element-type FuFirmwarePatch */
+	GPtrArray *magics;  /* nullable, element-type FuFirmwareMagic */
 } FuFirmwarePrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(FuFirmware, fu_firmware, G_TYPE_OBJECT)
@@ -56,6 +58,9 @@ enum { PROP_0, PROP_PARENT, PROP_LAST };
 
 #define FU_FIRMWARE_IMAGE_DEPTH_MAX 50
 
+/* enough for every registered magic, small enough to read for every parse attempt */
+#define FU_FIRMWARE_DETECT_BUFSZ 0x1000
+
 /**
  * fu_firmware_flag_to_string:
  * @flag: a #FuFirmwareFlags, e.g. %FU_FIRMWARE_FLAG_DEDUPE_ID
@@ -134,6 +139,18 @@ fu_firmware_patch_free(FuFirmwarePatch *ptch)
 	g_free(ptch);
 }
 
+typedef struct {
+	gsize offset;
+	GBytes *blob;
+} FuFirmwareMagic;
+
+static void
+fu_firmware_magic_free(FuFirmwareMagic *magic)
+{
+	g_bytes_unref(magic->blob);
+	g_free(magic);
+}
+
 /**
  * fu_firmware_add_flag:
  * @firmware: a #FuFirmware
@@ -705,7 +722,7 @@ fu_firmware_get_stream(FuFirmware *self, GError **error)
 	if (priv->stream != NULL)
 		return g_object_ref(priv->stream);
 	if (priv->bytes != NULL)
-		return g_memory_input_stream_new_from_bytes(priv->bytes);
+		return fu_mapped_input_stream_new_from_bytes(priv->bytes);
 	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "no stream or bytes set");
 	return NULL;
 }
@@ -1118,7 +1135,7 @@ fu_firmware_parse_full(FuFirmware *self,
 	g_return_val_if_fail(fw != NULL, FALSE);
 	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
 
-	stream = g_memory_input_stream_new_from_bytes(fw);
+	stream = fu_mapped_input_stream_new_from_bytes(fw);
 	return fu_firmware_parse_stream(self, stream, offset, flags, error);
 }
 
@@ -1534,6 +1551,45 @@ fu_firmware_add_patch(FuFirmware *self, gsize offset, GBytes *blob)
 	g_ptr_array_add(priv->patches, ptch);
 }
 
+/**
+ * fu_firmware_add_magic:
+ * @self: a #FuFirmware
+ * @buf: (not nullable): constant bytes that must be present in the firmware
+ * @bufsz: size of @buf
+ * @offset: offset of @buf from the start of the firmware
+ *
+ * Registers a signature that is present in every valid firmware of this type, typically set in
+ * the subclass `_init()`. If more than one magic is added then only one has to match.
+ *
+ * This is used by fu_firmware_detect_gtypes() to rule out firmware types before trying to parse
+ * the stream, and so it must not be set for firmware formats where the signature is optional.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_firmware_add_magic(FuFirmware *self, const guint8 *buf, gsize bufsz, gsize offset)
+{
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	FuFirmwareMagic *magic;
+
+	g_return_if_fail(FU_IS_FIRMWARE(self));
+	g_return_if_fail(buf != NULL);
+	g_return_if_fail(bufsz > 0);
+	g_return_if_fail(offset + bufsz <= FU_FIRMWARE_DETECT_BUFSZ);
+
+	/* ensure exists */
+	if (priv->magics == NULL) {
+		priv->magics =
+		    g_ptr_array_new_with_free_func((GDestroyNotify)fu_firmware_magic_free);
+	}
+
+	/* add new */
+	magic = g_new0(FuFirmwareMagic, 1);
+	magic->offset = offset;
+	magic->blob = g_bytes_new(buf, bufsz);
+	g_ptr_array_add(priv->magics, magic);
+}
+
 /**
  * fu_firmware_write_chunk:
  * @self: a #FuFirmware
@@ -2361,6 +2417,8 @@ fu_firmware_finalize(GObject *object)
 		g_ptr_array_unref(priv->chunks);
 	if (priv->patches != NULL)
 		g_ptr_array_unref(priv->patches);
+	if (priv->magics != NULL)
+		g_ptr_array_unref(priv->magics);
 	if (priv->parent != NULL)
 		g_object_remove_weak_pointer(G_OBJECT(priv->parent), (gpointer *)&priv->parent);
 	g_ptr_array_unref(priv->images);
@@ -2426,6 +2484,149 @@ fu_firmware_new_from_bytes(GBytes *fw)
 	return self;
 }
 
+/* returns -1 if @self cannot parse @buf, 0 if unknown, otherwise the length of the matched magic */
+static gint
+fu_firmware_detect_score(FuFirmware *self,
+			 const guint8 *buf,
+			 gsize bufsz,
+			 gsize streamsz,
+			 FwupdInstallFlags flags)
+{
+	FuFirmwareClass *klass = FU_FIRMWARE_GET_CLASS(self);
+	FuFirmwarePrivate *priv = GET_PRIVATE(self);
+	gboolean search = FALSE;
+	gint score = -1;
+
+	/* nothing registered */
+	if (priv->magics == NULL)
+		return 0;
+
+	/* the same rules as fu_firmware_validate_for_offset() */
+	if (klass->validate != NULL && streamsz <= FU_FIRMWARE_SEARCH_MAGIC_BUFSZ_MAX) {
+		search = fu_firmware_has_flag(self, FU_FIRMWARE_FLAG_ALWAYS_SEARCH) ||
+			 (flags & FWUPD_INSTALL_FLAG_NO_SEARCH) == 0;
+	}
+
+	for (guint i = 0; i < priv->magics->len; i++) {
+		FuFirmwareMagic *magic = g_ptr_array_index(priv->magics, i);
+		gsize magicsz = 0;
+		const guint8 *magicbuf = g_bytes_get_data(magic->blob, &magicsz);
+		gboolean found = FALSE;
+
+		for (gsize j = magic->offset; j + magicsz <= bufsz; j++) {
+			if (memcmp(buf + j, magicbuf, magicsz) == 0) {
+				found = TRUE;
+				break;
+			}
+			if (!search)
+				break;
+		}
+		if (found) {
+			score = MAX(score, (gint)magicsz);
+			continue;
+		}
+
+		/* the magic might be in the part of the stream that was not read */
+		if (streamsz > bufsz && (search || magic->offset + magicsz > bufsz))
+			score = MAX(score, 0);
+	}
+	return score;
+}
+
+typedef struct {
+	GType gtype;
+	gint score;
+	guint idx;
+} FuFirmwareDetectItem;
+
+static gint
+fu_firmware_detect_item_sort_cb(gconstpointer a, gconstpointer b)
+{
+	const FuFirmwareDetectItem *item1 = a;
+	const FuFirmwareDetectItem *item2 = b;
+	if (item1->score != item2->score)
+		return item2->score - item1->score;
+	return (gint)item1->idx - (gint)item2->idx;
+}
+
+/**
+ * fu_firmware_detect_gtypes:
+ * @stream: a #GInputStream
+ * @offset: start offset, useful for ignoring a bootloader
+ * @flags: install flags, e.g. %FWUPD_INSTALL_FLAG_NO_SEARCH
+ * @gtypes: (element-type GType): firmware types to consider, in priority order
+ * @error: (nullable): optional return location for an error
+ *
+ * Ranks the firmware types using the magic registered with fu_firmware_add_magic(), reading
+ * only the first few kilobytes of @stream once.
+ *
+ * Types with a matching magic are listed first, then the types where the magic is not known or
+ * could not be checked. Types that cannot possibly parse the stream are not included, and
+ * otherwise the order of @gtypes is preserved.
+ *
+ * Returns: (transfer full) (element-type GType): firmware types, or %NULL on error
+ *
+ * Since: 2.0.0
+ **/
+GArray *
+fu_firmware_detect_gtypes(GInputStream *stream,
+			  gsize offset,
+			  FwupdInstallFlags flags,
+			  GArray *gtypes,
+			  GError **error)
+{
+	gsize bufsz = 0;
+	gsize streamsz = 0;
+	const guint8 *buf;
+	g_autoptr(GArray) items = g_array_new(FALSE, FALSE, sizeof(FuFirmwareDetectItem));
+	g_autoptr(GArray) gtypes_ranked = g_array_new(FALSE, FALSE, sizeof(GType));
+	g_autoptr(GBytes) blob = NULL;
+
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
+	g_return_val_if_fail(gtypes != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* reading the header would consume the data */
+	if (!G_IS_SEEKABLE(stream) || !g_seekable_can_seek(G_SEEKABLE(stream))) {
+		g_array_append_vals(gtypes_ranked, gtypes->data, gtypes->len);
+		return g_steal_pointer(&gtypes_ranked);
+	}
+
+	/* read the header just once */
+	if (!fu_input_stream_size(stream, &streamsz, error))
+		return NULL;
+	streamsz = offset < streamsz ? streamsz - offset : 0;
+	if (streamsz > 0) {
+		blob = fu_input_stream_read_bytes(stream, offset, FU_FIRMWARE_DETECT_BUFSZ, error);
+		if (blob == NULL)
+			return NULL;
+		buf = g_bytes_get_data(blob, &bufsz);
+	} else {
+		buf = NULL;
+	}
+
+	for (guint i = 0; i < gtypes->len; i++) {
+		GType gtype = g_array_index(gtypes, GType, i);
+		g_autoptr(FuFirmware) firmware = g_object_new(gtype, NULL);
+		FuFirmwareDetectItem item = {
+		    .gtype = gtype,
+		    .score = fu_firmware_detect_score(firmware, buf, bufsz, streamsz, flags),
+		    .idx = i,
+		};
+		if (item.score < 0) {
+			g_debug("ignoring %s as magic not found", g_type_name(gtype));
+			continue;
+		}
+		g_array_append_val(items, item);
+	}
+	g_array_sort(items, fu_firmware_detect_item_sort_cb);
+	for (guint i = 0; i < items->len; i++) {
+		FuFirmwareDetectItem *item = &g_array_index(items, FuFirmwareDetectItem, i);
+		g_array_append_val(gtypes_ranked, item->gtype);
+	}
+	return g_steal_pointer(&gtypes_ranked);
+}
+
 /**
  * fu_firmware_new_from_gtypes:
  * @stream: a #GInputStream
@@ -2434,7 +2635,8 @@ fu_firmware_new_from_bytes(GBytes *fw)
  * @error: (nullable): optional return location for an error
  * @...: an array of #GTypes, ending with %G_TYPE_INVALID
  *
- * Tries to parse the firmware with each #GType in order.
+ * Tries to parse the firmware with each #GType in order, skipping any type that is ruled out by
+ * fu_firmware_detect_gtypes().
  *
  * Returns: (transfer full) (nullable): a #FuFirmware, or %NULL
  *
@@ -2449,6 +2651,7 @@ fu_firmware_new_from_gtypes(GInputStream *stream,
 {
 	va_list args;
 	g_autoptr(GArray) gtypes = g_array_new(FALSE, FALSE, sizeof(GType));
+	g_autoptr(GArray) gtypes_ranked = NULL;
 	g_autoptr(GError) error_all = NULL;
 
 	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
@@ -2473,9 +2676,21 @@ fu_firmware_new_from_gtypes(GInputStream *stream,
 		return NULL;
 	}
 
+	/* only try the GTypes that could possibly match */
+	gtypes_ranked = fu_firmware_detect_gtypes(stream, offset, flags, gtypes, error);
+	if (gtypes_ranked == NULL)
+		return NULL;
+	if (gtypes_ranked->len == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "did not find magic for any firmware type");
+		return NULL;
+	}
+
 	/* try each GType in turn */
-	for (guint i = 0; i < gtypes->len; i++) {
-		GType gtype = g_array_index(gtypes, GType, i);
+	for (guint i = 0; i < gtypes_ranked->len; i++) {
+		GType gtype = g_array_index(gtypes_ranked, GType, i);
 		g_autoptr(FuFirmware) firmware = g_object_new(gtype, NULL);
 		g_autoptr(GError) error_local = NULL;
 		if (!fu_firmware_parse_stream(firmware, stream, offset, flags, &error_local)) {
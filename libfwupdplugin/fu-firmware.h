@@ -256,6 +256,12 @@ fu_firmware_new_from_gtypes(GInputStream *stream,
 			    FwupdInstallFlags flags,
 			    GError **error,
 			    ...) G_GNUC_NON_NULL(1);
+GArray *
+fu_firmware_detect_gtypes(GInputStream *stream,
+			  gsize offset,
+			  FwupdInstallFlags flags,
+			  GArray *gtypes,
+			  GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 4);
 gchar *
 fu_firmware_to_string(FuFirmware *self) G_GNUC_NON_NULL(1);
 void
@@ -423,3 +429,6 @@ fu_firmware_get_image_by_checksum(FuFirmware *self, const gchar *checksum, GErro
     G_GNUC_NON_NULL(1, 2);
 void
 fu_firmware_add_patch(FuFirmware *self, gsize offset, GBytes *blob) G_GNUC_NON_NULL(1, 3);
+void
+fu_firmware_add_magic(FuFirmware *self, const guint8 *buf, gsize bufsz, gsize offset)
+    G_GNUC_NON_NULL(1, 2);
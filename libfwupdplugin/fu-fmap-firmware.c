@@ -178,6 +178,7 @@ static void
 fu_fmap_firmware_init(FuFmapFirmware *self)
 {
 	fu_firmware_set_images_max(FU_FIRMWARE(self), 1024);
+	fu_firmware_add_magic(FU_FIRMWARE(self), (const guint8 *)"__FMAP__", 8, 0x0);
 }
 
 static void
@@ -413,6 +413,7 @@ static void
 fu_ifd_firmware_init(FuIfdFirmware *self)
 {
 	FuIfdFirmwarePrivate *priv = GET_PRIVATE(self);
+	const guint8 magic[] = {0x5A, 0xA5, 0xF0, 0x0F};
 
 	/* some good defaults */
 	priv->new_layout = TRUE;
@@ -428,6 +429,7 @@ fu_ifd_firmware_init(FuIfdFirmware *self)
 	g_type_ensure(FU_TYPE_IFD_BIOS);
 	g_type_ensure(FU_TYPE_IFD_IMAGE);
 	g_type_ensure(FU_TYPE_EFI_VOLUME);
+	fu_firmware_add_magic(FU_FIRMWARE(self), magic, sizeof(magic), 0x10);
 }
 
 static void
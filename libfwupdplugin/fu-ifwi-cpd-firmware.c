@@ -318,6 +318,7 @@ static void
 fu_ifwi_cpd_firmware_init(FuIfwiCpdFirmware *self)
 {
 	fu_firmware_set_images_max(FU_FIRMWARE(self), FU_IFWI_CPD_FIRMWARE_ENTRIES_MAX);
+	fu_firmware_add_magic(FU_FIRMWARE(self), (const guint8 *)"$CPD", 4, 0x0);
 }
 
 static void
@@ -174,6 +174,7 @@ static void
 fu_ifwi_fpt_firmware_init(FuIfwiFptFirmware *self)
 {
 	fu_firmware_set_images_max(FU_FIRMWARE(self), FU_IFWI_FPT_MAX_ENTRIES);
+	fu_firmware_add_magic(FU_FIRMWARE(self), (const guint8 *)"$FPT", 4, 0x0);
 }
 
 static void
@@ -0,0 +1,13 @@
+/*
+ * Copyright 2023 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include "fu-input-stream.h"
+
+GBytes *
+fu_input_stream_read_bytes_view(GInputStream *stream, gsize offset, gsize count)
+    G_GNUC_NON_NULL(1);
@@ -8,10 +8,14 @@
 
 #include "config.h"
 
+#include <glib/gstdio.h>
+
 #include "fu-chunk-array.h"
 #include "fu-crc.h"
-#include "fu-input-stream.h"
+#include "fu-input-stream-private.h"
+#include "fu-mapped-input-stream.h"
 #include "fu-mem-private.h"
+#include "fu-partial-input-stream.h"
 #include "fu-sum.h"
 
 /**
@@ -41,6 +45,40 @@ fu_input_stream_from_path(const gchar *path, GError **error)
 	return G_INPUT_STREAM(g_steal_pointer(&stream));
 }
 
+/**
+ * fu_input_stream_from_path_mapped:
+ * @path: a filename
+ * @error: (nullable): optional return location for an error
+ *
+ * Opens the file as an input stream, mapping regular files so that reads can avoid a copy.
+ *
+ * NOTE: Only use this for trusted local files, e.g. in the cache directory or a cabinet archive,
+ * as the process is sent `SIGBUS` if a mapped file is truncated or the media is removed.
+ *
+ * Returns: (transfer full): a #GInputStream, or %NULL on error
+ *
+ * Since: 2.0.0
+ **/
+GInputStream *
+fu_input_stream_from_path_mapped(const gchar *path, GError **error)
+{
+	GStatBuf statbuf = {0};
+	g_autoptr(GInputStream) stream_mapped = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	g_return_val_if_fail(path != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* procfs files report a size of zero and pseudo-files in sysfs cannot be mapped at all */
+	if (g_stat(path, &statbuf) == 0 && S_ISREG(statbuf.st_mode) && statbuf.st_size > 0) {
+		stream_mapped = fu_mapped_input_stream_new(path, &error_local);
+		if (stream_mapped != NULL)
+			return g_steal_pointer(&stream_mapped);
+		g_debug("failed to map %s, falling back to read: %s", path, error_local->message);
+	}
+	return fu_input_stream_from_path(path, error);
+}
+
 /**
  * fu_input_stream_read_safe:
  * @stream: a #GInputStream
@@ -326,6 +364,30 @@ fu_input_stream_read_byte_array(GInputStream *stream, gsize offset, gsize count,
 	return g_steal_pointer(&buf);
 }
 
+/* returns a view into the blob backing the stream, or %NULL if a copy is required */
+GBytes *
+fu_input_stream_read_bytes_view(GInputStream *stream, gsize offset, gsize count)
+{
+	if (FU_IS_PARTIAL_INPUT_STREAM(stream)) {
+		FuPartialInputStream *partial_stream = FU_PARTIAL_INPUT_STREAM(stream);
+		gsize size = fu_partial_input_stream_get_size(partial_stream);
+		if (offset > size)
+			return NULL;
+		return fu_input_stream_read_bytes_view(
+		    fu_partial_input_stream_get_base_stream(partial_stream),
+		    fu_partial_input_stream_get_offset(partial_stream) + offset,
+		    MIN(count, size - offset));
+	}
+	if (FU_IS_MAPPED_INPUT_STREAM(stream)) {
+		GBytes *bytes = fu_mapped_input_stream_get_bytes(FU_MAPPED_INPUT_STREAM(stream));
+		gsize bufsz = g_bytes_get_size(bytes);
+		if (offset > bufsz)
+			return NULL;
+		return g_bytes_new_from_bytes(bytes, offset, MIN(count, bufsz - offset));
+	}
+	return NULL;
+}
+
 /**
  * fu_input_stream_read_bytes:
  * @stream: a #GInputStream
@@ -344,9 +406,18 @@ fu_input_stream_read_byte_array(GInputStream *stream, gsize offset, gsize count,
 GBytes *
 fu_input_stream_read_bytes(GInputStream *stream, gsize offset, gsize count, GError **error)
 {
+	GBytes *blob;
 	g_autoptr(GByteArray) buf = NULL;
 	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
 	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	/* avoid the copy if possible */
+	if (count > 0) {
+		blob = fu_input_stream_read_bytes_view(stream, offset, count);
+		if (blob != NULL)
+			return blob;
+	}
+
 	buf = fu_input_stream_read_byte_array(stream, offset, count, error);
 	if (buf == NULL)
 		return NULL;
@@ -427,6 +498,149 @@ fu_input_stream_compute_checksum(GInputStream *stream, GChecksumType checksum_ty
 	return g_strdup(g_checksum_get_string(csum));
 }
 
+/* large enough that the thread handoff is insignificant */
+#define FU_INPUT_STREAM_CHECKSUMS_CHUNK_SIZE 0x100000 /* bytes */
+
+/* below this size the thread creation costs more than it saves */
+#define FU_INPUT_STREAM_CHECKSUMS_THREADED_MIN 0x400000 /* bytes */
+
+typedef struct {
+	GPtrArray *csums; /* of GChecksum */
+	GBytes *blob;	  /* current chunk */
+	GMutex mutex;
+	GCond cond;
+	guint pending;
+} FuInputStreamChecksumsHelper;
+
+static void
+fu_input_stream_compute_checksums_cb(gpointer data, gpointer user_data)
+{
+	GChecksum *csum = (GChecksum *)data;
+	FuInputStreamChecksumsHelper *helper = (FuInputStreamChecksumsHelper *)user_data;
+	gsize bufsz = 0;
+	const guint8 *buf = g_bytes_get_data(helper->blob, &bufsz);
+
+	g_checksum_update(csum, buf, bufsz);
+
+	g_mutex_lock(&helper->mutex);
+	helper->pending--;
+	g_cond_signal(&helper->cond);
+	g_mutex_unlock(&helper->mutex);
+}
+
+/**
+ * fu_input_stream_compute_checksums:
+ * @stream: a #GInputStream
+ * @checksum_types: (array length=checksum_typesz): #GChecksumType values
+ * @checksum_typesz: number of elements in @checksum_types
+ * @error: (nullable): optional return location for an error
+ *
+ * Generates several checksums of the entire stream, reading each byte only once.
+ *
+ * For large streams each digest is computed on its own thread, and the next chunk is read
+ * from @stream while the previous chunk is being hashed.
+ *
+ * Returns: (transfer container) (element-type utf8): the hexadecimal representation of each
+ * checksum in the same order as @checksum_types, or %NULL on error
+ *
+ * Since: 2.0.0
+ **/
+GPtrArray *
+fu_input_stream_compute_checksums(GInputStream *stream,
+				  const GChecksumType *checksum_types,
+				  guint checksum_typesz,
+				  GError **error)
+{
+	gboolean ret = TRUE;
+	gsize offset = 0;
+	gsize streamsz = 0;
+	FuInputStreamChecksumsHelper helper = {.pending = 0};
+	GThreadPool *pool = NULL;
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GPtrArray) checksums = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) csums =
+	    g_ptr_array_new_with_free_func((GDestroyNotify)g_checksum_free);
+
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
+	g_return_val_if_fail(checksum_types != NULL || checksum_typesz == 0, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	for (guint i = 0; i < checksum_typesz; i++)
+		g_ptr_array_add(csums, g_checksum_new(checksum_types[i]));
+	if (!fu_input_stream_size(stream, &streamsz, error))
+		return NULL;
+	blob = fu_input_stream_read_bytes(stream, 0x0, FU_INPUT_STREAM_CHECKSUMS_CHUNK_SIZE, error);
+	if (blob == NULL)
+		return NULL;
+
+	/* one thread per digest, the main thread reads ahead */
+	if (csums->len > 1 && streamsz >= FU_INPUT_STREAM_CHECKSUMS_THREADED_MIN) {
+		g_autoptr(GError) error_pool = NULL;
+		pool = g_thread_pool_new(fu_input_stream_compute_checksums_cb,
+					 &helper,
+					 csums->len,
+					 TRUE,
+					 &error_pool);
+		if (pool == NULL)
+			g_debug("hashing on one thread: %s", error_pool->message);
+	}
+	g_mutex_init(&helper.mutex);
+	g_cond_init(&helper.cond);
+
+	while (g_bytes_get_size(blob) > 0) {
+		g_autoptr(GBytes) blob_next = NULL;
+
+		/* hash this chunk, either now or in the background */
+		if (pool != NULL) {
+			helper.blob = blob;
+			helper.pending = csums->len;
+			for (guint i = 0; i < csums->len; i++)
+				g_thread_pool_push(pool, g_ptr_array_index(csums, i), NULL);
+		} else {
+			for (guint i = 0; i < csums->len; i++) {
+				GChecksum *csum = g_ptr_array_index(csums, i);
+				g_checksum_update(csum,
+						  g_bytes_get_data(blob, NULL),
+						  g_bytes_get_size(blob));
+			}
+		}
+
+		/* read the next chunk at the same time */
+		offset += g_bytes_get_size(blob);
+		if (offset < streamsz) {
+			blob_next = fu_input_stream_read_bytes(stream,
+							       offset,
+							       FU_INPUT_STREAM_CHECKSUMS_CHUNK_SIZE,
+							       error);
+			if (blob_next == NULL)
+				ret = FALSE;
+		}
+
+		/* wait for the workers before the chunk can be freed */
+		g_mutex_lock(&helper.mutex);
+		while (helper.pending > 0)
+			g_cond_wait(&helper.cond, &helper.mutex);
+		g_mutex_unlock(&helper.mutex);
+		if (!ret || blob_next == NULL)
+			break;
+		g_bytes_unref(blob);
+		blob = g_steal_pointer(&blob_next);
+	}
+	if (pool != NULL)
+		g_thread_pool_free(pool, FALSE, TRUE);
+	g_mutex_clear(&helper.mutex);
+	g_cond_clear(&helper.cond);
+	if (!ret)
+		return NULL;
+
+	/* success */
+	for (guint i = 0; i < csums->len; i++) {
+		GChecksum *csum = g_ptr_array_index(csums, i);
+		g_ptr_array_add(checksums, g_strdup(g_checksum_get_string(csum)));
+	}
+	return g_steal_pointer(&checksums);
+}
+
 static gboolean
 fu_input_stream_compute_sum8_cb(const guint8 *buf, gsize bufsz, gpointer user_data, GError **error)
 {
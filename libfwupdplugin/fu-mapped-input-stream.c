@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuMappedInputStream"
+
+#include "config.h"
+
+#include "fwupd-error.h"
+
+#include "fu-mapped-input-stream.h"
+
+/**
+ * FuMappedInputStream:
+ *
+ * A seekable input stream backed by a single #GBytes, typically a read-only memory mapping of a
+ * local file.
+ *
+ * Unlike a plain #GMemoryInputStream the backing blob is remembered, which allows
+ * fu_input_stream_read_bytes() to return a view of the data rather than a copy.
+ */
+
+struct _FuMappedInputStream {
+	GMemoryInputStream parent_instance;
+	GBytes *bytes;
+};
+
+G_DEFINE_TYPE(FuMappedInputStream, fu_mapped_input_stream, G_TYPE_MEMORY_INPUT_STREAM)
+
+/**
+ * fu_mapped_input_stream_new:
+ * @filename: a local filename
+ * @error: (nullable): optional return location for an error
+ *
+ * Creates a new stream backed by a read-only memory mapping of @filename.
+ *
+ * NOTE: the file must not be truncated while the stream, or any #GBytes obtained from it, is alive.
+ *
+ * Returns: (transfer full): a #GInputStream, or %NULL on error
+ *
+ * Since: 2.0.0
+ **/
+GInputStream *
+fu_mapped_input_stream_new(const gchar *filename, GError **error)
+{
+	g_autoptr(GMappedFile) mapped_file = NULL;
+	g_autoptr(GBytes) bytes = NULL;
+
+	g_return_val_if_fail(filename != NULL, NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	mapped_file = g_mapped_file_new(filename, FALSE, error);
+	if (mapped_file == NULL) {
+		fwupd_error_convert(error);
+		return NULL;
+	}
+	bytes = g_mapped_file_get_bytes(mapped_file);
+	return fu_mapped_input_stream_new_from_bytes(bytes);
+}
+
+/**
+ * fu_mapped_input_stream_new_from_bytes:
+ * @bytes: a #GBytes
+ *
+ * Creates a new stream backed by @bytes.
+ *
+ * Returns: (transfer full): a #GInputStream
+ *
+ * Since: 2.0.0
+ **/
+GInputStream *
+fu_mapped_input_stream_new_from_bytes(GBytes *bytes)
+{
+	g_autoptr(FuMappedInputStream) self = g_object_new(FU_TYPE_MAPPED_INPUT_STREAM, NULL);
+
+	g_return_val_if_fail(bytes != NULL, NULL);
+
+	self->bytes = g_bytes_ref(bytes);
+	g_memory_input_stream_add_bytes(G_MEMORY_INPUT_STREAM(self), bytes);
+	return G_INPUT_STREAM(g_steal_pointer(&self));
+}
+
+/**
+ * fu_mapped_input_stream_get_bytes:
+ * @self: a #FuMappedInputStream
+ *
+ * Gets the blob backing the stream.
+ *
+ * Returns: (transfer none): a #GBytes
+ *
+ * Since: 2.0.0
+ **/
+GBytes *
+fu_mapped_input_stream_get_bytes(FuMappedInputStream *self)
+{
+	g_return_val_if_fail(FU_IS_MAPPED_INPUT_STREAM(self), NULL);
+	return self->bytes;
+}
+
+static void
+fu_mapped_input_stream_finalize(GObject *object)
+{
+	FuMappedInputStream *self = FU_MAPPED_INPUT_STREAM(object);
+	if (self->bytes != NULL)
+		g_bytes_unref(self->bytes);
+	G_OBJECT_CLASS(fu_mapped_input_stream_parent_class)->finalize(object);
+}
+
+static void
+fu_mapped_input_stream_class_init(FuMappedInputStreamClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_mapped_input_stream_finalize;
+}
+
+static void
+fu_mapped_input_stream_init(FuMappedInputStream *self)
+{
+}
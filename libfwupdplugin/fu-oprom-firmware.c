@@ -286,7 +286,9 @@ fu_oprom_firmware_build(FuFirmware *firmware, XbNode *n, GError **error)
 static void
 fu_oprom_firmware_init(FuOpromFirmware *self)
 {
+	const guint8 magic[] = {0x55, 0xAA};
 	fu_firmware_add_flag(FU_FIRMWARE(self), FU_FIRMWARE_FLAG_HAS_STORED_SIZE);
+	fu_firmware_add_magic(FU_FIRMWARE(self), magic, sizeof(magic), 0x0);
 }
 
 static void
@@ -317,6 +317,7 @@ static void
 fu_pefile_firmware_init(FuPefileFirmware *self)
 {
 	fu_firmware_set_images_max(FU_FIRMWARE(self), 100);
+	fu_firmware_add_magic(FU_FIRMWARE(self), (const guint8 *)"MZ", 2, 0x0);
 }
 
 static void
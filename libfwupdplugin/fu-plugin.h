@@ -456,9 +456,18 @@ typedef struct _FuPluginClass FuPluginVfuncs;
  * @FU_PLUGIN_RULE_BETTER_THAN:		Is better than another plugin
  * @FU_PLUGIN_RULE_INHIBITS_IDLE:	The plugin inhibits the idle shutdown
  * @FU_PLUGIN_RULE_METADATA_SOURCE:	Uses another plugin as a source of report metadata
+ * @FU_PLUGIN_RULE_REQUIRES_CPU:	Requires a CPU vendor, e.g. `intel`
+ * @FU_PLUGIN_RULE_DEVICE_BACKEND:	Only creates devices from a backend, e.g. `usb`
  *
  * The rules used for ordering plugins.
  * Plugins are expected to add rules in fu_plugin_initialize().
+ *
+ * The %FU_PLUGIN_RULE_REQUIRES_CPU rules are checked before the plugin is started, and any one of
+ * them has to match.
+ *
+ * Plugins using %FU_PLUGIN_RULE_DEVICE_BACKEND are only started when the first device from one of
+ * the named backends is added, and are never sent devices from any other backend.
+ * This rule must not be used by plugins that implement ->coldplug().
  **/
 typedef enum {
 	FU_PLUGIN_RULE_CONFLICTS,
@@ -467,6 +476,8 @@ typedef enum {
 	FU_PLUGIN_RULE_BETTER_THAN,
 	FU_PLUGIN_RULE_INHIBITS_IDLE,
 	FU_PLUGIN_RULE_METADATA_SOURCE, /* Since: 1.3.6 */
+	FU_PLUGIN_RULE_REQUIRES_CPU,	/* Since: 2.0.0 */
+	FU_PLUGIN_RULE_DEVICE_BACKEND,	/* Since: 2.0.0 */
 	/*< private >*/
 	FU_PLUGIN_RULE_LAST
 } FuPluginRule;
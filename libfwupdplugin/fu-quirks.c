@@ -9,6 +9,7 @@
 #include "config.h"
 
 #include <gio/gio.h>
+#include <glib/gstdio.h>
 #include <string.h>
 
 #include "fwupd-common.h"
@@ -17,6 +18,7 @@
 
 #include "fu-bytes.h"
 #include "fu-common.h"
+#include "fu-input-stream.h"
 #include "fu-path.h"
 #include "fu-quirks.h"
 #include "fu-string.h"
@@ -75,8 +77,19 @@ struct _FuQuirks {
 	XbQuery *query_kv;
 	XbQuery *query_vs;
 	gboolean verbose;
+	GMutex cache_mutex;
+	GHashTable *cache_kv;	/* (element-type utf8 utf8): (nullable) for not found */
+	GHashTable *cache_iter; /* (element-type utf8 GPtrArray<utf8>): (nullable) for not found */
+	guint cache_hits;
+	guint cache_misses;
 };
 
+/* coldplug typically looks up a few thousand GUID and key combinations */
+#define FU_QUIRKS_CACHE_SIZE_MAX 8192
+
+/* bump this when the keyfile to XML conversion changes */
+#define FU_QUIRKS_CACHE_VERSION 1
+
 G_DEFINE_TYPE(FuQuirks, fu_quirks, G_TYPE_OBJECT)
 
 static gchar *
@@ -263,24 +276,83 @@ fu_quirks_convert_keyfile_to_xml(FuQuirks *self, GBytes *bytes, GError **error)
 	return g_bytes_new_take(g_steal_pointer(&xml), xmlsz);
 }
 
-static GInputStream *
-fu_quirks_convert_quirk_to_xml_cb(XbBuilderSource *source,
-				  XbBuilderSourceCtx *ctx,
-				  gpointer user_data,
-				  GCancellable *cancellable,
-				  GError **error)
+typedef struct {
+	gchar *filename;
+	GBytes *blob;	 /* keyfile, possibly compressed */
+	gchar *checksum; /* of FU_QUIRKS_CACHE_VERSION and blob */
+} FuQuirksFile;
+
+static void
+fu_quirks_file_free(FuQuirksFile *item)
+{
+	g_free(item->filename);
+	if (item->blob != NULL)
+		g_bytes_unref(item->blob);
+	g_free(item->checksum);
+	g_free(item);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuQuirksFile, fu_quirks_file_free)
+
+static GBytes *
+fu_quirks_file_get_keyfile(FuQuirksFile *item, GError **error)
+{
+	g_autoptr(GConverter) conv = NULL;
+	g_autoptr(GInputStream) istream1 = NULL;
+	g_autoptr(GInputStream) istream2 = NULL;
+
+	if (!g_str_has_suffix(item->filename, ".gz"))
+		return g_bytes_ref(item->blob);
+	istream1 = g_memory_input_stream_new_from_bytes(item->blob);
+	conv = G_CONVERTER(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_GZIP));
+	istream2 = g_converter_input_stream_new(istream1, conv);
+	return fu_input_stream_read_bytes(istream2, 0, G_MAXSIZE, error);
+}
+
+/* the XML is cached by checksum so that only the keyfiles that changed get converted */
+static GBytes *
+fu_quirks_file_get_xml(FuQuirks *self, FuQuirksFile *item, const gchar *cachedir, GError **error)
 {
-	FuQuirks *self = FU_QUIRKS(user_data);
-	g_autoptr(GBytes) bytes = NULL;
-	g_autoptr(GBytes) bytes_xml = NULL;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(GBytes) keyfile = NULL;
+	g_autoptr(GBytes) xml = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	/* already converted */
+	if (cachedir != NULL) {
+		g_autofree gchar *basename = g_strdup_printf("%s.xml", item->checksum);
+		fn = g_build_filename(cachedir, basename, NULL);
+		if (g_file_test(fn, G_FILE_TEST_EXISTS)) {
+			xml = fu_bytes_get_contents(fn, &error_local);
+			if (xml != NULL)
+				return g_steal_pointer(&xml);
+			g_debug("ignoring %s: %s", fn, error_local->message);
+		}
+	}
 
-	bytes = xb_builder_source_ctx_get_bytes(ctx, cancellable, error);
-	if (bytes == NULL)
+	/* convert */
+	keyfile = fu_quirks_file_get_keyfile(item, error);
+	if (keyfile == NULL) {
+		g_prefix_error(error, "failed to load %s: ", item->filename);
 		return NULL;
-	bytes_xml = fu_quirks_convert_keyfile_to_xml(self, bytes, error);
-	if (bytes_xml == NULL)
+	}
+	xml = fu_quirks_convert_keyfile_to_xml(self, keyfile, error);
+	if (xml == NULL) {
+		g_prefix_error(error, "failed to load %s: ", item->filename);
 		return NULL;
-	return g_memory_input_stream_new_from_bytes(bytes_xml);
+	}
+
+	/* save for next time, atomically */
+	if (fn != NULL) {
+		if (!fu_path_mkdir_parent(fn, &error_local) ||
+		    !g_file_set_contents(fn,
+					 g_bytes_get_data(xml, NULL),
+					 g_bytes_get_size(xml),
+					 &error_local)) {
+			g_debug("failed to save %s: %s", fn, error_local->message);
+		}
+	}
+	return g_steal_pointer(&xml);
 }
 
 static gint
@@ -292,7 +364,7 @@ fu_quirks_filename_sort_cb(gconstpointer a, gconstpointer b)
 }
 
 static gboolean
-fu_quirks_add_quirks_for_path(FuQuirks *self, XbBuilder *builder, const gchar *path, GError **error)
+fu_quirks_add_quirks_for_path(FuQuirks *self, GPtrArray *items, const gchar *path, GError **error)
 {
 	const gchar *tmp;
 	g_autoptr(GDir) dir = NULL;
@@ -317,36 +389,196 @@ fu_quirks_add_quirks_for_path(FuQuirks *self, XbBuilder *builder, const gchar *p
 	/* sort */
 	g_ptr_array_sort(filenames, fu_quirks_filename_sort_cb);
 
-	/* process files */
+	/* checksum the contents rather than the mtime as this works with reproducible images */
 	for (guint i = 0; i < filenames->len; i++) {
 		const gchar *filename = g_ptr_array_index(filenames, i);
-		g_autoptr(GFile) file = g_file_new_for_path(filename);
-		g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+		g_autoptr(FuQuirksFile) item = g_new0(FuQuirksFile, 1);
+		g_autoptr(GChecksum) csum = g_checksum_new(G_CHECKSUM_SHA256);
+		g_autofree gchar *version = g_strdup_printf("%u:", (guint)FU_QUIRKS_CACHE_VERSION);
 
-		/* load from keyfile */
-		xb_builder_source_add_simple_adapter(source,
-						     "text/plain,application/octet-stream,.quirk",
-						     fu_quirks_convert_quirk_to_xml_cb,
-						     self,
-						     NULL);
-		if (!xb_builder_source_load_file(source,
-						 file,
-						 XB_BUILDER_SOURCE_FLAG_WATCH_FILE |
-						     XB_BUILDER_SOURCE_FLAG_LITERAL_TEXT,
-						 NULL,
-						 error)) {
+		item->filename = g_strdup(filename);
+		item->blob = fu_bytes_get_contents(filename, error);
+		if (item->blob == NULL) {
 			g_prefix_error(error, "failed to load %s: ", filename);
 			return FALSE;
 		}
-
-		/* watch the file for changes */
-		xb_builder_import_source(builder, source);
+		g_checksum_update(csum, (const guchar *)version, -1);
+		g_checksum_update(csum,
+				  g_bytes_get_data(item->blob, NULL),
+				  g_bytes_get_size(item->blob));
+		item->checksum = g_strdup(g_checksum_get_string(csum));
+		g_ptr_array_add(items, g_steal_pointer(&item));
 	}
 
 	/* success */
 	return TRUE;
 }
 
+/* changes if any file is added, removed, renamed or modified */
+static gchar *
+fu_quirks_files_checksum(GPtrArray *items)
+{
+	g_autoptr(GChecksum) csum = g_checksum_new(G_CHECKSUM_SHA256);
+	for (guint i = 0; i < items->len; i++) {
+		FuQuirksFile *item = g_ptr_array_index(items, i);
+		g_checksum_update(csum, (const guchar *)item->filename, -1);
+		g_checksum_update(csum, (const guchar *)item->checksum, -1);
+	}
+	return g_strdup(g_checksum_get_string(csum));
+}
+
+static XbSilo *
+fu_quirks_build_silo(FuQuirks *self, GPtrArray *items, const gchar *cachedir, GError **error)
+{
+	g_autoptr(XbBuilder) builder = xb_builder_new();
+
+	for (guint i = 0; i < items->len; i++) {
+		FuQuirksFile *item = g_ptr_array_index(items, i);
+		g_autoptr(GBytes) xml = NULL;
+		g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+
+		xml = fu_quirks_file_get_xml(self, item, cachedir, error);
+		if (xml == NULL)
+			return NULL;
+		if (!xb_builder_source_load_bytes(source,
+						  xml,
+						  XB_BUILDER_SOURCE_FLAG_LITERAL_TEXT,
+						  error)) {
+			g_prefix_error(error, "failed to load %s: ", item->filename);
+			return NULL;
+		}
+		xb_builder_import_source(builder, source);
+	}
+	if (g_getenv("FWUPD_XMLB_VERBOSE") != NULL) {
+		xb_builder_set_profile_flags(builder,
+					     XB_SILO_PROFILE_FLAG_XPATH |
+						 XB_SILO_PROFILE_FLAG_DEBUG);
+	}
+	return xb_builder_compile(builder, XB_BUILDER_COMPILE_FLAG_NONE, NULL, error);
+}
+
+/* delete anything in @path matching @pattern that is not in @keep */
+static void
+fu_quirks_cache_prune(const gchar *path, const gchar *pattern, GHashTable *keep)
+{
+	g_autoptr(GPtrArray) filenames = fu_path_glob(path, pattern, NULL);
+	if (filenames == NULL)
+		return;
+	for (guint i = 0; i < filenames->len; i++) {
+		const gchar *filename = g_ptr_array_index(filenames, i);
+		if (g_hash_table_contains(keep, filename))
+			continue;
+		g_debug("deleting stale quirk cache %s", filename);
+		if (g_unlink(filename) != 0)
+			g_debug("failed to delete %s", filename);
+	}
+}
+
+/* compile a new silo, write it atomically and then map it so it can be shared */
+static XbSilo *
+fu_quirks_rebuild_silo(FuQuirks *self, GPtrArray *items, const gchar *xmlbfn, GError **error)
+{
+	gint fd;
+	g_autofree gchar *cachedir = g_path_get_dirname(xmlbfn);
+	g_autofree gchar *cachedir_xml = g_build_filename(cachedir, "quirks", NULL);
+	g_autofree gchar *tmpfn = g_build_filename(cachedir, "quirks-XXXXXX.tmp", NULL);
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(xmlbfn);
+	g_autoptr(GFile) file_tmp = NULL;
+	g_autoptr(GHashTable) keep = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	g_autoptr(XbSilo) silo = NULL;
+	g_autoptr(XbSilo) silo_mapped = xb_silo_new();
+
+	silo = fu_quirks_build_silo(self, items, cachedir_xml, error);
+	if (silo == NULL)
+		return NULL;
+
+	/* the cache directory may be read-only */
+	if (!fu_path_mkdir_parent(tmpfn, &error_local)) {
+		g_info("not saving quirk cache: %s", error_local->message);
+		return g_steal_pointer(&silo);
+	}
+	fd = g_mkstemp(tmpfn);
+	if (fd < 0) {
+		g_info("not saving quirk cache: failed to create %s", tmpfn);
+		return g_steal_pointer(&silo);
+	}
+	g_close(fd, NULL);
+	file_tmp = g_file_new_for_path(tmpfn);
+	if (!xb_silo_save_to_file(silo, file_tmp, NULL, &error_local)) {
+		g_info("not saving quirk cache: %s", error_local->message);
+		g_unlink(tmpfn);
+		return g_steal_pointer(&silo);
+	}
+
+	/* g_mkstemp() uses 0600, but unprivileged processes also map the silo */
+	if (g_chmod(tmpfn, 0644) != 0) {
+		g_info("not saving quirk cache: failed to chmod %s", tmpfn);
+		g_unlink(tmpfn);
+		return g_steal_pointer(&silo);
+	}
+	if (g_rename(tmpfn, xmlbfn) != 0) {
+		g_info("not saving quirk cache: failed to rename %s", tmpfn);
+		g_unlink(tmpfn);
+		return g_steal_pointer(&silo);
+	}
+
+	/* anything not referenced is now stale */
+	g_hash_table_add(keep, g_strdup(xmlbfn));
+	fu_quirks_cache_prune(cachedir, "quirks*.xmlb", keep);
+	g_hash_table_remove_all(keep);
+	for (guint i = 0; i < items->len; i++) {
+		FuQuirksFile *item = g_ptr_array_index(items, i);
+		g_autofree gchar *basename = g_strdup_printf("%s.xml", item->checksum);
+		g_hash_table_add(keep, g_build_filename(cachedir_xml, basename, NULL));
+	}
+	fu_quirks_cache_prune(cachedir_xml, "*.xml", keep);
+
+	/* use the mapped file rather than the heap copy; the filename changes with the contents
+	 * so the blob is not watched, and another process pruning it does not invalidate us */
+	if (!xb_silo_load_from_file(silo_mapped,
+				    file,
+				    XB_SILO_LOAD_FLAG_NONE,
+				    NULL,
+				    &error_local)) {
+		g_warning("failed to load %s: %s", xmlbfn, error_local->message);
+		return g_steal_pointer(&silo);
+	}
+	return g_steal_pointer(&silo_mapped);
+}
+
+static XbSilo *
+fu_quirks_load_silo(FuQuirks *self, GPtrArray *items, GError **error)
+{
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *checksum = fu_quirks_files_checksum(items);
+	g_autofree gchar *basename = g_strdup_printf("quirks-%s.xmlb", checksum);
+	g_autofree gchar *xmlbfn = g_build_filename(cachedirpkg, basename, NULL);
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(xmlbfn);
+	g_autoptr(XbSilo) silo = xb_silo_new();
+
+	/* not allowed to write anything */
+	if (self->load_flags & FU_QUIRKS_LOAD_FLAG_NO_CACHE)
+		return fu_quirks_build_silo(self, items, NULL, error);
+
+	/* already compiled, perhaps by another process */
+	if (g_file_test(xmlbfn, G_FILE_TEST_EXISTS)) {
+		if (xb_silo_load_from_file(silo,
+					   file,
+					   XB_SILO_LOAD_FLAG_NONE,
+					   NULL,
+					   &error_local))
+			return g_steal_pointer(&silo);
+		g_info("rebuilding quirk cache: %s", error_local->message);
+	}
+
+	/* use the cache if it exists, but do not try to write it */
+	if (self->load_flags & FU_QUIRKS_LOAD_FLAG_READONLY_FS)
+		return fu_quirks_build_silo(self, items, NULL, error);
+	return fu_quirks_rebuild_silo(self, items, xmlbfn, error);
+}
+
 static gint
 fu_quirks_strcasecmp_cb(gconstpointer a, gconstpointer b)
 {
@@ -355,53 +587,82 @@ fu_quirks_strcasecmp_cb(gconstpointer a, gconstpointer b)
 	return g_ascii_strcasecmp(entry1, entry2);
 }
 
+static void
+fu_quirks_cache_invalidate(FuQuirks *self)
+{
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->cache_mutex);
+	g_hash_table_remove_all(self->cache_kv);
+	g_hash_table_remove_all(self->cache_iter);
+}
+
+static gchar *
+fu_quirks_cache_key(const gchar *guid, const gchar *key)
+{
+	if (key == NULL)
+		return g_strdup(guid);
+	return g_strdup_printf("%s\n%s", guid, key);
+}
+
+static void
+fu_quirks_cache_kvs_free(GPtrArray *kvs)
+{
+	if (kvs != NULL)
+		g_ptr_array_unref(kvs);
+}
+
+/* cache_mutex must be held; the cache is bounded by just starting again when full */
+static void
+fu_quirks_cache_insert(FuQuirks *self, GHashTable *cache, gchar *cache_key, gpointer value)
+{
+	if (g_hash_table_size(cache) >= FU_QUIRKS_CACHE_SIZE_MAX) {
+		g_debug("quirk cache full, clearing");
+		g_hash_table_remove_all(cache);
+	}
+	g_hash_table_insert(cache, cache_key, value);
+}
+
 static gboolean
 fu_quirks_check_silo(FuQuirks *self, GError **error)
 {
-	XbBuilderCompileFlags compile_flags = XB_BUILDER_COMPILE_FLAG_WATCH_BLOB;
 	g_autofree gchar *datadir = NULL;
 	g_autofree gchar *localstatedir = NULL;
-	g_autoptr(GFile) file = NULL;
-	g_autoptr(XbBuilder) builder = NULL;
+	g_autoptr(GPtrArray) items = NULL;
 	g_autoptr(XbNode) n_any = NULL;
 
 	/* everything is okay */
 	if (self->silo != NULL && xb_silo_is_valid(self->silo))
 		return TRUE;
 
+	/* results point into the old silo */
+	fu_quirks_cache_invalidate(self);
+	g_clear_object(&self->query_kv);
+	g_clear_object(&self->query_vs);
+	g_clear_object(&self->silo);
+
 	/* system datadir */
-	builder = xb_builder_new();
+	items = g_ptr_array_new_with_free_func((GDestroyNotify)fu_quirks_file_free);
 	datadir = fu_path_from_kind(FU_PATH_KIND_DATADIR_QUIRKS);
-	if (!fu_quirks_add_quirks_for_path(self, builder, datadir, error))
+	if (!fu_quirks_add_quirks_for_path(self, items, datadir, error))
 		return FALSE;
 
 	/* something we can write when using Ostree */
 	localstatedir = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_QUIRKS);
-	if (!fu_quirks_add_quirks_for_path(self, builder, localstatedir, error))
+	if (!fu_quirks_add_quirks_for_path(self, items, localstatedir, error))
 		return FALSE;
 
 	/* load silo */
-	if (self->load_flags & FU_QUIRKS_LOAD_FLAG_NO_CACHE) {
-		g_autoptr(GFileIOStream) iostr = NULL;
-		file = g_file_new_tmp(NULL, &iostr, error);
-		if (file == NULL)
-			return FALSE;
-	} else {
-		g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
-		g_autofree gchar *xmlbfn = g_build_filename(cachedirpkg, "quirks.xmlb", NULL);
-		file = g_file_new_for_path(xmlbfn);
-	}
-	if (g_getenv("FWUPD_XMLB_VERBOSE") != NULL) {
-		xb_builder_set_profile_flags(builder,
-					     XB_SILO_PROFILE_FLAG_XPATH |
-						 XB_SILO_PROFILE_FLAG_DEBUG);
-	}
-	if (self->load_flags & FU_QUIRKS_LOAD_FLAG_READONLY_FS)
-		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
-	self->silo = xb_builder_ensure(builder, file, compile_flags, NULL, error);
+	self->silo = fu_quirks_load_silo(self, items, error);
 	if (self->silo == NULL)
 		return FALSE;
 
+	/* rebuild if any keyfile changes */
+	for (guint i = 0; i < items->len; i++) {
+		FuQuirksFile *item = g_ptr_array_index(items, i);
+		g_autoptr(GFile) file = g_file_new_for_path(item->filename);
+		if (!xb_silo_watch_file(self->silo, file, NULL, error))
+			return FALSE;
+	}
+
 	/* dump warnings to console, just once */
 	if (self->invalid_keys->len > 0) {
 		g_autofree gchar *str = NULL;
@@ -459,8 +720,12 @@ fu_quirks_check_silo(FuQuirks *self, GError **error)
 const gchar *
 fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 {
+	const gchar *value;
+	gpointer value_tmp = NULL;
+	g_autofree gchar *cache_key = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(XbNode) n = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
 	g_return_val_if_fail(FU_IS_QUIRKS(self), NULL);
@@ -477,22 +742,54 @@ fu_quirks_lookup_by_id(FuQuirks *self, const gchar *guid, const gchar *key)
 	if (self->query_kv == NULL)
 		return NULL;
 
+	/* already looked up, possibly not found */
+	cache_key = fu_quirks_cache_key(guid, key);
+	locker = g_mutex_locker_new(&self->cache_mutex);
+	if (g_hash_table_lookup_extended(self->cache_kv, cache_key, NULL, &value_tmp)) {
+		self->cache_hits++;
+		return (const gchar *)value_tmp;
+	}
+	self->cache_misses++;
+
 	/* query */
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 1, key, NULL);
 	n = xb_silo_query_first_with_context(self->silo, self->query_kv, &context, &error);
 	if (n == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return NULL;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
+		    g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			fu_quirks_cache_insert(self,
+					       self->cache_kv,
+					       g_steal_pointer(&cache_key),
+					       NULL);
 			return NULL;
+		}
 		g_warning("failed to query: %s", error->message);
 		return NULL;
 	}
+
+	/* the text is owned by the silo, which outlives the cache */
+	value = xb_node_get_text(n);
 	if (self->verbose)
-		g_debug("%s:%s → %s", guid, key, xb_node_get_text(n));
-	return xb_node_get_text(n);
+		g_debug("%s:%s → %s", guid, key, value);
+	fu_quirks_cache_insert(self, self->cache_kv, g_steal_pointer(&cache_key), (gpointer)value);
+	return value;
+}
+
+static gboolean
+fu_quirks_lookup_by_id_iter_kvs(FuQuirks *self,
+				GPtrArray *kvs,
+				FuQuirksIter iter_cb,
+				gpointer user_data)
+{
+	for (guint i = 0; i < kvs->len; i += 2) {
+		iter_cb(self,
+			g_ptr_array_index(kvs, i),
+			g_ptr_array_index(kvs, i + 1),
+			user_data);
+	}
+	return TRUE;
 }
 
 /**
@@ -516,7 +813,10 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 			    FuQuirksIter iter_cb,
 			    gpointer user_data)
 {
+	gpointer kvs_tmp = NULL;
+	g_autofree gchar *cache_key = NULL;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) kvs = NULL;
 	g_autoptr(GPtrArray) results = NULL;
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 
@@ -534,6 +834,21 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 	if (self->query_vs == NULL)
 		return FALSE;
 
+	/* already looked up, possibly not found */
+	cache_key = fu_quirks_cache_key(guid, key);
+	g_mutex_lock(&self->cache_mutex);
+	if (g_hash_table_lookup_extended(self->cache_iter, cache_key, NULL, &kvs_tmp)) {
+		self->cache_hits++;
+		if (kvs_tmp != NULL)
+			kvs = g_ptr_array_ref(kvs_tmp);
+		g_mutex_unlock(&self->cache_mutex);
+		if (kvs == NULL)
+			return FALSE;
+		return fu_quirks_lookup_by_id_iter_kvs(self, kvs, iter_cb, user_data);
+	}
+	self->cache_misses++;
+	g_mutex_unlock(&self->cache_mutex);
+
 	/* query */
 	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
@@ -544,20 +859,70 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 		results = xb_silo_query_with_context(self->silo, self->query_vs, &context, &error);
 	}
 	if (results == NULL) {
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
-			return FALSE;
-		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
+		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
+		    g_error_matches(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
+			g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->cache_mutex);
+			fu_quirks_cache_insert(self,
+					       self->cache_iter,
+					       g_steal_pointer(&cache_key),
+					       NULL);
 			return FALSE;
+		}
 		g_warning("failed to query: %s", error->message);
 		return FALSE;
 	}
+
+	/* the key and value strings are owned by the silo, which outlives the cache */
+	kvs = g_ptr_array_sized_new(results->len * 2);
 	for (guint i = 0; i < results->len; i++) {
 		XbNode *n = g_ptr_array_index(results, i);
 		if (self->verbose)
 			g_debug("%s → %s", guid, xb_node_get_text(n));
-		iter_cb(self, xb_node_get_attr(n, "key"), xb_node_get_text(n), user_data);
+		g_ptr_array_add(kvs, (gpointer)xb_node_get_attr(n, "key"));
+		g_ptr_array_add(kvs, (gpointer)xb_node_get_text(n));
 	}
-	return TRUE;
+	g_mutex_lock(&self->cache_mutex);
+	fu_quirks_cache_insert(self,
+			       self->cache_iter,
+			       g_steal_pointer(&cache_key),
+			       g_ptr_array_ref(kvs));
+	g_mutex_unlock(&self->cache_mutex);
+	return fu_quirks_lookup_by_id_iter_kvs(self, kvs, iter_cb, user_data);
+}
+
+/**
+ * fu_quirks_get_cache_hits:
+ * @self: a #FuQuirks
+ *
+ * Gets the number of lookups that were answered from the in-memory cache, rather than querying
+ * the silo.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_quirks_get_cache_hits(FuQuirks *self)
+{
+	g_return_val_if_fail(FU_IS_QUIRKS(self), G_MAXUINT);
+	return self->cache_hits;
+}
+
+/**
+ * fu_quirks_get_cache_misses:
+ * @self: a #FuQuirks
+ *
+ * Gets the number of lookups that had to query the silo.
+ *
+ * Returns: integer
+ *
+ * Since: 2.0.0
+ **/
+guint
+fu_quirks_get_cache_misses(FuQuirks *self)
+{
+	g_return_val_if_fail(FU_IS_QUIRKS(self), G_MAXUINT);
+	return self->cache_misses;
 }
 
 /**
@@ -612,6 +977,12 @@ fu_quirks_init(FuQuirks *self)
 {
 	self->possible_keys = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->invalid_keys = g_ptr_array_new_with_free_func(g_free);
+	self->cache_kv = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->cache_iter = g_hash_table_new_full(g_str_hash,
+						 g_str_equal,
+						 g_free,
+						 (GDestroyNotify)fu_quirks_cache_kvs_free);
+	g_mutex_init(&self->cache_mutex);
 
 	/* built in */
 	fu_quirks_add_possible_key(self, FU_QUIRKS_BRANCH);
@@ -670,6 +1041,9 @@ fu_quirks_finalize(GObject *obj)
 		g_object_unref(self->silo);
 	g_hash_table_unref(self->possible_keys);
 	g_ptr_array_unref(self->invalid_keys);
+	g_hash_table_unref(self->cache_kv);
+	g_hash_table_unref(self->cache_iter);
+	g_mutex_clear(&self->cache_mutex);
 	G_OBJECT_CLASS(fu_quirks_parent_class)->finalize(obj);
 }
 
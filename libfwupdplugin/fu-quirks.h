@@ -15,7 +15,7 @@ G_DECLARE_FINAL_TYPE(FuQuirks, fu_quirks, FU, QUIRKS, GObject)
 /**
  * FuQuirksLoadFlags:
  * @FU_QUIRKS_LOAD_FLAG_NONE:		No flags set
- * @FU_QUIRKS_LOAD_FLAG_READONLY_FS:	Ignore readonly filesystem errors
+ * @FU_QUIRKS_LOAD_FLAG_READONLY_FS:	Do not write the cache, e.g. on a readonly filesystem
  * @FU_QUIRKS_LOAD_FLAG_NO_CACHE:	Do not save to a persistent cache
  * @FU_QUIRKS_LOAD_FLAG_NO_VERIFY:	Do not check the key files for errors
  *
@@ -61,6 +61,10 @@ fu_quirks_lookup_by_id_iter(FuQuirks *self,
 			    gpointer user_data) G_GNUC_NON_NULL(1, 2);
 void
 fu_quirks_add_possible_key(FuQuirks *self, const gchar *possible_key) G_GNUC_NON_NULL(1, 2);
+guint
+fu_quirks_get_cache_hits(FuQuirks *self) G_GNUC_NON_NULL(1);
+guint
+fu_quirks_get_cache_misses(FuQuirks *self) G_GNUC_NON_NULL(1);
 
 /**
  * FU_QUIRKS_PLUGIN:
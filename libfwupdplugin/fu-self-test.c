@@ -21,6 +21,7 @@
 #include "fu-config-private.h"
 #include "fu-context-private.h"
 #include "fu-coswid-firmware.h"
+#include "fu-crc-private.h"
 #include "fu-device-private.h"
 #include "fu-device-progress.h"
 #include "fu-efi-lz77-decompressor.h"
@@ -208,6 +209,94 @@ fu_common_crc_func(void)
 	g_assert_cmpint(fu_misr16(0xFFFF, buf, (sizeof(buf) / 2) * 2), ==, 0xFBFA);
 }
 
+static void
+fu_common_crc_tables_func(void)
+{
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+
+	/* compare the table and accelerated versions against the bitwise reference */
+	for (guint i = 0; i < 0x400; i++)
+		fu_byte_array_append_uint8(buf, (guint8)g_random_int());
+	for (gsize offset = 0; offset < 4; offset++) {
+		for (gsize bufsz = 0; bufsz < buf->len - offset; bufsz += 7) {
+			const guint8 *data = buf->data + offset;
+			g_assert_cmpint(fu_crc8_full(data, bufsz, 0x00, 0x07),
+					==,
+					fu_crc8_full_bitwise(data, bufsz, 0x00, 0x07));
+			g_assert_cmpint(fu_crc8_full(data, bufsz, 0x5A, 0x31),
+					==,
+					fu_crc8_full_bitwise(data, bufsz, 0x5A, 0x31));
+			g_assert_cmpint(fu_crc16_full(data, bufsz, 0xFFFF, 0xA001),
+					==,
+					fu_crc16_full_bitwise(data, bufsz, 0xFFFF, 0xA001));
+			g_assert_cmpint(fu_crc16_full(data, bufsz, 0x0000, 0x8408),
+					==,
+					fu_crc16_full_bitwise(data, bufsz, 0x0000, 0x8408));
+			g_assert_cmpint(fu_crc32_full(data, bufsz, 0xFFFFFFFF, 0xEDB88320),
+					==,
+					fu_crc32_full_bitwise(data, bufsz, 0xFFFFFFFF, 0xEDB88320));
+			g_assert_cmpint(fu_crc32_full(data, bufsz, 0x12345678, 0x82F63B78),
+					==,
+					fu_crc32_full_bitwise(data, bufsz, 0x12345678, 0x82F63B78));
+		}
+	}
+}
+
+static void
+fu_common_crc_performance_func(void)
+{
+	gboolean ret;
+	guint32 crc_chunks = 0;
+	guint32 crc_reference;
+	guint32 crc;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* 32MiB SPI image */
+	fu_byte_array_set_size(buf, 32 * 1024 * 1024, 0x00);
+	for (guint i = 0; i < buf->len; i += 4)
+		fu_memwrite_uint32(buf->data + i, g_random_int(), G_LITTLE_ENDIAN);
+
+	g_timer_reset(timer);
+	crc_reference = fu_crc32_full_bitwise(buf->data, buf->len, 0xFFFFFFFF, 0xEDB88320);
+	g_print("bitwise=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	g_timer_reset(timer);
+	crc = fu_crc32(buf->data, buf->len);
+	g_print("crc32=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(crc, ==, crc_reference);
+
+	g_timer_reset(timer);
+	crc = fu_crc32_full(buf->data, buf->len, 0xFFFFFFFF, 0x82F63B78);
+	g_print("crc32c=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(crc, ==, fu_crc32_full_bitwise(buf->data, buf->len, 0xFFFFFFFF, 0x82F63B78));
+
+	g_timer_reset(timer);
+	fu_crc16(buf->data, buf->len);
+	g_print("crc16=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	g_timer_reset(timer);
+	fu_crc8(buf->data, buf->len);
+	g_print("crc8=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* streamed */
+	blob = g_bytes_new(buf->data, buf->len);
+	stream = g_memory_input_stream_new_from_bytes(blob);
+	chunks = fu_chunk_array_new_from_stream(stream, 0x0, 0x1000, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(chunks);
+	g_timer_reset(timer);
+	ret = fu_chunk_array_compute_crc32(chunks, &crc_chunks, 0xEDB88320, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("stream=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(crc_chunks, ==, crc_reference);
+}
+
 static void
 fu_string_append_func(void)
 {
@@ -1179,6 +1268,83 @@ fu_plugin_quirks_performance_func(void)
 		}
 	}
 	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(fu_quirks_get_cache_misses(quirks), ==, 3);
+	g_assert_cmpint(fu_quirks_get_cache_hits(quirks), ==, 2997);
+
+	/* negative lookups are cached too */
+	for (guint j = 0; j < 1000; j++) {
+		const gchar *tmp =
+		    fu_quirks_lookup_by_id(quirks, "8ff2ed23-b37e-5f61-b409-b7fe9563be36", "Name");
+		g_assert_cmpstr(tmp, ==, NULL);
+	}
+	g_print("hits=%u misses=%u ",
+		fu_quirks_get_cache_hits(quirks),
+		fu_quirks_get_cache_misses(quirks));
+	g_assert_cmpint(fu_quirks_get_cache_misses(quirks), ==, 4);
+}
+
+static void
+fu_plugin_quirks_cache_func(void)
+{
+	gboolean ret;
+	const gchar *tmp;
+#ifndef _WIN32
+	gint rc;
+	GStatBuf statbuf = {0};
+#endif
+	g_autofree gchar *cachedir = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *cachedir_xml = g_build_filename(cachedir, "quirks", NULL);
+	g_autoptr(FuQuirks) quirks1 = fu_quirks_new();
+	g_autoptr(FuQuirks) quirks2 = fu_quirks_new();
+	g_autoptr(FuQuirks) quirks3 = fu_quirks_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) fns1 = NULL;
+	g_autoptr(GPtrArray) fns2 = NULL;
+	g_autoptr(GPtrArray) fns3 = NULL;
+	g_autoptr(GPtrArray) fns_xml = NULL;
+
+	/* compile and save */
+	ret = fu_quirks_load(quirks1, FU_QUIRKS_LOAD_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	tmp = fu_quirks_lookup_by_id(quirks1, "bb9ec3e2-77b3-53bc-a1f1-b05916715627", "Flags");
+	g_assert_cmpstr(tmp, ==, "clever");
+	fns1 = fu_path_glob(cachedir, "quirks*.xmlb", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fns1);
+	g_assert_cmpint(fns1->len, ==, 1);
+	fns_xml = fu_path_glob(cachedir_xml, "*.xml", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fns_xml);
+
+	/* the same silo is mapped again rather than being rebuilt */
+	ret = fu_quirks_load(quirks2, FU_QUIRKS_LOAD_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	tmp = fu_quirks_lookup_by_id(quirks2, "bb9ec3e2-77b3-53bc-a1f1-b05916715627", "Flags");
+	g_assert_cmpstr(tmp, ==, "clever");
+	fns2 = fu_path_glob(cachedir, "quirks*.xmlb", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fns2);
+	g_assert_cmpint(fns2->len, ==, 1);
+	g_assert_cmpstr(g_ptr_array_index(fns1, 0), ==, g_ptr_array_index(fns2, 0));
+
+#ifndef _WIN32
+	/* unprivileged processes can map the silo too */
+	rc = g_stat(g_ptr_array_index(fns1, 0), &statbuf);
+	g_assert_cmpint(rc, ==, 0);
+	g_assert_cmpint(statbuf.st_mode & 0777, ==, 0644);
+#endif
+
+	/* the existing silo is not required, and nothing new is written */
+	g_assert_cmpint(g_unlink(g_ptr_array_index(fns1, 0)), ==, 0);
+	ret = fu_quirks_load(quirks3, FU_QUIRKS_LOAD_FLAG_READONLY_FS, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	tmp = fu_quirks_lookup_by_id(quirks3, "bb9ec3e2-77b3-53bc-a1f1-b05916715627", "Flags");
+	g_assert_cmpstr(tmp, ==, "clever");
+	fns3 = fu_path_glob(cachedir, "quirks*.xmlb", NULL);
+	g_assert_null(fns3);
 }
 
 typedef struct {
@@ -2004,6 +2170,31 @@ fu_device_incorporate_descendant_func(void)
 	g_assert_cmpstr(fu_device_get_summary(device), ==, "FuUsbDevice");
 }
 
+static void
+fu_usb_device_transfer_chunks_func(void)
+{
+	gboolean ret;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuUsbDevice) usb_device = fu_usb_device_new(ctx, NULL);
+	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(GBytes) blob = g_bytes_new_static("hello world!", 12);
+	g_autoptr(GError) error = NULL;
+
+	/* no GUsbDevice, so nothing to submit the queue to */
+	chunks = fu_chunk_array_new_from_bytes(blob, 0x0, 4);
+	ret = fu_usb_device_bulk_transfer_chunks(usb_device,
+						 0x01,
+						 chunks,
+						 4,
+						 1000,
+						 NULL,
+						 NULL,
+						 NULL,
+						 &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED);
+	g_assert_false(ret);
+}
+
 static void
 fu_device_incorporate_func(void)
 {
@@ -2118,6 +2309,8 @@ fu_backend_func(void)
 static void
 fu_chunk_array_func(void)
 {
+	gboolean ret;
+	guint32 crc = 0;
 	g_autoptr(FuChunk) chk1 = NULL;
 	g_autoptr(FuChunk) chk2 = NULL;
 	g_autoptr(FuChunk) chk3 = NULL;
@@ -2157,6 +2350,90 @@ fu_chunk_array_func(void)
 	g_assert_null(chk4);
 	chk4 = fu_chunk_array_index(chunks, 1024, NULL);
 	g_assert_null(chk4);
+
+	ret = fu_chunk_array_compute_crc32(chunks, &crc, 0xEDB88320, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(crc, ==, fu_crc32((const guint8 *)"hello world", 11));
+}
+
+static void
+fu_chunk_array_stream_func(void)
+{
+	const guint idxs[] = {0x48D1, 0x0, 0x2000, 0x1FFF};
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(GError) error = NULL;
+
+	/* not a multiple of the window or packet size */
+	for (guint i = 0; i < 0x123457; i++)
+		fu_byte_array_append_uint8(buf, i % 0xFB);
+	blob = g_bytes_new(buf->data, buf->len);
+	stream = g_memory_input_stream_new_from_bytes(blob);
+	chunks = fu_chunk_array_new_from_stream(stream, 0x1000, 0x40, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(chunks);
+	fu_chunk_array_set_prefetch(chunks, TRUE);
+	g_assert_cmpint(fu_chunk_array_length(chunks), ==, 0x48D2);
+
+	/* sequential */
+	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
+		g_autoptr(FuChunk) chk = fu_chunk_array_index(chunks, i, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(chk);
+		g_assert_cmpint(fu_chunk_get_address(chk), ==, 0x1000 + i * 0x40);
+		g_assert_cmpint(fu_chunk_get_data_sz(chk), ==, MIN(0x40, buf->len - i * 0x40));
+		g_assert_cmpint(memcmp(fu_chunk_get_data(chk),
+				       buf->data + i * 0x40,
+				       fu_chunk_get_data_sz(chk)),
+				==,
+				0);
+	}
+
+	/* random access, so the prefetched window is not used */
+	for (guint i = 0; i < G_N_ELEMENTS(idxs); i++) {
+		g_autoptr(FuChunk) chk = fu_chunk_array_index(chunks, idxs[i], &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(chk);
+		g_assert_cmpint(memcmp(fu_chunk_get_data(chk),
+				       buf->data + idxs[i] * 0x40,
+				       fu_chunk_get_data_sz(chk)),
+				==,
+				0);
+	}
+}
+
+static void
+fu_chunk_array_stream_performance_func(void)
+{
+	gsize total = 0;
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+	g_autoptr(GError) error = NULL;
+
+	/* 16MiB in HID-sized packets */
+	fu_byte_array_set_size(buf, 16 * 1024 * 1024, 0xA5);
+	blob = g_bytes_new(buf->data, buf->len);
+	stream = g_memory_input_stream_new_from_bytes(blob);
+	chunks = fu_chunk_array_new_from_stream(stream, 0x0, 64, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(chunks);
+	fu_chunk_array_set_prefetch(chunks, TRUE);
+	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
+		g_autoptr(FuChunk) chk = fu_chunk_array_index(chunks, i, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(chk);
+		total += fu_chunk_get_data_sz(chk);
+	}
+	g_print("chunks=%u index=%.3fms ",
+		fu_chunk_array_length(chunks),
+		g_timer_elapsed(timer, NULL) * 1000.f);
+	g_assert_cmpint(total, ==, buf->len);
 }
 
 static void
@@ -3063,6 +3340,142 @@ fu_firmware_new_from_gtypes_func(void)
 	g_assert_null(firmware3);
 }
 
+static void
+fu_firmware_detect_gtypes_func(void)
+{
+	gboolean ret;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuFirmware) firmware = fu_dfuse_firmware_new();
+	g_autoptr(GArray) gtypes = g_array_new(FALSE, FALSE, sizeof(GType));
+	g_autoptr(GArray) gtypes_ranked = NULL;
+	g_autoptr(GBytes) fw = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	const GType gtypes_all[] = {FU_TYPE_SREC_FIRMWARE,
+				    FU_TYPE_OPROM_FIRMWARE,
+				    FU_TYPE_DFU_FIRMWARE,
+				    FU_TYPE_FDT_FIRMWARE,
+				    FU_TYPE_DFUSE_FIRMWARE};
+
+	filename = g_test_build_filename(G_TEST_DIST, "tests", "dfuse.builder.xml", NULL);
+	ret = fu_firmware_build_from_filename(firmware, filename, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fw = fu_firmware_write(firmware, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fw);
+	stream = g_memory_input_stream_new_from_bytes(fw);
+
+	/* matched magic first, then unknown, and never the ones that cannot match */
+	g_array_append_vals(gtypes, gtypes_all, G_N_ELEMENTS(gtypes_all));
+	gtypes_ranked =
+	    fu_firmware_detect_gtypes(stream, 0x0, FWUPD_INSTALL_FLAG_NO_SEARCH, gtypes, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(gtypes_ranked);
+	g_assert_cmpint(gtypes_ranked->len, ==, 3);
+	g_assert_cmpint(g_array_index(gtypes_ranked, GType, 0), ==, FU_TYPE_DFUSE_FIRMWARE);
+	g_assert_cmpint(g_array_index(gtypes_ranked, GType, 1), ==, FU_TYPE_SREC_FIRMWARE);
+	g_assert_cmpint(g_array_index(gtypes_ranked, GType, 2), ==, FU_TYPE_DFU_FIRMWARE);
+}
+
+static void
+fu_firmware_detect_gtypes_performance_func(void)
+{
+	gdouble elapsed_all = 0.f;
+	gdouble elapsed_detect = 0.f;
+	guint attempts_all = 0;
+	guint attempts_detect = 0;
+	g_autoptr(GArray) gtypes = g_array_new(FALSE, FALSE, sizeof(GType));
+	g_autoptr(GPtrArray) blobs = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+	g_autoptr(GTimer) timer = g_timer_new();
+	struct {
+		GType gtype;
+		const gchar *xml_fn;
+	} map[] = {
+	    {FU_TYPE_SREC_FIRMWARE, "srec.builder.xml"},
+	    {FU_TYPE_IHEX_FIRMWARE, "ihex.builder.xml"},
+	    {FU_TYPE_CAB_FIRMWARE, "cab.builder.xml"},
+	    {FU_TYPE_DFUSE_FIRMWARE, "dfuse.builder.xml"},
+	    {FU_TYPE_PEFILE_FIRMWARE, "pefile.builder.xml"},
+	    {FU_TYPE_FDT_FIRMWARE, "fdt.builder.xml"},
+	    {FU_TYPE_FMAP_FIRMWARE, "fmap.builder.xml"},
+	    {FU_TYPE_EDID, "edid.builder.xml"},
+	    {FU_TYPE_EFI_VOLUME, "efi-volume.builder.xml"},
+	    {FU_TYPE_IFD_FIRMWARE, "ifd.builder.xml"},
+	    {FU_TYPE_IFWI_CPD_FIRMWARE, "ifwi-cpd.builder.xml"},
+	    {FU_TYPE_IFWI_FPT_FIRMWARE, "ifwi-fpt.builder.xml"},
+	    {FU_TYPE_OPROM_FIRMWARE, "oprom.builder.xml"},
+	};
+
+	/* build the corpus */
+	for (guint i = 0; i < G_N_ELEMENTS(map); i++) {
+		gboolean ret;
+		g_autofree gchar *filename = NULL;
+		g_autoptr(FuFirmware) firmware = g_object_new(map[i].gtype, NULL);
+		g_autoptr(GBytes) blob = NULL;
+		g_autoptr(GError) error = NULL;
+
+		filename = g_test_build_filename(G_TEST_DIST, "tests", map[i].xml_fn, NULL);
+		ret = fu_firmware_build_from_filename(firmware, filename, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+		blob = fu_firmware_write(firmware, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(blob);
+		g_ptr_array_add(blobs, g_steal_pointer(&blob));
+		g_array_append_val(gtypes, map[i].gtype);
+	}
+
+	for (guint i = 0; i < blobs->len; i++) {
+		GBytes *blob = g_ptr_array_index(blobs, i);
+		g_autoptr(GArray) gtypes_ranked = NULL;
+		g_autoptr(GError) error = NULL;
+		g_autoptr(GInputStream) stream = g_memory_input_stream_new_from_bytes(blob);
+
+		/* try every GType in turn */
+		g_timer_reset(timer);
+		for (guint j = 0; j < gtypes->len; j++) {
+			GType gtype = g_array_index(gtypes, GType, j);
+			g_autoptr(FuFirmware) firmware = g_object_new(gtype, NULL);
+			attempts_all++;
+			if (fu_firmware_parse_stream(firmware,
+						     stream,
+						     0x0,
+						     FWUPD_INSTALL_FLAG_NO_SEARCH,
+						     NULL))
+				break;
+		}
+		elapsed_all += g_timer_elapsed(timer, NULL);
+
+		/* only the ranked candidates */
+		g_timer_reset(timer);
+		gtypes_ranked = fu_firmware_detect_gtypes(stream,
+							  0x0,
+							  FWUPD_INSTALL_FLAG_NO_SEARCH,
+							  gtypes,
+							  &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(gtypes_ranked);
+		for (guint j = 0; j < gtypes_ranked->len; j++) {
+			GType gtype = g_array_index(gtypes_ranked, GType, j);
+			g_autoptr(FuFirmware) firmware = g_object_new(gtype, NULL);
+			attempts_detect++;
+			if (fu_firmware_parse_stream(firmware,
+						     stream,
+						     0x0,
+						     FWUPD_INSTALL_FLAG_NO_SEARCH,
+						     NULL)) {
+				g_assert_cmpint(gtype, ==, map[i].gtype);
+				break;
+			}
+		}
+		elapsed_detect += g_timer_elapsed(timer, NULL);
+	}
+	g_print("all=%.3fms (%u) ", elapsed_all * 1000.f, attempts_all);
+	g_print("detect=%.3fms (%u) ", elapsed_detect * 1000.f, attempts_detect);
+	g_assert_cmpint(attempts_detect, <, attempts_all);
+}
+
 static void
 fu_firmware_csv_func(void)
 {
@@ -4646,6 +5059,84 @@ fu_progress_child_finished(void)
 	fu_progress_step_done(progress);
 }
 
+static void
+fu_mapped_input_stream_func(void)
+{
+	gboolean ret;
+	const guint8 *buf;
+	GBytes *blob;
+	g_autofree gchar *fn = NULL;
+	g_autoptr(FuFirmware) firmware = fu_firmware_new();
+	g_autoptr(FuFirmware) img = fu_firmware_new();
+	g_autoptr(GBytes) blob_img = NULL;
+	g_autoptr(GBytes) blob_partial = NULL;
+	g_autoptr(GBytes) blob_slice = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GInputStream) stream_fw = NULL;
+	g_autoptr(GInputStream) stream_partial = NULL;
+	g_autoptr(GInputStream) stream_read = NULL;
+
+	/* files are only mapped when asked, as removable media might go away */
+	fn = g_test_build_filename(G_TEST_DIST, "tests", "dfu.builder.xml", NULL);
+	g_assert_nonnull(fn);
+	stream_read = fu_input_stream_from_path(fn, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(stream_read);
+	g_assert_false(FU_IS_MAPPED_INPUT_STREAM(stream_read));
+	stream = fu_input_stream_from_path_mapped(fn, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(stream);
+	g_assert_true(FU_IS_MAPPED_INPUT_STREAM(stream));
+	blob = fu_mapped_input_stream_get_bytes(FU_MAPPED_INPUT_STREAM(stream));
+	g_assert_cmpint(g_bytes_get_size(blob), ==, 216);
+	buf = g_bytes_get_data(blob, NULL);
+
+	/* reading is a view into the mapping, not a copy */
+	blob_slice = fu_input_stream_read_bytes(stream, 10, 20, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_slice);
+	g_assert_cmpint(g_bytes_get_size(blob_slice), ==, 20);
+	g_assert_true(g_bytes_get_data(blob_slice, NULL) == buf + 10);
+
+	/* ...and the same for a partial stream, truncated at the end */
+	stream_partial = fu_partial_input_stream_new(stream, 4, 200);
+	blob_partial = fu_input_stream_read_bytes(stream_partial, 2, G_MAXSIZE, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_partial);
+	g_assert_cmpint(g_bytes_get_size(blob_partial), ==, 198);
+	g_assert_true(g_bytes_get_data(blob_partial, NULL) == buf + 6);
+
+	/* out of range still fails */
+	g_clear_pointer(&blob_partial, g_bytes_unref);
+	blob_partial = fu_input_stream_read_bytes(stream_partial, 0x1000, G_MAXSIZE, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL);
+	g_assert_null(blob_partial);
+	g_clear_error(&error);
+
+	/* firmware parsed from a mapped stream uses the mapping too */
+	ret = fu_firmware_parse_stream(firmware, stream, 0x0, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	stream_fw = fu_firmware_get_stream(firmware, &error);
+	g_assert_no_error(error);
+	g_assert_true(FU_IS_MAPPED_INPUT_STREAM(stream_fw));
+
+	/* image bytes are a view into the parent */
+	fu_firmware_set_id(img, "payload");
+	ret = fu_firmware_set_stream(img, stream_partial, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_firmware_add_image_full(firmware, img, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	blob_img = fu_firmware_get_image_by_id_bytes(firmware, "payload", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(blob_img);
+	g_assert_cmpint(g_bytes_get_size(blob_img), ==, 200);
+	g_assert_true(g_bytes_get_data(blob_img, NULL) == buf + 4);
+}
+
 static void
 fu_partial_input_stream_func(void)
 {
@@ -5074,6 +5565,95 @@ fu_efi_lz77_decompressor_func(void)
 	g_assert_cmpstr(csum_legacy, ==, "40f7fbaff684a6bcf67c81b3079422c2529741e1");
 }
 
+static void
+fu_input_stream_checksums_func(void)
+{
+	const GChecksumType checksum_types[] = {G_CHECKSUM_SHA1,
+						G_CHECKSUM_SHA256,
+						G_CHECKSUM_SHA384};
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GBytes) blob_small = g_bytes_new_static("12345678", 8);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GInputStream) stream_small = g_memory_input_stream_new_from_bytes(blob_small);
+	g_autoptr(GPtrArray) checksums = NULL;
+	g_autoptr(GPtrArray) checksums_small = NULL;
+
+	/* large enough to be hashed on threads, and not a multiple of the chunk size */
+	fu_byte_array_set_size(buf, (6 * 1024 * 1024) + 123, 0x00);
+	for (guint i = 0; i + 4 <= buf->len; i += 4)
+		fu_memwrite_uint32(buf->data + i, g_random_int(), G_LITTLE_ENDIAN);
+	blob = g_bytes_new(buf->data, buf->len);
+	stream = g_memory_input_stream_new_from_bytes(blob);
+	checksums = fu_input_stream_compute_checksums(stream,
+						      checksum_types,
+						      G_N_ELEMENTS(checksum_types),
+						      &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(checksums);
+	g_assert_cmpint(checksums->len, ==, G_N_ELEMENTS(checksum_types));
+	for (guint i = 0; i < G_N_ELEMENTS(checksum_types); i++) {
+		g_autofree gchar *csum = g_compute_checksum_for_bytes(checksum_types[i], blob);
+		g_assert_cmpstr(g_ptr_array_index(checksums, i), ==, csum);
+	}
+
+	/* hashed inline */
+	checksums_small = fu_input_stream_compute_checksums(stream_small,
+							    checksum_types,
+							    G_N_ELEMENTS(checksum_types),
+							    &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(checksums_small);
+	g_assert_cmpint(checksums_small->len, ==, G_N_ELEMENTS(checksum_types));
+	for (guint i = 0; i < G_N_ELEMENTS(checksum_types); i++) {
+		g_autofree gchar *csum =
+		    g_compute_checksum_for_bytes(checksum_types[i], blob_small);
+		g_assert_cmpstr(g_ptr_array_index(checksums_small, i), ==, csum);
+	}
+}
+
+static void
+fu_input_stream_checksums_performance_func(void)
+{
+	const GChecksumType checksum_types[] = {G_CHECKSUM_SHA1,
+						G_CHECKSUM_SHA256,
+						G_CHECKSUM_SHA384};
+	g_autoptr(GByteArray) buf = g_byte_array_new();
+	g_autoptr(GBytes) blob = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GPtrArray) checksums = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* 64MiB payload */
+	fu_byte_array_set_size(buf, 64 * 1024 * 1024, 0x00);
+	for (guint i = 0; i < buf->len; i += 4)
+		fu_memwrite_uint32(buf->data + i, g_random_int(), G_LITTLE_ENDIAN);
+	blob = g_bytes_new(buf->data, buf->len);
+	stream = g_memory_input_stream_new_from_bytes(blob);
+
+	/* one pass per digest */
+	g_timer_reset(timer);
+	for (guint i = 0; i < G_N_ELEMENTS(checksum_types); i++) {
+		g_autofree gchar *csum =
+		    fu_input_stream_compute_checksum(stream, checksum_types[i], &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(csum);
+	}
+	g_print("serial=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* one pass for all digests */
+	g_timer_reset(timer);
+	checksums = fu_input_stream_compute_checksums(stream,
+						      checksum_types,
+						      G_N_ELEMENTS(checksum_types),
+						      &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(checksums);
+	g_print("multi=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+}
+
 static void
 fu_input_stream_func(void)
 {
@@ -5285,6 +5865,69 @@ fu_plugin_struct_wrapped_func(void)
 	g_assert_false(ret);
 }
 
+static void
+fu_plugin_struct_view_func(void)
+{
+	gboolean ret;
+	FuStructSelfTestView st_view = {0};
+	FuStructSelfTestView st_base_view = {0};
+	FuStructSelfTestWrappedView st_wrapped_view = {0};
+	g_autofree gchar *oem_table_id = NULL;
+	g_autoptr(GByteArray) st = fu_struct_self_test_new();
+	g_autoptr(GByteArray) st_wrapped = fu_struct_self_test_wrapped_new();
+	g_autoptr(GError) error = NULL;
+
+	/* getters without copying */
+	fu_struct_self_test_set_revision(st, 0xFF);
+	ret = fu_struct_self_test_set_oem_table_id(st, "X", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_struct_self_test_view_init(&st_view, st->data, st->len, 0x0, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_true(st_view.data == st->data);
+	g_assert_cmpint(fu_struct_self_test_view_get_revision(&st_view), ==, 0xFF);
+	g_assert_cmpint(fu_struct_self_test_view_get_length(&st_view), ==, 51);
+	oem_table_id = fu_struct_self_test_view_get_oem_table_id(&st_view);
+	g_assert_cmpstr(oem_table_id, ==, "X");
+
+	/* nested */
+	fu_struct_self_test_wrapped_set_more(st_wrapped, 0x12);
+	ret = fu_struct_self_test_wrapped_view_init(&st_wrapped_view,
+						    st_wrapped->data,
+						    st_wrapped->len,
+						    0x0,
+						    &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpint(fu_struct_self_test_wrapped_view_get_more(&st_wrapped_view), ==, 0x12);
+	st_base_view = fu_struct_self_test_wrapped_view_get_base(&st_wrapped_view);
+	g_assert_cmpint(fu_struct_self_test_view_get_length(&st_base_view), ==, 51);
+
+	/* too small */
+	ret = fu_struct_self_test_view_init(&st_view, st->data, st->len, 0x1, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_READ);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* failing signature */
+	st->data[0] = 0xFF;
+	ret = fu_struct_self_test_view_init(&st_view, st->data, st->len, 0x0, &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+	g_clear_error(&error);
+
+	/* failing nested signature */
+	st_wrapped->data[FU_STRUCT_SELF_TEST_WRAPPED_OFFSET_BASE] = 0xFF;
+	ret = fu_struct_self_test_wrapped_view_init(&st_wrapped_view,
+						    st_wrapped->data,
+						    st_wrapped->len,
+						    0x0,
+						    &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_DATA);
+	g_assert_false(ret);
+}
+
 static void
 fu_efi_load_option_func(void)
 {
@@ -5339,11 +5982,18 @@ main(int argc, char **argv)
 
 	g_test_add_func("/fwupd/efi-lz77{decompressor}", fu_efi_lz77_decompressor_func);
 	g_test_add_func("/fwupd/input-stream", fu_input_stream_func);
+	g_test_add_func("/fwupd/input-stream{checksums}", fu_input_stream_checksums_func);
+	if (g_test_slow()) {
+		g_test_add_func("/fwupd/input-stream{checksums-performance}",
+				fu_input_stream_checksums_performance_func);
+	}
 	g_test_add_func("/fwupd/input-stream{chunkify}", fu_input_stream_chunkify_func);
 	g_test_add_func("/fwupd/partial-input-stream", fu_partial_input_stream_func);
+	g_test_add_func("/fwupd/mapped-input-stream", fu_mapped_input_stream_func);
 	g_test_add_func("/fwupd/composite-input-stream", fu_composite_input_stream_func);
 	g_test_add_func("/fwupd/struct", fu_plugin_struct_func);
 	g_test_add_func("/fwupd/struct{wrapped}", fu_plugin_struct_wrapped_func);
+	g_test_add_func("/fwupd/struct{view}", fu_plugin_struct_view_func);
 	g_test_add_func("/fwupd/plugin{quirks-append}", fu_plugin_quirks_append_func);
 	g_test_add_func("/fwupd/string{password-mask}", fu_strpassmask_func);
 	g_test_add_func("/fwupd/lzma", fu_lzma_func);
@@ -5376,13 +6026,22 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/plugin{fdt}", fu_plugin_fdt_func);
 	g_test_add_func("/fwupd/plugin{quirks-performance}", fu_plugin_quirks_performance_func);
 	g_test_add_func("/fwupd/plugin{quirks-device}", fu_plugin_quirks_device_func);
+	g_test_add_func("/fwupd/plugin{quirks-cache}", fu_plugin_quirks_cache_func);
 	g_test_add_func("/fwupd/backend", fu_backend_func);
 	g_test_add_func("/fwupd/chunk", fu_chunk_func);
 	g_test_add_func("/fwupd/chunks", fu_chunk_array_func);
+	g_test_add_func("/fwupd/chunks{stream}", fu_chunk_array_stream_func);
+	if (g_test_slow()) {
+		g_test_add_func("/fwupd/chunks{stream-performance}",
+				fu_chunk_array_stream_performance_func);
+	}
 	g_test_add_func("/fwupd/common{align-up}", fu_common_align_up_func);
 	g_test_add_func("/fwupd/volume{gpt-type}", fu_volume_gpt_type_func);
 	g_test_add_func("/fwupd/common{byte-array}", fu_common_byte_array_func);
 	g_test_add_func("/fwupd/common{crc}", fu_common_crc_func);
+	g_test_add_func("/fwupd/common{crc-tables}", fu_common_crc_tables_func);
+	if (g_test_slow())
+		g_test_add_func("/fwupd/common{crc-performance}", fu_common_crc_performance_func);
 	g_test_add_func("/fwupd/common{string-append-kv}", fu_string_append_func);
 	g_test_add_func("/fwupd/common{version-guess-format}", fu_version_guess_format_func);
 	g_test_add_func("/fwupd/common{strtoull}", fu_strtoull_func);
@@ -5433,6 +6092,11 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/firmware{builder-round-trip}", fu_firmware_builder_round_trip_func);
 	g_test_add_func("/fwupd/firmware{fmap}", fu_firmware_fmap_func);
 	g_test_add_func("/fwupd/firmware{gtypes}", fu_firmware_new_from_gtypes_func);
+	g_test_add_func("/fwupd/firmware{detect-gtypes}", fu_firmware_detect_gtypes_func);
+	if (g_test_slow()) {
+		g_test_add_func("/fwupd/firmware{detect-gtypes-performance}",
+				fu_firmware_detect_gtypes_performance_func);
+	}
 	g_test_add_func("/fwupd/archive{invalid}", fu_archive_invalid_func);
 	g_test_add_func("/fwupd/archive{cab}", fu_archive_cab_func);
 	g_test_add_func("/fwupd/device", fu_device_func);
@@ -5449,6 +6113,7 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/device{incorporate-descendant}",
 			fu_device_incorporate_descendant_func);
 	g_test_add_func("/fwupd/device{poll}", fu_device_poll_func);
+	g_test_add_func("/fwupd/usb-device{transfer-chunks}", fu_usb_device_transfer_chunks_func);
 	g_test_add_func("/fwupd/device-locker{success}", fu_device_locker_func);
 	g_test_add_func("/fwupd/device-locker{fail}", fu_device_locker_fail_func);
 	g_test_add_func("/fwupd/device{name}", fu_device_name_func);
@@ -68,14 +68,13 @@ fu_smbios_setup_from_data(FuSmbios *self, const guint8 *buf, gsize bufsz, GError
 	for (gsize i = 0; i < bufsz; i++) {
 		FuSmbiosItem *item;
 		guint8 length;
-		g_autoptr(FuStructSmbiosStructure) st_str = NULL;
+		FuStructSmbiosStructureView st_str = {0};
 
 		/* sanity check */
-		st_str = fu_struct_smbios_structure_parse(buf, bufsz, i, error);
-		if (st_str == NULL)
+		if (!fu_struct_smbios_structure_view_init(&st_str, buf, bufsz, i, error))
 			return FALSE;
-		length = fu_struct_smbios_structure_get_length(st_str);
-		if (length < st_str->len) {
+		length = fu_struct_smbios_structure_view_get_length(&st_str);
+		if (length < FU_STRUCT_SMBIOS_STRUCTURE_SIZE) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
@@ -94,8 +93,8 @@ fu_smbios_setup_from_data(FuSmbios *self, const guint8 *buf, gsize bufsz, GError
 
 		/* create a new result */
 		item = g_new0(FuSmbiosItem, 1);
-		item->type = fu_struct_smbios_structure_get_type(st_str);
-		item->handle = fu_struct_smbios_structure_get_handle(st_str);
+		item->type = fu_struct_smbios_structure_view_get_type(&st_str);
+		item->handle = fu_struct_smbios_structure_view_get_handle(&st_str);
 		item->buf = g_byte_array_sized_new(length);
 		item->strings = g_ptr_array_new_with_free_func(g_free);
 		g_byte_array_append(item->buf, buf + i, length);
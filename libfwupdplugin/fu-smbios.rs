@@ -33,7 +33,7 @@ struct FuStructSmbiosEp64 {
     structure_table_addr: u64le,
 }
 
-#[derive(New, Parse)]
+#[derive(New, View)]
 struct FuStructSmbiosStructure {
     type: u8,
     length: u8,
@@ -1075,6 +1075,369 @@ fu_usb_device_get_dev(FuUsbDevice *device)
 	return priv->usb_device;
 }
 
+#ifdef HAVE_GUSB
+typedef struct {
+	FuUsbDevice *self;
+	FuChunkArray *chunks;
+	guint8 endpoint;
+	gboolean interrupt;
+	guint queue_depth;
+	guint timeout;
+	FuUsbDeviceTransferFunc func;
+	gpointer user_data;
+	FuProgress *progress;
+	GCancellable *cancellable;
+	guint idx_next; /* next chunk to submit */
+	guint pending;	/* transfers in flight */
+	GError *error;	/* the first error */
+} FuUsbDeviceTransferHelper;
+
+typedef struct {
+	FuUsbDeviceTransferHelper *helper;
+	FuChunk *chk;
+} FuUsbDeviceTransferItem;
+
+static void
+fu_usb_device_transfer_helper_set_error(FuUsbDeviceTransferHelper *helper, GError *error)
+{
+	if (helper->error != NULL) {
+		g_error_free(error);
+		return;
+	}
+	helper->error = error;
+	g_cancellable_cancel(helper->cancellable);
+}
+
+/* called when a transfer has completed */
+static gboolean
+fu_usb_device_transfer_done(FuUsbDeviceTransferHelper *helper,
+			    FuChunk *chk,
+			    gsize actual_length,
+			    GError **error)
+{
+	if (actual_length != fu_chunk_get_data_sz(chk)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "only wrote 0x%x of 0x%x bytes @0x%x",
+			    (guint)actual_length,
+			    (guint)fu_chunk_get_data_sz(chk),
+			    (guint)fu_chunk_get_address(chk));
+		return FALSE;
+	}
+	if (helper->func != NULL && !helper->func(helper->self, chk, helper->user_data, error))
+		return FALSE;
+	if (helper->progress != NULL)
+		fu_progress_step_done(helper->progress);
+	return TRUE;
+}
+
+static void fu_usb_device_transfer_submit(FuUsbDeviceTransferHelper *helper);
+
+static void
+fu_usb_device_transfer_cb(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	FuUsbDeviceTransferItem *item = (FuUsbDeviceTransferItem *)user_data;
+	FuUsbDeviceTransferHelper *helper = item->helper;
+	gssize actual_length;
+	g_autoptr(FuChunk) chk = item->chk;
+	g_autoptr(GError) error_local = NULL;
+
+	g_free(item);
+	helper->pending--;
+	if (helper->interrupt) {
+		actual_length = g_usb_device_interrupt_transfer_finish(G_USB_DEVICE(source_object),
+								       res,
+								       &error_local);
+	} else {
+		actual_length = g_usb_device_bulk_transfer_finish(G_USB_DEVICE(source_object),
+								  res,
+								  &error_local);
+	}
+
+	/* already failed, so this is probably just G_USB_DEVICE_ERROR_CANCELLED */
+	if (helper->error != NULL)
+		return;
+	if (actual_length < 0) {
+		fu_error_convert(&error_local);
+		g_prefix_error(&error_local,
+			       "failed to transfer @0x%x: ",
+			       (guint)fu_chunk_get_address(chk));
+		fu_usb_device_transfer_helper_set_error(helper, g_steal_pointer(&error_local));
+		return;
+	}
+	if (!fu_usb_device_transfer_done(helper, chk, actual_length, &error_local)) {
+		fu_usb_device_transfer_helper_set_error(helper, g_steal_pointer(&error_local));
+		return;
+	}
+
+	/* a slot is free */
+	fu_usb_device_transfer_submit(helper);
+}
+
+/* submit as many transfers as the queue depth allows */
+static void
+fu_usb_device_transfer_submit(FuUsbDeviceTransferHelper *helper)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(helper->self);
+
+	while (helper->error == NULL && helper->pending < helper->queue_depth &&
+	       helper->idx_next < fu_chunk_array_length(helper->chunks)) {
+		FuUsbDeviceTransferItem *item;
+		guint8 *data;
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(FuChunk) chk = NULL;
+
+		chk = fu_chunk_array_index(helper->chunks, helper->idx_next, &error_local);
+		if (chk == NULL) {
+			fu_usb_device_transfer_helper_set_error(helper,
+								g_steal_pointer(&error_local));
+			return;
+		}
+		helper->idx_next++;
+		helper->pending++;
+		item = g_new0(FuUsbDeviceTransferItem, 1);
+		item->helper = helper;
+		item->chk = g_steal_pointer(&chk);
+		data = (guint8 *)fu_chunk_get_data(item->chk);
+		if (helper->interrupt) {
+			g_usb_device_interrupt_transfer_async(priv->usb_device,
+							      helper->endpoint,
+							      data,
+							      fu_chunk_get_data_sz(item->chk),
+							      helper->timeout,
+							      helper->cancellable,
+							      fu_usb_device_transfer_cb,
+							      item);
+		} else {
+			g_usb_device_bulk_transfer_async(priv->usb_device,
+							 helper->endpoint,
+							 data,
+							 fu_chunk_get_data_sz(item->chk),
+							 helper->timeout,
+							 helper->cancellable,
+							 fu_usb_device_transfer_cb,
+							 item);
+		}
+	}
+}
+
+/* one transfer at a time, as used for emulation */
+static gboolean
+fu_usb_device_transfer_chunks_sync(FuUsbDeviceTransferHelper *helper, GError **error)
+{
+	FuUsbDevicePrivate *priv = GET_PRIVATE(helper->self);
+
+	for (guint i = 0; i < fu_chunk_array_length(helper->chunks); i++) {
+		gboolean ret;
+		gsize actual_length = 0;
+		g_autoptr(FuChunk) chk = NULL;
+
+		chk = fu_chunk_array_index(helper->chunks, i, error);
+		if (chk == NULL)
+			return FALSE;
+		if (helper->interrupt) {
+			ret = g_usb_device_interrupt_transfer(priv->usb_device,
+							      helper->endpoint,
+							      (guint8 *)fu_chunk_get_data(chk),
+							      fu_chunk_get_data_sz(chk),
+							      &actual_length,
+							      helper->timeout,
+							      NULL,
+							      error);
+		} else {
+			ret = g_usb_device_bulk_transfer(priv->usb_device,
+							 helper->endpoint,
+							 (guint8 *)fu_chunk_get_data(chk),
+							 fu_chunk_get_data_sz(chk),
+							 &actual_length,
+							 helper->timeout,
+							 NULL,
+							 error);
+		}
+		if (!ret) {
+			fu_error_convert(error);
+			g_prefix_error(error,
+				       "failed to transfer @0x%x: ",
+				       (guint)fu_chunk_get_address(chk));
+			return FALSE;
+		}
+		if (!fu_usb_device_transfer_done(helper, chk, actual_length, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+#endif
+
+static gboolean
+fu_usb_device_transfer_chunks(FuUsbDevice *self,
+			      gboolean interrupt,
+			      guint8 endpoint,
+			      FuChunkArray *chunks,
+			      guint queue_depth,
+			      guint timeout,
+			      FuUsbDeviceTransferFunc func,
+			      gpointer user_data,
+			      FuProgress *progress,
+			      GError **error)
+{
+#ifdef HAVE_GUSB
+	FuUsbDevicePrivate *priv = GET_PRIVATE(self);
+	g_autoptr(GCancellable) cancellable = g_cancellable_new();
+	g_autoptr(GMainContext) context = NULL;
+	FuUsbDeviceTransferHelper helper = {
+	    .self = self,
+	    .chunks = chunks,
+	    .endpoint = endpoint,
+	    .interrupt = interrupt,
+	    .queue_depth = queue_depth,
+	    .timeout = timeout,
+	    .func = func,
+	    .user_data = user_data,
+	    .progress = progress,
+	    .cancellable = cancellable,
+	};
+
+	/* not open */
+	if (priv->usb_device == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_SUPPORTED,
+				    "no GUsbDevice");
+		return FALSE;
+	}
+
+	/* progress */
+	if (progress != NULL) {
+		fu_progress_set_id(progress, G_STRLOC);
+		fu_progress_set_steps(progress, fu_chunk_array_length(chunks));
+	}
+
+	/* the emulation only records and replays synchronous transfers */
+	if (queue_depth <= 1 || fu_device_has_flag(FU_DEVICE(self), FWUPD_DEVICE_FLAG_EMULATED) ||
+	    fu_device_has_flag(FU_DEVICE(self), FWUPD_DEVICE_FLAG_EMULATION_TAG))
+		return fu_usb_device_transfer_chunks_sync(&helper, error);
+
+	/* the completions are dispatched to a private context so no other sources are run */
+	context = g_main_context_new();
+	g_main_context_push_thread_default(context);
+	fu_usb_device_transfer_submit(&helper);
+	while (helper.pending > 0)
+		g_main_context_iteration(context, TRUE);
+	g_main_context_pop_thread_default(context);
+	if (helper.error != NULL) {
+		g_propagate_error(error, helper.error);
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "GUsb support is unavailable");
+	return FALSE;
+#endif
+}
+
+/**
+ * fu_usb_device_bulk_transfer_chunks:
+ * @self: a #FuUsbDevice
+ * @endpoint: the OUT endpoint, e.g. `0x01`
+ * @chunks: a #FuChunkArray
+ * @queue_depth: the maximum number of transfers in flight, e.g. 4
+ * @timeout: timeout for each transfer in ms
+ * @func: (scope call) (nullable): optional function called as each transfer completes
+ * @user_data: user data to pass to @func
+ * @progress: (nullable): optional #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends all the chunks to a bulk endpoint, keeping up to @queue_depth transfers submitted at
+ * once so that the bus is not idle while waiting for each transfer to complete.
+ *
+ * The next chunk is only read from @chunks when a transfer has completed, and if @func returns
+ * %FALSE then all the pending transfers are cancelled.
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_usb_device_bulk_transfer_chunks(FuUsbDevice *self,
+				   guint8 endpoint,
+				   FuChunkArray *chunks,
+				   guint queue_depth,
+				   guint timeout,
+				   FuUsbDeviceTransferFunc func,
+				   gpointer user_data,
+				   FuProgress *progress,
+				   GError **error)
+{
+	g_return_val_if_fail(FU_IS_USB_DEVICE(self), FALSE);
+	g_return_val_if_fail(FU_IS_CHUNK_ARRAY(chunks), FALSE);
+	g_return_val_if_fail(progress == NULL || FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fu_usb_device_transfer_chunks(self,
+					     FALSE,
+					     endpoint,
+					     chunks,
+					     queue_depth,
+					     timeout,
+					     func,
+					     user_data,
+					     progress,
+					     error);
+}
+
+/**
+ * fu_usb_device_interrupt_transfer_chunks:
+ * @self: a #FuUsbDevice
+ * @endpoint: the OUT endpoint, e.g. `0x01`
+ * @chunks: a #FuChunkArray
+ * @queue_depth: the maximum number of transfers in flight, e.g. 4
+ * @timeout: timeout for each transfer in ms
+ * @func: (scope call) (nullable): optional function called as each transfer completes
+ * @user_data: user data to pass to @func
+ * @progress: (nullable): optional #FuProgress
+ * @error: (nullable): optional return location for an error
+ *
+ * Sends all the chunks to an interrupt endpoint, keeping up to @queue_depth transfers submitted
+ * at once.
+ *
+ * See also: fu_usb_device_bulk_transfer_chunks()
+ *
+ * Returns: %TRUE for success
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_usb_device_interrupt_transfer_chunks(FuUsbDevice *self,
+					guint8 endpoint,
+					FuChunkArray *chunks,
+					guint queue_depth,
+					guint timeout,
+					FuUsbDeviceTransferFunc func,
+					gpointer user_data,
+					FuProgress *progress,
+					GError **error)
+{
+	g_return_val_if_fail(FU_IS_USB_DEVICE(self), FALSE);
+	g_return_val_if_fail(FU_IS_CHUNK_ARRAY(chunks), FALSE);
+	g_return_val_if_fail(progress == NULL || FU_IS_PROGRESS(progress), FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	return fu_usb_device_transfer_chunks(self,
+					     TRUE,
+					     endpoint,
+					     chunks,
+					     queue_depth,
+					     timeout,
+					     func,
+					     user_data,
+					     progress,
+					     error);
+}
+
 static void
 fu_usb_device_incorporate(FuDevice *self, FuDevice *donor)
 {
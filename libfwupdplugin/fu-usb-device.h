@@ -16,6 +16,7 @@
 #endif
 #endif
 
+#include "fu-chunk-array.h"
 #include "fu-plugin.h"
 #include "fu-udev-device.h"
 
@@ -26,6 +27,22 @@ struct _FuUsbDeviceClass {
 	FuDeviceClass parent_class;
 };
 
+/**
+ * FuUsbDeviceTransferFunc:
+ * @self: a #FuUsbDevice
+ * @chk: the #FuChunk that has been transferred
+ * @user_data: (closure): user data
+ * @error: (nullable): optional return location for an error
+ *
+ * The callback run as each transfer completes.
+ *
+ * Returns: %TRUE on success, or %FALSE to cancel the remaining transfers
+ */
+typedef gboolean (*FuUsbDeviceTransferFunc)(FuUsbDevice *self,
+					    FuChunk *chk,
+					    gpointer user_data,
+					    GError **error) G_GNUC_WARN_UNUSED_RESULT;
+
 FuUsbDevice *
 fu_usb_device_new(FuContext *ctx, GUsbDevice *usb_device) G_GNUC_NON_NULL(1);
 guint16
@@ -55,3 +72,24 @@ void
 fu_usb_device_set_open_retry_count(FuUsbDevice *self, guint open_retry_count) G_GNUC_NON_NULL(1);
 guint
 fu_usb_device_get_open_retry_count(FuUsbDevice *self) G_GNUC_NON_NULL(1);
+gboolean
+fu_usb_device_bulk_transfer_chunks(FuUsbDevice *self,
+				   guint8 endpoint,
+				   FuChunkArray *chunks,
+				   guint queue_depth,
+				   guint timeout,
+				   FuUsbDeviceTransferFunc func,
+				   gpointer user_data,
+				   FuProgress *progress,
+				   GError **error) G_GNUC_WARN_UNUSED_RESULT G_GNUC_NON_NULL(1, 3);
+gboolean
+fu_usb_device_interrupt_transfer_chunks(FuUsbDevice *self,
+					guint8 endpoint,
+					FuChunkArray *chunks,
+					guint queue_depth,
+					guint timeout,
+					FuUsbDeviceTransferFunc func,
+					gpointer user_data,
+					FuProgress *progress,
+					GError **error) G_GNUC_WARN_UNUSED_RESULT
+    G_GNUC_NON_NULL(1, 3);
@@ -144,6 +144,7 @@ class StructObj:
             "ParseInternal": Export.NONE,
             "New": Export.NONE,
             "ToString": Export.NONE,
+            "View": Export.NONE,
         }
 
     def c_method(self, suffix: str):
@@ -214,6 +215,11 @@ class StructObj:
             for item in self.items:
                 if item.constant and not (item.type == Type.U8 and item.multiplier):
                     item.add_private_export("Setters")
+        elif derive == "View":
+            self.add_private_export("ValidateInternal")
+            for item in self.items:
+                if item.struct_obj:
+                    item.struct_obj.add_private_export("View")
 
     def add_public_export(self, derive: str) -> None:
         # Getters and Setters are special as we do not want public exports of const
@@ -225,6 +231,12 @@ class StructObj:
             self.add_private_export(derive)
             self._exports[derive] = Export.PUBLIC
 
+        # nested views are returned by value
+        if derive == "View":
+            for item in self.items:
+                if item.struct_obj:
+                    item.struct_obj.add_public_export("View")
+
         # for convenience
         if derive in ["Parse", "ParseBytes", "ParseStream"]:
             self.add_public_export("Getters")
@@ -312,6 +324,10 @@ class StructItem:
     def c_setter(self):
         return self.obj.c_method("set_" + self.element_id)
 
+    @property
+    def c_view_getter(self):
+        return self.obj.c_method("view_get_" + self.element_id)
+
     @property
     def type_glib(self) -> str:
         if self.enum_obj:
@@ -426,6 +426,9 @@ fu_emmc_device_write_firmware(FuDevice *device,
 	chunks = fu_chunk_array_new_from_stream(stream, 0x00, sector_size, error);
 	if (chunks == NULL)
 		return FALSE;
+
+	/* read the image while the previous sectors are being programmed */
+	fu_chunk_array_set_prefetch(chunks, TRUE);
 	while (failure_cnt < 3) {
 		for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
 			g_autoptr(FuChunk) chk = NULL;
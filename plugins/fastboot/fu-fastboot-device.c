@@ -16,6 +16,7 @@
 #define FASTBOOT_EP_IN			   0x81
 #define FASTBOOT_EP_OUT			   0x01
 #define FASTBOOT_CMD_BUFSZ		   64 /* bytes */
+#define FASTBOOT_TRANSFER_QUEUE_DEPTH	   4
 
 struct _FuFastbootDevice {
 	FuUsbDevice parent_instance;
@@ -272,6 +273,28 @@ fu_fastboot_device_download(FuDevice *device, GBytes *fw, FuProgress *progress,
 	/* send the data in chunks */
 	fu_progress_set_status(progress, FWUPD_STATUS_DEVICE_WRITE);
 	chunks = fu_chunk_array_new_from_bytes(fw, 0x00, self->blocksz);
+
+	/* keep the bus busy if the device does not need time between each packet */
+	if (self->operation_delay == 0) {
+		if (!fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(self),
+							FASTBOOT_EP_OUT,
+							chunks,
+							FASTBOOT_TRANSFER_QUEUE_DEPTH,
+							FASTBOOT_TRANSACTION_TIMEOUT,
+							NULL,
+							NULL,
+							progress,
+							error)) {
+			g_prefix_error(error, "failed to do bulk transfer: ");
+			return FALSE;
+		}
+		return fu_fastboot_device_read(device,
+					       NULL,
+					       progress,
+					       FU_FASTBOOT_DEVICE_READ_FLAG_STATUS_POLL,
+					       error);
+	}
+
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, fu_chunk_array_length(chunks));
 	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
@@ -6,6 +6,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #ifdef HAVE_MTD_USER_H
 #include <mtd/mtd-user.h>
 #endif
@@ -255,9 +257,37 @@ fu_mtd_device_probe(FuDevice *device, GError **error)
 }
 
 static gboolean
-fu_mtd_device_erase(FuMtdDevice *self, GInputStream *stream, FuProgress *progress, GError **error)
+fu_mtd_device_erase_chunk(FuMtdDevice *self, FuChunk *chk, GError **error)
 {
 #ifdef HAVE_MTD_USER_H
+	struct erase_info_user erase = {0x0};
+
+	erase.start = fu_chunk_get_address(chk);
+	erase.length = fu_chunk_get_data_sz(chk);
+	if (!fu_udev_device_ioctl(FU_UDEV_DEVICE(self),
+				  2,
+				  (guint8 *)&erase,
+				  NULL,
+				  FU_MTD_DEVICE_IOCTL_TIMEOUT,
+				  error)) {
+		g_prefix_error(error, "failed to erase @0x%x: ", (guint)erase.start);
+		return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+#else
+	g_set_error_literal(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "Not supported as mtd-user.h is unavailable");
+	return FALSE;
+#endif
+}
+
+static gboolean
+fu_mtd_device_erase(FuMtdDevice *self, GInputStream *stream, FuProgress *progress, GError **error)
+{
 	g_autoptr(FuChunkArray) chunks = NULL;
 
 	chunks = fu_chunk_array_new_from_stream(stream, 0x0, self->erasesize, error);
@@ -270,36 +300,33 @@ fu_mtd_device_erase(FuMtdDevice *self, GInputStream *stream, FuProgress *progres
 
 	/* erase each chunk */
 	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
-		struct erase_info_user erase = {0x0};
 		g_autoptr(FuChunk) chk = NULL;
 
 		/* prepare chunk */
 		chk = fu_chunk_array_index(chunks, i, error);
 		if (chk == NULL)
 			return FALSE;
-		erase.start = fu_chunk_get_address(chk);
-		erase.length = fu_chunk_get_data_sz(chk);
-		if (!fu_udev_device_ioctl(FU_UDEV_DEVICE(self),
-					  2,
-					  (guint8 *)&erase,
-					  NULL,
-					  FU_MTD_DEVICE_IOCTL_TIMEOUT,
-					  error)) {
-			g_prefix_error(error, "failed to erase @0x%x: ", (guint)erase.start);
+		if (!fu_mtd_device_erase_chunk(self, chk, error))
 			return FALSE;
-		}
 		fu_progress_step_done(progress);
 	}
 
 	/* success */
 	return TRUE;
-#else
-	g_set_error_literal(error,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOT_SUPPORTED,
-			    "Not supported as mtd-user.h is unavailable");
-	return FALSE;
-#endif
+}
+
+static gboolean
+fu_mtd_device_write_chunk(FuMtdDevice *self, FuChunk *chk, GError **error)
+{
+	if (!fu_udev_device_pwrite(FU_UDEV_DEVICE(self),
+				   fu_chunk_get_address(chk),
+				   fu_chunk_get_data(chk),
+				   fu_chunk_get_data_sz(chk),
+				   error)) {
+		g_prefix_error(error, "failed to write @0x%x: ", (guint)fu_chunk_get_address(chk));
+		return FALSE;
+	}
+	return TRUE;
 }
 
 static gboolean
@@ -323,16 +350,8 @@ fu_mtd_device_write(FuMtdDevice *self, FuChunkArray *chunks, FuProgress *progres
 		chk = fu_chunk_array_index(chunks, i, error);
 		if (chk == NULL)
 			return FALSE;
-		if (!fu_udev_device_pwrite(FU_UDEV_DEVICE(self),
-					   fu_chunk_get_address(chk),
-					   fu_chunk_get_data(chk),
-					   fu_chunk_get_data_sz(chk),
-					   error)) {
-			g_prefix_error(error,
-				       "failed to write @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
+		if (!fu_mtd_device_write_chunk(self, chk, error))
 			return FALSE;
-		}
 		fu_progress_step_done(progress);
 	}
 
@@ -340,6 +359,39 @@ fu_mtd_device_write(FuMtdDevice *self, FuChunkArray *chunks, FuProgress *progres
 	return TRUE;
 }
 
+/* returns the current contents of the flash at the chunk address */
+static GBytes *
+fu_mtd_device_read_chunk(FuMtdDevice *self, FuChunk *chk, GError **error)
+{
+	g_autofree guint8 *buf = g_malloc0(fu_chunk_get_data_sz(chk));
+	if (!fu_udev_device_pread(FU_UDEV_DEVICE(self),
+				  fu_chunk_get_address(chk),
+				  buf,
+				  fu_chunk_get_data_sz(chk),
+				  error)) {
+		g_prefix_error(error, "failed to read @0x%x: ", (guint)fu_chunk_get_address(chk));
+		return NULL;
+	}
+	return g_bytes_new_take(g_steal_pointer(&buf), fu_chunk_get_data_sz(chk));
+}
+
+static gboolean
+fu_mtd_device_verify_chunk(FuMtdDevice *self, FuChunk *chk, GError **error)
+{
+	g_autoptr(GBytes) blob1 = NULL;
+	g_autoptr(GBytes) blob2 = NULL;
+
+	blob1 = fu_chunk_get_bytes(chk);
+	blob2 = fu_mtd_device_read_chunk(self, chk, error);
+	if (blob2 == NULL)
+		return FALSE;
+	if (!fu_bytes_compare(blob1, blob2, error)) {
+		g_prefix_error(error, "failed to verify @0x%x: ", (guint)fu_chunk_get_address(chk));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_mtd_device_verify(FuMtdDevice *self, FuChunkArray *chunks, FuProgress *progress, GError **error)
 {
@@ -349,34 +401,14 @@ fu_mtd_device_verify(FuMtdDevice *self, FuChunkArray *chunks, FuProgress *progre
 
 	/* verify each chunk */
 	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
-		g_autofree guint8 *buf = NULL;
 		g_autoptr(FuChunk) chk = NULL;
-		g_autoptr(GBytes) blob1 = NULL;
-		g_autoptr(GBytes) blob2 = NULL;
 
 		/* prepare chunk */
 		chk = fu_chunk_array_index(chunks, i, error);
 		if (chk == NULL)
 			return FALSE;
-		buf = g_malloc0(fu_chunk_get_data_sz(chk));
-		if (!fu_udev_device_pread(FU_UDEV_DEVICE(self),
-					  fu_chunk_get_address(chk),
-					  buf,
-					  fu_chunk_get_data_sz(chk),
-					  error)) {
-			g_prefix_error(error,
-				       "failed to read @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
+		if (!fu_mtd_device_verify_chunk(self, chk, error))
 			return FALSE;
-		}
-		blob1 = fu_chunk_get_bytes(chk);
-		blob2 = g_bytes_new_static(buf, fu_chunk_get_data_sz(chk));
-		if (!fu_bytes_compare(blob1, blob2, error)) {
-			g_prefix_error(error,
-				       "failed to verify @0x%x: ",
-				       (guint)fu_chunk_get_address(chk));
-			return FALSE;
-		}
 		fu_progress_step_done(progress);
 	}
 
@@ -416,6 +448,143 @@ fu_mtd_device_write_verify(FuMtdDevice *self,
 	return TRUE;
 }
 
+/* returns the indexes of the chunks that are different to what is already on the flash */
+static GArray *
+fu_mtd_device_get_dirty_chunks(FuMtdDevice *self,
+			       FuChunkArray *chunks,
+			       FuProgress *progress,
+			       GError **error)
+{
+	g_autoptr(GArray) dirty = g_array_new(FALSE, FALSE, sizeof(guint));
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, fu_chunk_array_length(chunks));
+
+	/* compare each chunk */
+	for (guint i = 0; i < fu_chunk_array_length(chunks); i++) {
+		g_autoptr(FuChunk) chk = NULL;
+		g_autoptr(GBytes) blob = NULL;
+
+		/* prepare chunk */
+		chk = fu_chunk_array_index(chunks, i, error);
+		if (chk == NULL)
+			return NULL;
+		blob = fu_mtd_device_read_chunk(self, chk, error);
+		if (blob == NULL)
+			return NULL;
+		if (memcmp(g_bytes_get_data(blob, NULL),
+			   fu_chunk_get_data(chk),
+			   fu_chunk_get_data_sz(chk)) != 0)
+			g_array_append_val(dirty, i);
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return g_steal_pointer(&dirty);
+}
+
+typedef gboolean (*FuMtdDeviceChunkFunc)(FuMtdDevice *self, FuChunk *chk, GError **error);
+
+static gboolean
+fu_mtd_device_foreach_dirty_chunk(FuMtdDevice *self,
+				  FuChunkArray *chunks,
+				  GArray *dirty,
+				  FuMtdDeviceChunkFunc func,
+				  FuProgress *progress,
+				  GError **error)
+{
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, dirty->len);
+
+	for (guint i = 0; i < dirty->len; i++) {
+		g_autoptr(FuChunk) chk = NULL;
+
+		/* prepare chunk */
+		chk = fu_chunk_array_index(chunks, g_array_index(dirty, guint, i), error);
+		if (chk == NULL)
+			return FALSE;
+		if (!func(self, chk, error))
+			return FALSE;
+		fu_progress_step_done(progress);
+	}
+
+	/* success */
+	return TRUE;
+}
+
+/* erase, write and verify only the erase blocks that have changed */
+static gboolean
+fu_mtd_device_write_differential(FuMtdDevice *self,
+				 GInputStream *stream,
+				 FuProgress *progress,
+				 GError **error)
+{
+	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(GArray) dirty = NULL;
+
+	chunks = fu_chunk_array_new_from_stream(stream,
+						0x0,
+						self->erasesize > 0 ? self->erasesize : 10 * 1024,
+						error);
+	if (chunks == NULL)
+		return FALSE;
+
+	/* progress */
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_GUESSED);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_READ, 25, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_ERASE, 25, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_WRITE, 35, NULL);
+	fu_progress_add_step(progress, FWUPD_STATUS_DEVICE_VERIFY, 15, NULL);
+
+	/* compare */
+	dirty = fu_mtd_device_get_dirty_chunks(self,
+					       chunks,
+					       fu_progress_get_child(progress),
+					       error);
+	if (dirty == NULL)
+		return FALSE;
+	fu_progress_step_done(progress);
+	g_info("%u of %u blocks need updating", dirty->len, fu_chunk_array_length(chunks));
+
+	/* erase */
+	if (self->erasesize > 0) {
+		if (!fu_mtd_device_foreach_dirty_chunk(self,
+						       chunks,
+						       dirty,
+						       fu_mtd_device_erase_chunk,
+						       fu_progress_get_child(progress),
+						       error))
+			return FALSE;
+	}
+	fu_progress_step_done(progress);
+
+	/* write */
+	if (!fu_mtd_device_foreach_dirty_chunk(self,
+					       chunks,
+					       dirty,
+					       fu_mtd_device_write_chunk,
+					       fu_progress_get_child(progress),
+					       error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* verify */
+	if (!fu_mtd_device_foreach_dirty_chunk(self,
+					       chunks,
+					       dirty,
+					       fu_mtd_device_verify_chunk,
+					       fu_progress_get_child(progress),
+					       error))
+		return FALSE;
+	fu_progress_step_done(progress);
+
+	/* success */
+	return TRUE;
+}
+
 static GBytes *
 fu_mtd_device_dump_firmware(FuDevice *device, FuProgress *progress, GError **error)
 {
@@ -477,6 +646,10 @@ fu_mtd_device_write_firmware(FuDevice *device,
 		return FALSE;
 	}
 
+	/* only touch the blocks that have changed */
+	if (fu_device_has_private_flag(device, FU_MTD_DEVICE_FLAG_DIFFERENTIAL_WRITE))
+		return fu_mtd_device_write_differential(self, stream, progress, error);
+
 	/* just one step required */
 	if (self->erasesize == 0)
 		return fu_mtd_device_write_verify(self, stream, progress, error);
@@ -543,6 +716,9 @@ fu_mtd_device_init(FuMtdDevice *self)
 	fu_device_add_icon(FU_DEVICE(self), "drive-harddisk-solidstate");
 	fu_udev_device_add_flag(FU_UDEV_DEVICE(self), FU_UDEV_DEVICE_FLAG_OPEN_READ);
 	fu_udev_device_add_flag(FU_UDEV_DEVICE(self), FU_UDEV_DEVICE_FLAG_OPEN_SYNC);
+	fu_device_register_private_flag(FU_DEVICE(self),
+					FU_MTD_DEVICE_FLAG_DIFFERENTIAL_WRITE,
+					"differential-write");
 }
 
 static void
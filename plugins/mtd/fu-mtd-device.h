@@ -10,3 +10,5 @@
 
 #define FU_TYPE_MTD_DEVICE (fu_mtd_device_get_type())
 G_DECLARE_FINAL_TYPE(FuMtdDevice, fu_mtd_device, FU, MTD_DEVICE, FuUdevDevice)
+
+#define FU_MTD_DEVICE_FLAG_DIFFERENTIAL_WRITE (1 << 0)
@@ -40,6 +40,7 @@ fu_mtd_plugin_constructed(GObject *obj)
 	FuContext *ctx = fu_plugin_get_context(plugin);
 	fu_context_add_quirk_key(ctx, "MtdMetadataOffset");
 	fu_context_add_quirk_key(ctx, "MtdMetadataSize");
+	fu_plugin_add_rule(plugin, FU_PLUGIN_RULE_DEVICE_BACKEND, "udev");
 	fu_plugin_add_device_udev_subsystem(plugin, "mtd");
 	fu_plugin_add_device_gtype(plugin, FU_TYPE_MTD_DEVICE);
 }
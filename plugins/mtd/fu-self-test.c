@@ -21,9 +21,12 @@ fu_test_mtd_device_func(void)
 	g_autoptr(FuProgress) progress = fu_progress_new(NULL);
 	g_autoptr(GByteArray) buf = g_byte_array_new();
 	g_autoptr(GBytes) fw2 = NULL;
+	g_autoptr(GBytes) fw3 = NULL;
+	g_autoptr(GBytes) fw4 = NULL;
 	g_autoptr(GBytes) fw = NULL;
 	g_autoptr(GError) error = NULL;
 	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GInputStream) stream3 = NULL;
 	g_autoptr(GRand) rand = g_rand_new_with_seed(0);
 	g_autoptr(GUdevClient) udev_client = g_udev_client_new(NULL);
 	g_autoptr(GUdevDevice) udev_device = NULL;
@@ -93,6 +96,29 @@ fu_test_mtd_device_func(void)
 	ret = fu_bytes_compare(fw, fw2, &error);
 	g_assert_no_error(error);
 	g_assert_true(ret);
+
+	/* change a few bytes and only write the blocks that are different */
+	buf->data[0x10] ^= 0xFF;
+	buf->data[0x234567] ^= 0xFF;
+	fw3 = g_bytes_new(buf->data, buf->len);
+	stream3 = g_memory_input_stream_new_from_bytes(fw3);
+	fu_device_add_private_flag(device, FU_MTD_DEVICE_FLAG_DIFFERENTIAL_WRITE);
+	fu_progress_reset(progress);
+	g_test_expect_message("FuDevice", G_LOG_LEVEL_INFO, "installing onto *");
+	g_test_expect_message("FuPluginMtd", G_LOG_LEVEL_INFO, "2 of * blocks need updating");
+	ret = fu_device_write_firmware(device, stream3, progress, FWUPD_INSTALL_FLAG_NONE, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_test_assert_expected_messages();
+
+	/* dump back */
+	fu_progress_reset(progress);
+	fw4 = fu_device_dump_firmware(device, progress, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(fw4);
+	ret = fu_bytes_compare(fw3, fw4, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
 #else
 	g_test_skip("no GUdev support");
 #endif
@@ -564,6 +564,7 @@ static void
 fu_pci_mei_plugin_constructed(GObject *obj)
 {
 	FuPlugin *plugin = FU_PLUGIN(obj);
+	fu_plugin_add_rule(plugin, FU_PLUGIN_RULE_REQUIRES_CPU, "intel");
 	fu_plugin_add_udev_subsystem(plugin, "pci");
 }
 
@@ -16,6 +16,9 @@
 #include "fu-redfish-smbios.h"
 #include "fu-redfish-smc-device.h"
 
+/* BMCs are typically low-powered, so only fetch a few inventory members at once */
+#define FU_REDFISH_BACKEND_PARALLEL_MAX 4
+
 struct _FuRedfishBackend {
 	FuBackend parent_instance;
 	gchar *hostname;
@@ -33,6 +36,7 @@ struct _FuRedfishBackend {
 	gint64 max_image_size; /* bytes */
 	GType device_gtype;
 	GHashTable *request_cache; /* str:GByteArray */
+	gchar *cache_dir;
 	CURLSH *curlsh;
 };
 
@@ -67,6 +71,7 @@ fu_redfish_backend_request_new(FuRedfishBackend *self)
 
 	/* set the cache location */
 	fu_redfish_request_set_cache(request, self->request_cache);
+	fu_redfish_request_set_cache_dir(request, self->cache_dir);
 	fu_redfish_request_set_curlsh(request, self->curlsh);
 
 	/* set up defaults */
@@ -140,14 +145,12 @@ fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 				       GError **error)
 {
 	JsonArray *members = json_object_get_array_member(collection, "Members");
-	for (guint i = 0; i < json_array_get_length(members); i++) {
-		JsonObject *json_obj;
-		JsonObject *member_id;
-		const gchar *member_uri;
-		g_autoptr(FuRedfishRequest) request = fu_redfish_backend_request_new(self);
+	g_autoptr(GPtrArray) paths = g_ptr_array_new();
+	g_autoptr(GPtrArray) requests = g_ptr_array_new_with_free_func(g_object_unref);
 
-		member_id = json_array_get_object_element(members, i);
-		member_uri = json_object_get_string_member(member_id, "@odata.id");
+	for (guint i = 0; i < json_array_get_length(members); i++) {
+		JsonObject *member_id = json_array_get_object_element(members, i);
+		const gchar *member_uri = json_object_get_string_member(member_id, "@odata.id");
 		if (member_uri == NULL) {
 			g_set_error_literal(error,
 					    FWUPD_ERROR,
@@ -155,14 +158,23 @@ fu_redfish_backend_coldplug_collection(FuRedfishBackend *self,
 					    "no @odata.id string");
 			return FALSE;
 		}
+		g_ptr_array_add(paths, (gpointer)member_uri);
+		g_ptr_array_add(requests, fu_redfish_backend_request_new(self));
+	}
 
-		/* create the device for the member */
-		if (!fu_redfish_request_perform(request,
-						member_uri,
-						FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
-						error))
-			return FALSE;
-		json_obj = fu_redfish_request_get_json_object(request);
+	/* fetch all members concurrently over the shared connections */
+	if (!fu_redfish_request_perform_multi(requests,
+					      paths,
+					      FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON |
+						  FU_REDFISH_REQUEST_PERFORM_FLAG_USE_ETAG_CACHE,
+					      FU_REDFISH_BACKEND_PARALLEL_MAX,
+					      error))
+		return FALSE;
+
+	/* create the device for each member, in the original order */
+	for (guint i = 0; i < requests->len; i++) {
+		FuRedfishRequest *request = g_ptr_array_index(requests, i);
+		JsonObject *json_obj = fu_redfish_request_get_json_object(request);
 		if (!fu_redfish_backend_coldplug_member(self, json_obj, error))
 			return FALSE;
 	}
@@ -195,7 +207,8 @@ fu_redfish_backend_coldplug_inventory(FuRedfishBackend *self, JsonObject *invent
 
 	if (!fu_redfish_request_perform(request,
 					collection_uri,
-					FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON,
+					FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON |
+					    FU_REDFISH_REQUEST_PERFORM_FLAG_USE_ETAG_CACHE,
 					error))
 		return FALSE;
 	json_obj = fu_redfish_request_get_json_object(request);
@@ -488,6 +501,7 @@ fu_redfish_backend_finalize(GObject *object)
 	FuRedfishBackend *self = FU_REDFISH_BACKEND(object);
 	g_hash_table_unref(self->request_cache);
 	curl_share_cleanup(self->curlsh);
+	g_free(self->cache_dir);
 	g_free(self->update_uri_path);
 	g_free(self->push_uri_path);
 	g_free(self->hostname);
@@ -514,7 +528,10 @@ fu_redfish_backend_class_init(FuRedfishBackendClass *klass)
 static void
 fu_redfish_backend_init(FuRedfishBackend *self)
 {
+	g_autofree gchar *cachedir = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+
 	self->use_https = TRUE;
+	self->cache_dir = g_build_filename(cachedir, "redfish", NULL);
 	self->device_gtype = FU_TYPE_REDFISH_DEVICE;
 	self->request_cache = g_hash_table_new_full(g_str_hash,
 						    g_str_equal,
@@ -16,7 +16,15 @@ struct _FuRedfishRequest {
 	glong status_code;
 	JsonParser *json_parser;
 	JsonObject *json_obj;
-	GHashTable *cache; /* nullable */
+	GHashTable *cache;   /* nullable */
+	gchar *cache_dir;    /* nullable */
+	gchar *cache_fn;     /* nullable, without extension */
+	GBytes *cache_blob;  /* nullable, the on-disk response for the ETag we sent */
+	gchar *etag;	     /* nullable, from the response headers */
+	gchar *path;	     /* of the current request */
+	gboolean from_cache; /* in-memory cache hit, so no transfer needed */
+	FuRedfishRequestPerformFlags flags;
+	struct curl_slist *headers;
 };
 
 G_DEFINE_TYPE(FuRedfishRequest, fu_redfish_request, G_TYPE_OBJECT)
@@ -138,37 +146,115 @@ fu_redfish_request_load_json(FuRedfishRequest *self, GByteArray *buf, GError **e
 	return TRUE;
 }
 
-gboolean
-fu_redfish_request_perform(FuRedfishRequest *self,
+/* revalidate the on-disk copy of the response using If-None-Match */
+static void
+fu_redfish_request_etag_cache_load(FuRedfishRequest *self, const gchar *uri_str)
+{
+	g_autofree gchar *etag = NULL;
+	g_autofree gchar *fn_etag = NULL;
+	g_autofree gchar *fn_json = NULL;
+	g_autofree gchar *hash = NULL;
+	g_autofree gchar *header = NULL;
+	g_autoptr(GBytes) blob = NULL;
+
+	if (self->cache_dir == NULL)
+		return;
+	hash = g_compute_checksum_for_string(G_CHECKSUM_SHA256, uri_str, -1);
+	self->cache_fn = g_build_filename(self->cache_dir, hash, NULL);
+
+	/* both are required, as a 304 response has no payload */
+	fn_etag = g_strdup_printf("%s.etag", self->cache_fn);
+	fn_json = g_strdup_printf("%s.json", self->cache_fn);
+	if (!g_file_get_contents(fn_etag, &etag, NULL, NULL))
+		return;
+	blob = fu_bytes_get_contents(fn_json, NULL);
+	if (blob == NULL)
+		return;
+	header = g_strdup_printf("If-None-Match: %s", etag);
+	self->headers = curl_slist_append(self->headers, header);
+	(void)curl_easy_setopt(self->curl, CURLOPT_HTTPHEADER, self->headers);
+	self->cache_blob = g_steal_pointer(&blob);
+}
+
+static void
+fu_redfish_request_etag_cache_save(FuRedfishRequest *self)
+{
+	g_autofree gchar *fn_etag = NULL;
+	g_autofree gchar *fn_json = NULL;
+	g_autoptr(GError) error_local = NULL;
+
+	if (self->cache_fn == NULL || self->etag == NULL || self->status_code != 200)
+		return;
+
+	/* the BMC responses include serial numbers, so only readable by root */
+	if (g_mkdir_with_parents(self->cache_dir, 0700) != 0) {
+		g_debug("failed to create %s", self->cache_dir);
+		return;
+	}
+
+	/* write the payload first so that an ETag never refers to a missing file */
+	fn_etag = g_strdup_printf("%s.etag", self->cache_fn);
+	fn_json = g_strdup_printf("%s.json", self->cache_fn);
+	if (!g_file_set_contents_full(fn_json,
+				      (const gchar *)self->buf->data,
+				      self->buf->len,
+				      G_FILE_SET_CONTENTS_CONSISTENT,
+				      0600,
+				      &error_local) ||
+	    !g_file_set_contents_full(fn_etag,
+				      self->etag,
+				      -1,
+				      G_FILE_SET_CONTENTS_CONSISTENT,
+				      0600,
+				      &error_local)) {
+		g_debug("failed to save %s to cache: %s", self->path, error_local->message);
+		return;
+	}
+}
+
+/* sets up the transfer, unless the response can be served from the in-memory cache */
+static void
+fu_redfish_request_prepare(FuRedfishRequest *self,
 			   const gchar *path,
-			   FuRedfishRequestPerformFlags flags,
-			   GError **error)
+			   FuRedfishRequestPerformFlags flags)
 {
-	CURLcode res;
-	g_autofree gchar *str = NULL;
 	g_autoptr(curlptr) uri_str = NULL;
 
-	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
-	g_return_val_if_fail(path != NULL, FALSE);
-	g_return_val_if_fail(self->status_code == 0, FALSE);
-	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+	g_free(self->path);
+	self->path = g_strdup(path);
+	self->flags = flags;
 
 	/* already in cache? */
 	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE && self->cache != NULL) {
 		GByteArray *buf = g_hash_table_lookup(self->cache, path);
 		if (buf != NULL) {
-			if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
-				return fu_redfish_request_load_json(self, buf, error);
 			g_byte_array_unref(self->buf);
 			self->buf = g_byte_array_ref(buf);
-			return TRUE;
+			self->from_cache = TRUE;
+			return;
 		}
 	}
 
-	/* do request */
 	(void)curl_url_set(self->uri, CURLUPART_PATH, path, 0);
 	(void)curl_url_get(self->uri, CURLUPART_URL, &uri_str, 0);
-	res = curl_easy_perform(self->curl);
+	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_USE_ETAG_CACHE)
+		fu_redfish_request_etag_cache_load(self, uri_str);
+}
+
+static gboolean
+fu_redfish_request_finish(FuRedfishRequest *self, CURLcode res, GError **error)
+{
+	g_autofree gchar *str = NULL;
+	g_autoptr(curlptr) uri_str = NULL;
+
+	/* served from the in-memory cache */
+	if (self->from_cache) {
+		if (self->flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON)
+			return fu_redfish_request_load_json(self, self->buf, error);
+		return TRUE;
+	}
+
+	(void)curl_url_get(self->uri, CURLUPART_URL, &uri_str, 0);
 	curl_easy_getinfo(self->curl, CURLINFO_RESPONSE_CODE, &self->status_code);
 	str = g_strndup((const gchar *)self->buf->data, self->buf->len);
 	g_debug("%s: %s [%li]", uri_str, str, self->status_code);
@@ -193,8 +279,15 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 		return FALSE;
 	}
 
+	/* not modified since the ETag we sent, so use the payload saved to disk */
+	if (fu_redfish_request_get_status_code(self) == 304 && self->cache_blob != NULL) {
+		g_debug("%s not modified, using cache", uri_str);
+		g_byte_array_set_size(self->buf, 0);
+		fu_byte_array_append_bytes(self->buf, self->cache_blob);
+	}
+
 	/* load JSON */
-	if (flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON) {
+	if (self->flags & FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON) {
 		if (!fu_redfish_request_load_json(self, self->buf, error)) {
 			g_prefix_error(error, "failed to parse %s: ", uri_str);
 			return FALSE;
@@ -203,12 +296,162 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 
 	/* save to cache */
 	if (self->cache != NULL)
-		g_hash_table_insert(self->cache, g_strdup(path), g_byte_array_ref(self->buf));
+		g_hash_table_insert(self->cache, g_strdup(self->path), g_byte_array_ref(self->buf));
+	fu_redfish_request_etag_cache_save(self);
 
 	/* success */
 	return TRUE;
 }
 
+gboolean
+fu_redfish_request_perform(FuRedfishRequest *self,
+			   const gchar *path,
+			   FuRedfishRequestPerformFlags flags,
+			   GError **error)
+{
+	CURLcode res = CURLE_OK;
+
+	g_return_val_if_fail(FU_IS_REDFISH_REQUEST(self), FALSE);
+	g_return_val_if_fail(path != NULL, FALSE);
+	g_return_val_if_fail(self->status_code == 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	fu_redfish_request_prepare(self, path, flags);
+	if (!self->from_cache)
+		res = curl_easy_perform(self->curl);
+	return fu_redfish_request_finish(self, res, error);
+}
+
+/**
+ * fu_redfish_request_perform_multi:
+ * @requests: (element-type FuRedfishRequest): requests, typically sharing a #CURLSH
+ * @paths: (element-type utf8): the path for each request
+ * @flags: perform flags used for every request
+ * @parallel_max: the maximum number of transfers in flight at any time
+ * @error: (nullable): optional return location for an error
+ *
+ * Performs each request concurrently, re-using the connections of the share where possible.
+ * No more transfers are started after the first failure.
+ *
+ * Returns: %TRUE if all the requests succeeded
+ **/
+gboolean
+fu_redfish_request_perform_multi(GPtrArray *requests,
+				 GPtrArray *paths,
+				 FuRedfishRequestPerformFlags flags,
+				 guint parallel_max,
+				 GError **error)
+{
+	CURLM *multi;
+	guint idx = 0;
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GPtrArray) active = g_ptr_array_new();
+
+	g_return_val_if_fail(requests != NULL, FALSE);
+	g_return_val_if_fail(paths != NULL, FALSE);
+	g_return_val_if_fail(requests->len == paths->len, FALSE);
+	g_return_val_if_fail(parallel_max > 0, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	multi = curl_multi_init();
+	while (TRUE) {
+		CURLMcode mc;
+		CURLMsg *msg;
+		gint msgs_left = 0;
+		gint running = 0;
+
+		/* keep the pipeline full */
+		while (error_local == NULL && idx < requests->len && active->len < parallel_max) {
+			FuRedfishRequest *self = g_ptr_array_index(requests, idx);
+			const gchar *path = g_ptr_array_index(paths, idx);
+
+			idx++;
+			if (self->status_code != 0) {
+				g_set_error(&error_local,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "request for %s already performed",
+					    path);
+				break;
+			}
+			fu_redfish_request_prepare(self, path, flags);
+			if (self->from_cache) {
+				if (!fu_redfish_request_finish(self, CURLE_OK, &error_local))
+					break;
+				continue;
+			}
+			(void)curl_easy_setopt(self->curl, CURLOPT_PRIVATE, self);
+			mc = curl_multi_add_handle(multi, self->curl);
+			if (mc != CURLM_OK) {
+				g_set_error(&error_local,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "failed to add request for %s: %s",
+					    path,
+					    curl_multi_strerror(mc));
+				break;
+			}
+			g_ptr_array_add(active, self);
+		}
+		if (error_local != NULL || active->len == 0)
+			break;
+
+		mc = curl_multi_perform(multi, &running);
+		if (mc != CURLM_OK) {
+			g_set_error(&error_local,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "failed to perform requests: %s",
+				    curl_multi_strerror(mc));
+			break;
+		}
+
+		/* process each completed transfer */
+		while ((msg = curl_multi_info_read(multi, &msgs_left)) != NULL) {
+			CURL *curl = msg->easy_handle;
+			CURLcode res = msg->data.result;
+			FuRedfishRequest *self;
+			gchar *priv = NULL;
+
+			if (msg->msg != CURLMSG_DONE)
+				continue;
+			(void)curl_easy_getinfo(curl, CURLINFO_PRIVATE, &priv);
+			self = FU_REDFISH_REQUEST(priv);
+			(void)curl_multi_remove_handle(multi, curl);
+			g_ptr_array_remove(active, self);
+			if (error_local == NULL)
+				(void)fu_redfish_request_finish(self, res, &error_local);
+		}
+		if (error_local != NULL)
+			break;
+
+		/* wait for activity, without requiring curl_multi_poll() from libcurl 7.66.0 */
+		if (active->len > 0) {
+			mc = curl_multi_wait(multi, NULL, 0, 1000, NULL);
+			if (mc != CURLM_OK) {
+				g_set_error(&error_local,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_INTERNAL,
+					    "failed to wait for requests: %s",
+					    curl_multi_strerror(mc));
+				break;
+			}
+		}
+	}
+
+	/* abort anything still in flight */
+	for (guint i = 0; i < active->len; i++) {
+		FuRedfishRequest *self = g_ptr_array_index(active, i);
+		(void)curl_multi_remove_handle(multi, self->curl);
+	}
+	curl_multi_cleanup(multi);
+	if (error_local != NULL) {
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 typedef struct curl_slist _curl_slist;
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(_curl_slist, curl_slist_free_all)
 
@@ -217,6 +460,14 @@ fu_redfish_request_reset(FuRedfishRequest *self)
 {
 	self->status_code = 0;
 	self->json_obj = NULL;
+	self->from_cache = FALSE;
+	g_clear_pointer(&self->etag, g_free);
+	g_clear_pointer(&self->cache_fn, g_free);
+	g_clear_pointer(&self->cache_blob, g_bytes_unref);
+	if (self->headers != NULL) {
+		(void)curl_easy_setopt(self->curl, CURLOPT_HTTPHEADER, NULL);
+		g_clear_pointer(&self->headers, curl_slist_free_all);
+	}
 }
 
 gboolean
@@ -286,6 +537,21 @@ fu_redfish_request_write_cb(char *ptr, size_t size, size_t nmemb, void *userdata
 	return realsize;
 }
 
+static size_t
+fu_redfish_request_header_cb(char *ptr, size_t size, size_t nmemb, void *userdata)
+{
+	FuRedfishRequest *self = FU_REDFISH_REQUEST(userdata);
+	gsize realsize = size * nmemb;
+	g_autofree gchar *line = g_strndup(ptr, realsize);
+	g_auto(GStrv) split = g_strsplit(line, ":", 2);
+
+	if (g_strv_length(split) == 2 && g_ascii_strcasecmp(split[0], "ETag") == 0) {
+		g_free(self->etag);
+		self->etag = g_strstrip(g_strdup(split[1]));
+	}
+	return realsize;
+}
+
 void
 fu_redfish_request_set_cache(FuRedfishRequest *self, GHashTable *cache)
 {
@@ -295,6 +561,15 @@ fu_redfish_request_set_cache(FuRedfishRequest *self, GHashTable *cache)
 	self->cache = g_hash_table_ref(cache);
 }
 
+void
+fu_redfish_request_set_cache_dir(FuRedfishRequest *self, const gchar *cache_dir)
+{
+	g_return_if_fail(FU_IS_REDFISH_REQUEST(self));
+	g_return_if_fail(cache_dir != NULL);
+	g_free(self->cache_dir);
+	self->cache_dir = g_strdup(cache_dir);
+}
+
 void
 fu_redfish_request_set_curlsh(FuRedfishRequest *self, CURLSH *curlsh)
 {
@@ -312,6 +587,8 @@ fu_redfish_request_init(FuRedfishRequest *self)
 	self->json_parser = json_parser_new();
 	(void)curl_easy_setopt(self->curl, CURLOPT_WRITEFUNCTION, fu_redfish_request_write_cb);
 	(void)curl_easy_setopt(self->curl, CURLOPT_WRITEDATA, self->buf);
+	(void)curl_easy_setopt(self->curl, CURLOPT_HEADERFUNCTION, fu_redfish_request_header_cb);
+	(void)curl_easy_setopt(self->curl, CURLOPT_HEADERDATA, self);
 }
 
 static void
@@ -320,6 +597,14 @@ fu_redfish_request_finalize(GObject *object)
 	FuRedfishRequest *self = FU_REDFISH_REQUEST(object);
 	if (self->cache != NULL)
 		g_hash_table_unref(self->cache);
+	if (self->cache_blob != NULL)
+		g_bytes_unref(self->cache_blob);
+	if (self->headers != NULL)
+		curl_slist_free_all(self->headers);
+	g_free(self->cache_dir);
+	g_free(self->cache_fn);
+	g_free(self->etag);
+	g_free(self->path);
 	g_object_unref(self->json_parser);
 	g_byte_array_unref(self->buf);
 	curl_easy_cleanup(self->curl);
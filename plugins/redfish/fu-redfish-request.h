@@ -18,6 +18,7 @@ typedef enum {
 	FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON = 1 << 0,
 	FU_REDFISH_REQUEST_PERFORM_FLAG_USE_CACHE = 1 << 1,
 	FU_REDFISH_REQUEST_PERFORM_FLAG_USE_ETAG = 1 << 2,
+	FU_REDFISH_REQUEST_PERFORM_FLAG_USE_ETAG_CACHE = 1 << 3,
 } FuRedfishRequestPerformFlags;
 
 gboolean
@@ -26,6 +27,12 @@ fu_redfish_request_perform(FuRedfishRequest *self,
 			   FuRedfishRequestPerformFlags flags,
 			   GError **error);
 gboolean
+fu_redfish_request_perform_multi(GPtrArray *requests,
+				 GPtrArray *paths,
+				 FuRedfishRequestPerformFlags flags,
+				 guint parallel_max,
+				 GError **error);
+gboolean
 fu_redfish_request_perform_full(FuRedfishRequest *self,
 				const gchar *path,
 				const gchar *request,
@@ -44,3 +51,5 @@ glong
 fu_redfish_request_get_status_code(FuRedfishRequest *self);
 void
 fu_redfish_request_set_cache(FuRedfishRequest *self, GHashTable *cache);
+void
+fu_redfish_request_set_cache_dir(FuRedfishRequest *self, const gchar *cache_dir);
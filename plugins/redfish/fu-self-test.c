@@ -6,12 +6,15 @@
 
 #include "config.h"
 
+#include <glib/gstdio.h>
+
 #include "fu-context-private.h"
 #include "fu-device-private.h"
 #ifdef HAVE_LINUX_IPMI_H
 #include "fu-ipmi-device.h"
 #endif
 #include "fu-plugin-private.h"
+#include "fu-redfish-backend.h"
 #include "fu-redfish-common.h"
 #include "fu-redfish-network.h"
 #include "fu-redfish-plugin.h"
@@ -323,6 +326,76 @@ fu_test_redfish_devices_func(gconstpointer user_data)
 	g_assert_true(fu_device_has_vendor_id(dev, "REDFISH:CONTOSO"));
 }
 
+static void
+fu_test_redfish_request_multi_func(void)
+{
+	gboolean ret;
+	const gchar *member_uris[] = {"/redfish/v1/UpdateService/FirmwareInventory/BMC",
+				      "/redfish/v1/UpdateService/FirmwareInventory/BIOS",
+				      NULL};
+	g_autofree gchar *cachedir = NULL;
+	g_autoptr(FuContext) ctx = fu_context_new();
+	g_autoptr(FuRedfishBackend) backend = fu_redfish_backend_new(ctx);
+	g_autoptr(GError) error_glob = NULL;
+	g_autoptr(GPtrArray) filenames = NULL;
+
+	fu_redfish_backend_set_hostname(backend, "localhost");
+	fu_redfish_backend_set_port(backend, 4661);
+	fu_redfish_backend_set_https(backend, FALSE);
+	fu_redfish_backend_set_username(backend, "username2");
+	fu_redfish_backend_set_password(backend, "password2");
+
+	/* the second pass is revalidated using the ETag saved to disk by the first */
+	for (guint j = 0; j < 2; j++) {
+		g_autoptr(GError) error = NULL;
+		g_autoptr(GPtrArray) paths = g_ptr_array_new();
+		g_autoptr(GPtrArray) requests = g_ptr_array_new_with_free_func(g_object_unref);
+
+		for (guint i = 0; member_uris[i] != NULL; i++) {
+			g_ptr_array_add(paths, (gpointer)member_uris[i]);
+			g_ptr_array_add(requests, fu_redfish_backend_request_new(backend));
+		}
+		ret = fu_redfish_request_perform_multi(
+		    requests,
+		    paths,
+		    FU_REDFISH_REQUEST_PERFORM_FLAG_LOAD_JSON |
+			FU_REDFISH_REQUEST_PERFORM_FLAG_USE_ETAG_CACHE,
+		    2,
+		    &error);
+		if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_FILE)) {
+			g_test_skip("no redfish.py running");
+			return;
+		}
+		g_assert_no_error(error);
+		g_assert_true(ret);
+		for (guint i = 0; i < requests->len; i++) {
+			FuRedfishRequest *request = g_ptr_array_index(requests, i);
+			JsonObject *json_obj = fu_redfish_request_get_json_object(request);
+			g_assert_nonnull(json_obj);
+			g_assert_cmpstr(json_object_get_string_member(json_obj, "@odata.id"),
+					==,
+					member_uris[i]);
+			if (j == 1)
+				g_assert_cmpint(fu_redfish_request_get_status_code(request),
+						==,
+						304);
+		}
+	}
+
+	/* the responses include serial numbers so are only readable by root */
+	cachedir = g_build_filename(g_getenv("CACHE_DIRECTORY"), "redfish", NULL);
+	filenames = fu_path_glob(cachedir, "*.json", &error_glob);
+	g_assert_no_error(error_glob);
+	g_assert_nonnull(filenames);
+	g_assert_cmpint(filenames->len, ==, 2);
+	for (guint i = 0; i < filenames->len; i++) {
+		GStatBuf statbuf = {0};
+		gint rc = g_stat(g_ptr_array_index(filenames, i), &statbuf);
+		g_assert_cmpint(rc, ==, 0);
+		g_assert_cmpint(statbuf.st_mode & 0777, ==, 0600);
+	}
+}
+
 static void
 fu_test_redfish_unlicensed_devices_func(gconstpointer user_data)
 {
@@ -488,9 +561,12 @@ G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuTest, fu_test_self_free)
 int
 main(int argc, char **argv)
 {
+	gint rc;
 	g_autoptr(FuTest) self = g_new0(FuTest, 1);
+	g_autofree gchar *cachedir = NULL;
 	g_autofree gchar *smbios_data_fn = NULL;
 	g_autofree gchar *testdatadir = NULL;
+	g_autoptr(GError) error = NULL;
 
 	(void)g_setenv("G_TEST_SRCDIR", SRCDIR, FALSE);
 	g_test_init(&argc, &argv, NULL);
@@ -504,6 +580,11 @@ main(int argc, char **argv)
 	(void)g_setenv("CONFIGURATION_DIRECTORY", testdatadir, TRUE);
 	(void)g_setenv("FWUPD_SYSFSFWATTRIBDIR", testdatadir, TRUE);
 
+	/* the ETag cache must not be shared between test runs */
+	cachedir = g_dir_make_tmp("fwupd-redfish-self-test-XXXXXX", &error);
+	g_assert_no_error(error);
+	(void)g_setenv("CACHE_DIRECTORY", cachedir, TRUE);
+
 	g_log_set_fatal_mask(NULL, G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL);
 	fu_test_self_init(self);
 	g_test_add_func("/redfish/ipmi", fu_test_redfish_ipmi_func);
@@ -512,6 +593,7 @@ main(int argc, char **argv)
 	g_test_add_func("/redfish/common{lenovo}", fu_test_redfish_common_lenovo_func);
 	g_test_add_func("/redfish/network{mac_addr}", fu_test_redfish_network_mac_addr_func);
 	g_test_add_func("/redfish/network{vid_pid}", fu_test_redfish_network_vid_pid_func);
+	g_test_add_func("/redfish/request{multi}", fu_test_redfish_request_multi_func);
 	g_test_add_data_func("/redfish/unlicensed_plugin{devices}",
 			     self,
 			     fu_test_redfish_unlicensed_devices_func);
@@ -521,5 +603,8 @@ main(int argc, char **argv)
 	g_test_add_data_func("/redfish/smc_plugin{update}", self, fu_test_redfish_smc_update_func);
 	g_test_add_data_func("/redfish/plugin{devices}", self, fu_test_redfish_devices_func);
 	g_test_add_data_func("/redfish/plugin{update}", self, fu_test_redfish_update_func);
-	return g_test_run();
+	rc = g_test_run();
+	if (!fu_path_rmtree(cachedir, &error))
+		g_warning("failed to remove %s: %s", cachedir, error->message);
+	return rc;
 }
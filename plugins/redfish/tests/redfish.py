@@ -27,6 +27,19 @@ def _failure(msg: str, status=400):
     return Response(response=json.dumps(res), status=401, mimetype="application/json")
 
 
+@app.after_request
+def _add_etag(response):
+    # allow clients to revalidate cached GETs using If-None-Match
+    if (
+        request.method == "GET"
+        and response.status_code == 200
+        and response.mimetype == "application/json"
+    ):
+        response.add_etag()
+        response.make_conditional(request)
+    return response
+
+
 @app.route("/redfish/v1/")
 def index():
     # reset counter
@@ -117,6 +117,7 @@ static void
 fu_thunderbolt_plugin_constructed(GObject *obj)
 {
 	FuPlugin *plugin = FU_PLUGIN(obj);
+	fu_plugin_add_rule(plugin, FU_PLUGIN_RULE_DEVICE_BACKEND, "udev");
 	fu_plugin_add_udev_subsystem(plugin, "thunderbolt");
 	fu_plugin_add_device_gtype(plugin, FU_TYPE_THUNDERBOLT_CONTROLLER);
 	fu_plugin_add_device_gtype(plugin, FU_TYPE_THUNDERBOLT_RETIMER);
@@ -103,8 +103,12 @@ static gboolean
 fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 {
 	const gchar *csum_filename = NULL;
+	const gchar *checksum_old = NULL;
 	gsize streamsz = 0;
+	guint checksum_typesz = 0;
+	GChecksumType checksum_types[3] = {0};
 	g_autofree gchar *basename = NULL;
+	g_autoptr(GPtrArray) checksums = NULL;
 	g_autoptr(FuFirmware) img_blob = NULL;
 	g_autoptr(GInputStream) stream = NULL;
 	g_autoptr(GError) error_local2 = NULL;
@@ -181,30 +185,41 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 		xb_node_set_data(release, "fwupd::ReleaseSize", blob_sz);
 	}
 
-	/* set if unspecified, but error out if specified and incorrect */
-	if (csum_tmp != NULL && xb_node_get_text(csum_tmp) != NULL) {
-		const gchar *checksum_old = xb_node_get_text(csum_tmp);
-		GChecksumType checksum_type = fwupd_checksum_guess_kind(checksum_old);
-		g_autofree gchar *checksum = NULL;
-		checksum = fu_input_stream_compute_checksum(stream, checksum_type, error);
-		if (checksum == NULL)
+	/* read the payload once for all the digests that are required */
+	item = jcat_file_get_item_by_id(self->jcat_file, basename, NULL);
+	if (item != NULL && jcat_item_has_target(item)) {
+		checksum_types[checksum_typesz++] = G_CHECKSUM_SHA256;
+		checksum_types[checksum_typesz++] = G_CHECKSUM_SHA512;
+	}
+	if (csum_tmp != NULL)
+		checksum_old = xb_node_get_text(csum_tmp);
+	if (checksum_old != NULL)
+		checksum_types[checksum_typesz++] = fwupd_checksum_guess_kind(checksum_old);
+	if (checksum_typesz > 0) {
+		checksums = fu_input_stream_compute_checksums(stream,
+							      checksum_types,
+							      checksum_typesz,
+							      error);
+		if (checksums == NULL)
 			return FALSE;
+	}
+
+	/* set if unspecified, but error out if specified and incorrect */
+	if (checksum_old != NULL) {
+		const gchar *checksum = g_ptr_array_index(checksums, checksum_typesz - 1);
 		if (g_strcmp0(checksum, checksum_old) != 0) {
 			g_set_error(error,
 				    FWUPD_ERROR,
 				    FWUPD_ERROR_INVALID_FILE,
 				    "contents checksum invalid, expected %s, got %s",
 				    checksum,
-				    xb_node_get_text(csum_tmp));
+				    checksum_old);
 			return FALSE;
 		}
 	}
 
 	/* the jcat file signed the *checksum of the payload*, not the payload itself */
-	item = jcat_file_get_item_by_id(self->jcat_file, basename, NULL);
 	if (item != NULL && jcat_item_has_target(item)) {
-		gchar *checksum_sha256 = NULL;
-		gchar *checksum_sha512 = NULL;
 		g_autoptr(GError) error_local = NULL;
 		g_autoptr(GPtrArray) results = NULL;
 		g_autoptr(JcatBlob) blob_target_sha256 = NULL;
@@ -212,19 +227,13 @@ fu_cabinet_parse_release(FuCabinet *self, XbNode *release, GError **error)
 		g_autoptr(JcatItem) item_target = jcat_item_new(basename);
 
 		/* add SHA-256 */
-		checksum_sha256 =
-		    fu_input_stream_compute_checksum(stream, G_CHECKSUM_SHA256, error);
-		if (checksum_sha256 == NULL)
-			return FALSE;
-		blob_target_sha256 = jcat_blob_new_utf8(JCAT_BLOB_KIND_SHA256, checksum_sha256);
+		blob_target_sha256 =
+		    jcat_blob_new_utf8(JCAT_BLOB_KIND_SHA256, g_ptr_array_index(checksums, 0));
 		jcat_item_add_blob(item_target, blob_target_sha256);
 
 		/* add SHA-512 */
-		checksum_sha512 =
-		    fu_input_stream_compute_checksum(stream, G_CHECKSUM_SHA512, error);
-		if (checksum_sha512 == NULL)
-			return FALSE;
-		blob_target_sha512 = jcat_blob_new_utf8(JCAT_BLOB_KIND_SHA512, checksum_sha512);
+		blob_target_sha512 =
+		    jcat_blob_new_utf8(JCAT_BLOB_KIND_SHA512, g_ptr_array_index(checksums, 1));
 		jcat_item_add_blob(item_target, blob_target_sha512);
 
 		results = jcat_context_verify_target(self->jcat_context,
@@ -873,17 +882,26 @@ fu_cabinet_parse(FuFirmware *firmware,
 
 	/* decompress and calculate container hashes */
 	if (stream != NULL) {
+		const GChecksumType checksum_types[] = {G_CHECKSUM_SHA1, G_CHECKSUM_SHA256};
+		g_autoptr(GInputStream) stream_cab = NULL;
+		g_autoptr(GPtrArray) checksums = NULL;
+
 		if (!FU_FIRMWARE_CLASS(fu_cabinet_parent_class)
 			 ->parse(firmware, stream, offset, flags, error))
 			return FALSE;
-		self->container_checksum =
-		    fu_firmware_get_checksum(firmware, G_CHECKSUM_SHA1, error);
-		if (self->container_checksum == NULL)
+
+		/* read the container once for both digests */
+		stream_cab = fu_firmware_get_stream(firmware, error);
+		if (stream_cab == NULL)
 			return FALSE;
-		self->container_checksum_alt =
-		    fu_firmware_get_checksum(firmware, G_CHECKSUM_SHA256, error);
-		if (self->container_checksum_alt == NULL)
+		checksums = fu_input_stream_compute_checksums(stream_cab,
+							      checksum_types,
+							      G_N_ELEMENTS(checksum_types),
+							      error);
+		if (checksums == NULL)
 			return FALSE;
+		self->container_checksum = g_strdup(g_ptr_array_index(checksums, 0));
+		self->container_checksum_alt = g_strdup(g_ptr_array_index(checksums, 1));
 	}
 
 	/* build xmlb silo */
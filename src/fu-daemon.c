@@ -59,7 +59,13 @@ struct _FuDaemon {
 	guint32 clients_inhibit_id;
 	FuPolkitAuthority *authority;
 	FwupdStatus status; /* last emitted */
-	guint percentage;   /* last emitted */
+	guint percentage;   /* last set */
+	guint percentage_pending;
+	gint64 percentage_emitted; /* monotonic, us */
+	GPtrArray *pending_devices; /* (element-type FuDevice) */
+	guint pending_id;
+	GHashTable *methods;	 /* (element-type GQuark FuDaemonMethodItem) */
+	GHashTable *sender_uids; /* (element-type utf8 guint) */
 	guint owner_id;
 	guint process_quit_id;
 	FuEngine *engine;
@@ -74,6 +80,8 @@ G_DEFINE_TYPE(FuDaemon, fu_daemon, G_TYPE_OBJECT)
 
 #define FU_DAEMON_HOUSEKEEPING_DELAY 10 /* seconds */
 
+#define FU_DAEMON_SENDER_UIDS_MAX 1024
+
 static gboolean
 fu_daemon_schedule_housekeeping_cb(gpointer user_data)
 {
@@ -120,12 +128,113 @@ fu_daemon_stop(FuDaemon *self)
 	g_main_loop_quit(self->loop);
 }
 
+static void
+fu_daemon_emit_property_changed(FuDaemon *self,
+				const gchar *property_name,
+				GVariant *property_value)
+{
+	GVariantBuilder builder;
+	GVariantBuilder invalidated_builder;
+
+	/* not yet connected */
+	if (self->connection == NULL) {
+		g_variant_unref(g_variant_ref_sink(property_value));
+		return;
+	}
+
+	/* build the dict */
+	g_variant_builder_init(&invalidated_builder, G_VARIANT_TYPE("as"));
+	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+	g_variant_builder_add(&builder, "{sv}", property_name, property_value);
+	g_dbus_connection_emit_signal(
+	    self->connection,
+	    NULL,
+	    FWUPD_DBUS_PATH,
+	    "org.freedesktop.DBus.Properties",
+	    "PropertiesChanged",
+	    g_variant_new("(sa{sv}as)", FWUPD_DBUS_INTERFACE, &builder, &invalidated_builder),
+	    NULL);
+	g_variant_builder_clear(&builder);
+	g_variant_builder_clear(&invalidated_builder);
+}
+
+static void
+fu_daemon_emit_device_changed(FuDaemon *self, FuDevice *device)
+{
+	GVariant *val = fwupd_device_to_variant(FWUPD_DEVICE(device));
+	g_dbus_connection_emit_signal(self->connection,
+				      NULL,
+				      FWUPD_DBUS_PATH,
+				      FWUPD_DBUS_INTERFACE,
+				      "DeviceChanged",
+				      g_variant_new_tuple(&val, 1),
+				      NULL);
+}
+
+static void
+fu_daemon_emit_percentage(FuDaemon *self, guint percentage)
+{
+	self->percentage_emitted = g_get_monotonic_time();
+	g_debug("Emitting PropertyChanged('Percentage'='%u%%')", percentage);
+	fu_daemon_emit_property_changed(self, "Percentage", g_variant_new_uint32(percentage));
+}
+
+/* in ms, where 0 disables coalescing */
+static guint
+fu_daemon_get_coalesce_window(FuDaemon *self)
+{
+	if (self->engine == NULL)
+		return 0;
+	return fu_config_get_value_u64(FU_CONFIG(fu_engine_get_config(self->engine)),
+				       "fwupd",
+				       "SignalCoalesceWindow");
+}
+
+/* emit everything that has been deferred, so that ordering is preserved */
+static void
+fu_daemon_flush_pending(FuDaemon *self)
+{
+	if (self->pending_id != 0) {
+		g_source_remove(self->pending_id);
+		self->pending_id = 0;
+	}
+	if (self->connection != NULL) {
+		for (guint i = 0; i < self->pending_devices->len; i++) {
+			FuDevice *device = g_ptr_array_index(self->pending_devices, i);
+			fu_daemon_emit_device_changed(self, device);
+		}
+	}
+	g_ptr_array_set_size(self->pending_devices, 0);
+	if (self->percentage_pending != G_MAXUINT) {
+		fu_daemon_emit_percentage(self, self->percentage_pending);
+		self->percentage_pending = G_MAXUINT;
+	}
+}
+
+static gboolean
+fu_daemon_flush_pending_cb(gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+	self->pending_id = 0;
+	fu_daemon_flush_pending(self);
+	return G_SOURCE_REMOVE;
+}
+
+static void
+fu_daemon_schedule_pending(FuDaemon *self, guint window)
+{
+	if (self->pending_id != 0)
+		return;
+	self->pending_id = g_timeout_add(window, fu_daemon_flush_pending_cb, self);
+}
+
 static void
 fu_daemon_engine_changed_cb(FuEngine *engine, FuDaemon *self)
 {
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
+	fu_daemon_flush_pending(self);
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
 				      FWUPD_DBUS_PATH,
@@ -144,6 +253,7 @@ fu_daemon_engine_device_added_cb(FuEngine *engine, FuDevice *device, FuDaemon *s
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
+	fu_daemon_flush_pending(self);
 	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
@@ -163,6 +273,7 @@ fu_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDaemon
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
+	fu_daemon_flush_pending(self);
 	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
@@ -177,20 +288,31 @@ fu_daemon_engine_device_removed_cb(FuEngine *engine, FuDevice *device, FuDaemon
 static void
 fu_daemon_engine_device_changed_cb(FuEngine *engine, FuDevice *device, FuDaemon *self)
 {
-	GVariant *val;
+	guint window;
 
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
-	val = fwupd_device_to_variant(FWUPD_DEVICE(device));
-	g_dbus_connection_emit_signal(self->connection,
-				      NULL,
-				      FWUPD_DBUS_PATH,
-				      FWUPD_DBUS_INTERFACE,
-				      "DeviceChanged",
-				      g_variant_new_tuple(&val, 1),
-				      NULL);
 	fu_daemon_schedule_housekeeping(self);
+
+	/* emit now */
+	window = fu_daemon_get_coalesce_window(self);
+	if (window == 0) {
+		fu_daemon_emit_device_changed(self, device);
+		return;
+	}
+
+	/* merge with any pending signal for the same device, the variant is built when emitted */
+	for (guint i = 0; i < self->pending_devices->len; i++) {
+		FuDevice *device_tmp = g_ptr_array_index(self->pending_devices, i);
+		if (g_strcmp0(fu_device_get_id(device_tmp), fu_device_get_id(device)) == 0) {
+			g_object_unref(device_tmp);
+			g_ptr_array_index(self->pending_devices, i) = g_object_ref(device);
+			return;
+		}
+	}
+	g_ptr_array_add(self->pending_devices, g_object_ref(device));
+	fu_daemon_schedule_pending(self, window);
 }
 
 static void
@@ -201,6 +323,7 @@ fu_daemon_engine_device_request_cb(FuEngine *engine, FwupdRequest *request, FuDa
 	/* not yet connected */
 	if (self->connection == NULL)
 		return;
+	fu_daemon_flush_pending(self);
 	val = fwupd_request_to_variant(FWUPD_REQUEST(request));
 	g_dbus_connection_emit_signal(self->connection,
 				      NULL,
@@ -211,36 +334,6 @@ fu_daemon_engine_device_request_cb(FuEngine *engine, FwupdRequest *request, FuDa
 				      NULL);
 }
 
-static void
-fu_daemon_emit_property_changed(FuDaemon *self,
-				const gchar *property_name,
-				GVariant *property_value)
-{
-	GVariantBuilder builder;
-	GVariantBuilder invalidated_builder;
-
-	/* not yet connected */
-	if (self->connection == NULL) {
-		g_variant_unref(g_variant_ref_sink(property_value));
-		return;
-	}
-
-	/* build the dict */
-	g_variant_builder_init(&invalidated_builder, G_VARIANT_TYPE("as"));
-	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
-	g_variant_builder_add(&builder, "{sv}", property_name, property_value);
-	g_dbus_connection_emit_signal(
-	    self->connection,
-	    NULL,
-	    FWUPD_DBUS_PATH,
-	    "org.freedesktop.DBus.Properties",
-	    "PropertiesChanged",
-	    g_variant_new("(sa{sv}as)", FWUPD_DBUS_INTERFACE, &builder, &invalidated_builder),
-	    NULL);
-	g_variant_builder_clear(&builder);
-	g_variant_builder_clear(&invalidated_builder);
-}
-
 static void
 fu_daemon_set_status(FuDaemon *self, FwupdStatus status)
 {
@@ -249,6 +342,9 @@ fu_daemon_set_status(FuDaemon *self, FwupdStatus status)
 		return;
 	self->status = status;
 
+	/* any deferred percentage has to arrive before the new status */
+	fu_daemon_flush_pending(self);
+
 	g_debug("Emitting PropertyChanged('Status'='%s')", fwupd_status_to_string(status));
 	fu_daemon_emit_property_changed(self, "Status", g_variant_new_uint32(status));
 }
@@ -263,6 +359,35 @@ fu_daemon_engine_status_changed_cb(FuEngine *engine, FwupdStatus status, FuDaemo
 		g_main_loop_quit(self->loop);
 }
 
+static gboolean
+fu_daemon_get_sender_uid(FuDaemon *self, const gchar *sender, guint *calling_uid, GError **error)
+{
+	gpointer uid_tmp = NULL;
+	g_autoptr(GVariant) value = NULL;
+
+	/* unique bus names are never reused, so this can never be stale */
+	if (g_hash_table_lookup_extended(self->sender_uids, sender, NULL, &uid_tmp)) {
+		*calling_uid = GPOINTER_TO_UINT(uid_tmp);
+		return TRUE;
+	}
+	value = g_dbus_proxy_call_sync(self->proxy_uid,
+				       "GetConnectionUnixUser",
+				       g_variant_new("(s)", sender),
+				       G_DBUS_CALL_FLAGS_NONE,
+				       2000,
+				       NULL,
+				       error);
+	if (value == NULL) {
+		g_prefix_error(error, "failed to read user id of caller: ");
+		return FALSE;
+	}
+	g_variant_get(value, "(u)", calling_uid);
+	if (g_hash_table_size(self->sender_uids) >= FU_DAEMON_SENDER_UIDS_MAX)
+		g_hash_table_remove_all(self->sender_uids);
+	g_hash_table_insert(self->sender_uids, g_strdup(sender), GUINT_TO_POINTER(*calling_uid));
+	return TRUE;
+}
+
 static FuEngineRequest *
 fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
 {
@@ -270,7 +395,6 @@ fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
 	guint calling_uid = 0;
 	g_autoptr(FuClient) client = NULL;
 	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
-	g_autoptr(GVariant) value = NULL;
 
 	/* if using FWUPD_DBUS_SOCKET... */
 	if (sender == NULL) {
@@ -288,18 +412,8 @@ fu_daemon_create_request(FuDaemon *self, const gchar *sender, GError **error)
 	}
 
 	/* are we root and therefore trusted? */
-	value = g_dbus_proxy_call_sync(self->proxy_uid,
-				       "GetConnectionUnixUser",
-				       g_variant_new("(s)", sender),
-				       G_DBUS_CALL_FLAGS_NONE,
-				       2000,
-				       NULL,
-				       error);
-	if (value == NULL) {
-		g_prefix_error(error, "failed to read user id of caller: ");
+	if (!fu_daemon_get_sender_uid(self, sender, &calling_uid, error))
 		return NULL;
-	}
-	g_variant_get(value, "(u)", &calling_uid);
 	if (fu_engine_is_uid_trusted(self->engine, calling_uid))
 		device_flags |= FWUPD_DEVICE_FLAG_TRUSTED;
 	fu_engine_request_set_device_flags(request, device_flags);
@@ -325,7 +439,8 @@ fu_daemon_device_array_to_variant(FuDaemon *self,
 		flags |= FWUPD_DEVICE_FLAG_TRUSTED;
 	for (guint i = 0; i < devices->len; i++) {
 		FuDevice *device = g_ptr_array_index(devices, i);
-		GVariant *tmp = fwupd_device_to_variant_full(FWUPD_DEVICE(device), flags);
+		g_autoptr(GVariant) tmp = NULL;
+		tmp = fwupd_device_to_variant_cached(FWUPD_DEVICE(device), flags);
 		g_variant_builder_add_value(&builder, tmp);
 	}
 	return g_variant_new("(aa{sv})", &builder);
@@ -446,13 +561,72 @@ fu_daemon_auth_helper_free(FuMainAuthHelper *helper)
 	g_free(helper);
 }
 
+/* this includes the time taken for any authentication check */
+static void
+fu_daemon_method_invocation_add_metric(FuDaemon *self, GDBusMethodInvocation *invocation)
+{
+	const gchar *method_name = g_dbus_method_invocation_get_method_name(invocation);
+	gint64 elapsed;
+	gint64 *start = g_object_get_data(G_OBJECT(invocation), "fwupd::StartTime");
+
+	if (start == NULL || self->engine == NULL)
+		return;
+	elapsed = g_get_monotonic_time() - *start;
+	fu_metrics_add(fu_engine_get_metrics(self->engine), "dbus", method_name, elapsed);
+	g_debug("%s took %.1fms", method_name, (gdouble)elapsed / 1000.f);
+}
+
+/* anything deferred has to be sent before the reply, e.g. so that NEEDS_REBOOT is seen */
+static void
+fu_daemon_method_invocation_return_value(FuDaemon *self,
+					 GDBusMethodInvocation *invocation,
+					 GVariant *parameters)
+{
+	fu_daemon_flush_pending(self);
+	fu_daemon_method_invocation_add_metric(self, invocation);
+	g_dbus_method_invocation_return_value(invocation, parameters);
+}
+
 static void
-fu_daemon_method_invocation_return_gerror(GDBusMethodInvocation *invocation, GError *error)
+fu_daemon_method_invocation_return_gerror(FuDaemon *self,
+					  GDBusMethodInvocation *invocation,
+					  GError *error)
 {
+	fu_daemon_flush_pending(self);
+	fu_daemon_method_invocation_add_metric(self, invocation);
 	fu_error_convert(&error);
 	g_dbus_method_invocation_return_gerror(invocation, error);
 }
 
+static void
+fu_daemon_method_invocation_return_error_literal(FuDaemon *self,
+						 GDBusMethodInvocation *invocation,
+						 GQuark domain,
+						 gint code,
+						 const gchar *message)
+{
+	fu_daemon_flush_pending(self);
+	fu_daemon_method_invocation_add_metric(self, invocation);
+	g_dbus_method_invocation_return_error_literal(invocation, domain, code, message);
+}
+
+G_GNUC_PRINTF(5, 6)
+static void
+fu_daemon_method_invocation_return_error(FuDaemon *self,
+					 GDBusMethodInvocation *invocation,
+					 GQuark domain,
+					 gint code,
+					 const gchar *format,
+					 ...)
+{
+	va_list args;
+	fu_daemon_flush_pending(self);
+	fu_daemon_method_invocation_add_metric(self, invocation);
+	va_start(args, format);
+	g_dbus_method_invocation_return_error_valist(invocation, domain, code, format, args);
+	va_end(args);
+}
+
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wunused-function"
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuMainAuthHelper, fu_daemon_auth_helper_free)
@@ -466,18 +640,18 @@ fu_daemon_authorize_unlock_cb(GObject *source, GAsyncResult *res, gpointer user_
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* authenticated */
 	if (!fu_engine_unlock(helper->self->engine, helper->device_id, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -491,7 +665,7 @@ fu_daemon_authorize_get_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -499,7 +673,7 @@ fu_daemon_authorize_get_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 	ctx = fu_engine_get_context(helper->self->engine);
 	attrs = fu_context_get_bios_settings(ctx);
 	val = fu_bios_settings_to_variant(attrs, TRUE);
-	g_dbus_method_invocation_return_value(helper->invocation, val);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, val);
 }
 
 static void
@@ -510,7 +684,7 @@ fu_daemon_authorize_set_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -519,11 +693,11 @@ fu_daemon_authorize_set_bios_settings_cb(GObject *source, GAsyncResult *res, gpo
 					    helper->bios_settings,
 					    FALSE,
 					    &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -534,7 +708,7 @@ fu_daemon_authorize_set_approved_firmware_cb(GObject *source, GAsyncResult *res,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -543,7 +717,7 @@ fu_daemon_authorize_set_approved_firmware_cb(GObject *source, GAsyncResult *res,
 		const gchar *csum = g_ptr_array_index(helper->checksums, i);
 		fu_engine_add_approved_firmware(helper->self->engine, csum);
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -554,16 +728,16 @@ fu_daemon_authorize_set_blocked_firmware_cb(GObject *source, GAsyncResult *res,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
 	if (!fu_engine_set_blocked_firmware(helper->self->engine, helper->checksums, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -576,16 +750,16 @@ fu_daemon_authorize_fix_host_security_attr_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
 	if (!fu_engine_fix_host_security_attr(helper->self->engine, helper->key, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -598,16 +772,16 @@ fu_daemon_authorize_undo_host_security_attr_cb(GObject *source,
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
 	if (!fu_engine_undo_host_security_attr(helper->self->engine, helper->key, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -619,19 +793,21 @@ fu_daemon_authorize_self_sign_cb(GObject *source, GAsyncResult *res, gpointer us
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* authenticated */
 	sig = fu_engine_self_sign(helper->self->engine, helper->value, helper->flags, &error);
 	if (sig == NULL) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, g_variant_new("(s)", sig));
+	fu_daemon_method_invocation_return_value(helper->self,
+						 helper->invocation,
+						 g_variant_new("(s)", sig));
 }
 
 static void
@@ -642,7 +818,7 @@ fu_daemon_modify_config_cb(GObject *source, GAsyncResult *res, gpointer user_dat
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -651,12 +827,12 @@ fu_daemon_modify_config_cb(GObject *source, GAsyncResult *res, gpointer user_dat
 				     helper->key,
 				     helper->value,
 				     &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -667,28 +843,40 @@ fu_daemon_reset_config_cb(GObject *source, GAsyncResult *res, gpointer user_data
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 	if (!fu_engine_reset_config(helper->self->engine, helper->section, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
 fu_daemon_progress_percentage_changed_cb(FuProgress *progress, guint percentage, FuDaemon *self)
 {
+	guint window;
+
 	/* sanity check */
 	if (self->percentage == percentage)
 		return;
 	self->percentage = percentage;
 
-	g_debug("Emitting PropertyChanged('Percentage'='%u%%')", percentage);
-	fu_daemon_emit_property_changed(self, "Percentage", g_variant_new_uint32(percentage));
+	/* always emit the start and end, and anything outside the rate limit */
+	window = fu_daemon_get_coalesce_window(self);
+	if (window == 0 || percentage == 0 || percentage == 100 ||
+	    g_get_monotonic_time() - self->percentage_emitted >= (gint64)window * 1000) {
+		self->percentage_pending = G_MAXUINT;
+		fu_daemon_emit_percentage(self, percentage);
+		return;
+	}
+
+	/* only the latest value is emitted when the window expires */
+	self->percentage_pending = percentage;
+	fu_daemon_schedule_pending(self, window);
 }
 
 static void
@@ -706,7 +894,7 @@ fu_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer use
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -723,12 +911,12 @@ fu_daemon_authorize_activate_cb(GObject *source, GAsyncResult *res, gpointer use
 
 	/* authenticated */
 	if (!fu_engine_activate(helper->self->engine, helper->device_id, progress, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -740,7 +928,7 @@ fu_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -757,12 +945,12 @@ fu_daemon_authorize_verify_update_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* authenticated */
 	if (!fu_engine_verify_update(helper->self->engine, helper->device_id, progress, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 static void
@@ -773,7 +961,7 @@ fu_daemon_authorize_modify_remote_cb(GObject *source, GAsyncResult *res, gpointe
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -783,12 +971,12 @@ fu_daemon_authorize_modify_remote_cb(GObject *source, GAsyncResult *res, gpointe
 				     helper->key,
 				     helper->value,
 				     &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 
 #ifdef HAVE_GIO_UNIX
@@ -803,7 +991,7 @@ fu_daemon_authorize_install_cb(GObject *source, GAsyncResult *res, gpointer user
 
 	/* get result */
 	if (!fu_polkit_authority_check_finish(FU_POLKIT_AUTHORITY(source), res, &error)) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
@@ -862,12 +1050,12 @@ fu_daemon_authorize_install_queue(FuMainAuthHelper *helper_ref)
 	if (self->pending_stop)
 		g_main_loop_quit(self->loop);
 	if (!ret) {
-		fu_daemon_method_invocation_return_gerror(helper->invocation, error);
+		fu_daemon_method_invocation_return_gerror(helper->self, helper->invocation, error);
 		return;
 	}
 
 	/* success */
-	g_dbus_method_invocation_return_value(helper->invocation, NULL);
+	fu_daemon_method_invocation_return_value(helper->self, helper->invocation, NULL);
 }
 #endif /* HAVE_GIO_UNIX */
 
@@ -1161,995 +1349,1310 @@ fu_daemon_client_flags_notify_cb(FuClient *client, GParamSpec *pspec, FuMainAuth
 }
 #endif
 
+typedef enum {
+	/* must not run at the same time as an update */
+	FU_DAEMON_METHOD_FLAG_NONE = 0,
+	/* does not change engine or device state, and so can be called during an update */
+	FU_DAEMON_METHOD_FLAG_READ_ONLY = 1 << 0,
+} FuDaemonMethodFlags;
+
+typedef struct FuDaemonMethodItem FuDaemonMethodItem;
+
+typedef struct {
+	const FuDaemonMethodItem *item;
+	const gchar *sender;
+	GVariant *parameters;
+	GDBusMethodInvocation *invocation;
+	FuEngineRequest *request; /* nullable, can be stolen */
+	FuPolkitAuthorityCheckFlags auth_flags;
+} FuDaemonMethodCall;
+
+struct FuDaemonMethodItem {
+	const gchar *name;
+	const gchar *action_id; /* nullable */
+	FuDaemonMethodFlags flags;
+	void (*func)(FuDaemon *self, FuDaemonMethodCall *call);
+};
+
 static void
-fu_daemon_daemon_method_call(GDBusConnection *connection,
-			     const gchar *sender,
-			     const gchar *object_path,
-			     const gchar *interface_name,
-			     const gchar *method_name,
-			     GVariant *parameters,
-			     GDBusMethodInvocation *invocation,
-			     gpointer user_data)
+fu_daemon_method_get_devices(FuDaemon *self, FuDaemonMethodCall *call)
 {
-	FuPolkitAuthorityCheckFlags auth_flags =
-	    FU_POLKIT_AUTHORITY_CHECK_FLAG_ALLOW_USER_INTERACTION;
-	FuDaemon *self = FU_DAEMON(user_data);
 	GVariant *val = NULL;
-	g_autoptr(FuEngineRequest) request = NULL;
 	g_autoptr(GError) error = NULL;
-
-	/* build request */
-	request = fu_daemon_create_request(self, sender, &error);
-	if (request == NULL) {
-		fu_daemon_method_invocation_return_gerror(invocation, error);
+	g_autoptr(GPtrArray) devices = NULL;
+	g_debug("Called %s()", call->item->name);
+	devices = fu_engine_get_devices(self->engine, &error);
+	if (devices == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+		return;
+	}
+	val = fu_daemon_device_array_to_variant(self, call->request, devices, &error);
+	if (val == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (fu_engine_request_has_device_flag(request, FWUPD_DEVICE_FLAG_TRUSTED))
-		auth_flags |= FU_POLKIT_AUTHORITY_CHECK_FLAG_USER_IS_TRUSTED;
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
 
-	/* activity */
-	fu_engine_idle_reset(self->engine);
+static void
+fu_daemon_method_get_plugins(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_debug("Called %s()", call->item->name);
+	val = fu_daemon_plugin_array_to_variant(fu_engine_get_plugins(self->engine));
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
 
-	if (g_strcmp0(method_name, "GetDevices") == 0) {
-		g_autoptr(GPtrArray) devices = NULL;
-		g_debug("Called %s()", method_name);
-		devices = fu_engine_get_devices(self->engine, &error);
-		if (devices == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_daemon_device_array_to_variant(self, request, devices, &error);
-		if (val == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		g_dbus_method_invocation_return_value(invocation, val);
+static void
+fu_daemon_method_get_metrics(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_debug("Called %s()", call->item->name);
+	val = fu_metrics_to_variant(fu_engine_get_metrics(self->engine));
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
+
+static void
+fu_daemon_method_get_startup_profile(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	const gchar *format;
+	g_autofree gchar *str = NULL;
+	g_autoptr(GError) error = NULL;
+
+	g_variant_get(call->parameters, "(&s)", &format);
+	g_debug("Called %s(%s)", call->item->name, format);
+	str = fu_profiler_to_string(fu_engine_get_profiler(self->engine), format, &error);
+	if (str == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetPlugins") == 0) {
-		g_debug("Called %s()", method_name);
-		val = fu_daemon_plugin_array_to_variant(fu_engine_get_plugins(self->engine));
-		g_dbus_method_invocation_return_value(invocation, val);
+	fu_daemon_method_invocation_return_value(self, call->invocation, g_variant_new("(s)", str));
+}
+
+static void
+fu_daemon_method_get_releases(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id;
+	g_autoptr(GPtrArray) releases = NULL;
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetReleases") == 0) {
-		const gchar *device_id;
-		g_autoptr(GPtrArray) releases = NULL;
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		releases = fu_engine_get_releases(self->engine, request, device_id, &error);
-		if (releases == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_daemon_release_array_to_variant(releases);
-		g_dbus_method_invocation_return_value(invocation, val);
+	releases = fu_engine_get_releases(self->engine, call->request, device_id, &error);
+	if (releases == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetApprovedFirmware") == 0) {
-		GVariantBuilder builder;
-		GPtrArray *checksums = fu_engine_get_approved_firmware(self->engine);
-		g_variant_builder_init(&builder, G_VARIANT_TYPE("as"));
-		for (guint i = 0; i < checksums->len; i++) {
-			const gchar *checksum = g_ptr_array_index(checksums, i);
-			g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
-		}
-		val = g_variant_builder_end(&builder);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
-		return;
+	val = fu_daemon_release_array_to_variant(releases);
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
+
+static void
+fu_daemon_method_get_approved_firmware(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	GVariantBuilder builder;
+	GPtrArray *checksums = fu_engine_get_approved_firmware(self->engine);
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("as"));
+	for (guint i = 0; i < checksums->len; i++) {
+		const gchar *checksum = g_ptr_array_index(checksums, i);
+		g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
 	}
-	if (g_strcmp0(method_name, "GetBlockedFirmware") == 0) {
-		GVariantBuilder builder;
-		GPtrArray *checksums = fu_engine_get_blocked_firmware(self->engine);
-		g_variant_builder_init(&builder, G_VARIANT_TYPE("as"));
-		for (guint i = 0; i < checksums->len; i++) {
-			const gchar *checksum = g_ptr_array_index(checksums, i);
-			g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
-		}
-		val = g_variant_builder_end(&builder);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
-		return;
+	val = g_variant_builder_end(&builder);
+	fu_daemon_method_invocation_return_value(self,
+						 call->invocation,
+						 g_variant_new_tuple(&val, 1));
+}
+
+static void
+fu_daemon_method_get_blocked_firmware(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	GVariantBuilder builder;
+	GPtrArray *checksums = fu_engine_get_blocked_firmware(self->engine);
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("as"));
+	for (guint i = 0; i < checksums->len; i++) {
+		const gchar *checksum = g_ptr_array_index(checksums, i);
+		g_variant_builder_add_value(&builder, g_variant_new_string(checksum));
 	}
-	if (g_strcmp0(method_name, "GetReportMetadata") == 0) {
-		GHashTableIter iter;
-		GVariantBuilder builder;
-		const gchar *key;
-		const gchar *value;
-		g_autoptr(GHashTable) metadata = NULL;
+	val = g_variant_builder_end(&builder);
+	fu_daemon_method_invocation_return_value(self,
+						 call->invocation,
+						 g_variant_new_tuple(&val, 1));
+}
 
-		metadata = fu_engine_get_report_metadata(self->engine, &error);
-		if (metadata == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		g_variant_builder_init(&builder, G_VARIANT_TYPE("a{ss}"));
-		g_hash_table_iter_init(&iter, metadata);
-		while (g_hash_table_iter_next(&iter, (gpointer *)&key, (gpointer *)&value)) {
-			g_variant_builder_add_value(&builder, g_variant_new("{ss}", key, value));
-		}
-		val = g_variant_builder_end(&builder);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+static void
+fu_daemon_method_get_report_metadata(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	GHashTableIter iter;
+	GVariantBuilder builder;
+	const gchar *key;
+	const gchar *value;
+	g_autoptr(GHashTable) metadata = NULL;
+
+	metadata = fu_engine_get_report_metadata(self->engine, &error);
+	if (metadata == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "SetApprovedFirmware") == 0) {
-		g_autofree gchar *checksums_str = NULL;
-		g_auto(GStrv) checksums = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a{ss}"));
+	g_hash_table_iter_init(&iter, metadata);
+	while (g_hash_table_iter_next(&iter, (gpointer *)&key, (gpointer *)&value)) {
+		g_variant_builder_add_value(&builder, g_variant_new("{ss}", key, value));
+	}
+	val = g_variant_builder_end(&builder);
+	fu_daemon_method_invocation_return_value(self,
+						 call->invocation,
+						 g_variant_new_tuple(&val, 1));
+}
 
-		g_variant_get(parameters, "(^as)", &checksums);
-		checksums_str = g_strjoinv(",", checksums);
-		g_debug("Called %s(%s)", method_name, checksums_str);
+static void
+fu_daemon_method_set_approved_firmware(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autofree gchar *checksums_str = NULL;
+	g_auto(GStrv) checksums = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
 
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->flags = FWUPD_INSTALL_FLAG_NO_SEARCH;
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->checksums = g_ptr_array_new_with_free_func(g_free);
-		for (guint i = 0; checksums[i] != NULL; i++)
-			g_ptr_array_add(helper->checksums, g_strdup(checksums[i]));
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.set-approved-firmware",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_set_approved_firmware_cb,
-					  g_steal_pointer(&helper));
+	g_variant_get(call->parameters, "(^as)", &checksums);
+	checksums_str = g_strjoinv(",", checksums);
+	g_debug("Called %s(%s)", call->item->name, checksums_str);
+
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->flags = FWUPD_INSTALL_FLAG_NO_SEARCH;
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->checksums = g_ptr_array_new_with_free_func(g_free);
+	for (guint i = 0; checksums[i] != NULL; i++)
+		g_ptr_array_add(helper->checksums, g_strdup(checksums[i]));
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_set_approved_firmware_cb,
+				  g_steal_pointer(&helper));
+}
+
+static void
+fu_daemon_method_set_blocked_firmware(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autofree gchar *checksums_str = NULL;
+	g_auto(GStrv) checksums = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+	g_variant_get(call->parameters, "(^as)", &checksums);
+	checksums_str = g_strjoinv(",", checksums);
+	g_debug("Called %s(%s)", call->item->name, checksums_str);
+
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->checksums = g_ptr_array_new_with_free_func(g_free);
+	for (guint i = 0; checksums[i] != NULL; i++)
+		g_ptr_array_add(helper->checksums, g_strdup(checksums[i]));
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_set_blocked_firmware_cb,
+				  g_steal_pointer(&helper));
+}
+
+static void
+fu_daemon_method_quit(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	if (!fu_engine_request_has_device_flag(call->request, FWUPD_DEVICE_FLAG_TRUSTED)) {
+		fu_daemon_method_invocation_return_error_literal(self,
+								 call->invocation,
+								 FWUPD_ERROR,
+								 FWUPD_ERROR_PERMISSION_DENIED,
+								 "Permission denied");
 		return;
 	}
-	if (g_strcmp0(method_name, "SetBlockedFirmware") == 0) {
-		g_autofree gchar *checksums_str = NULL;
-		g_auto(GStrv) checksums = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
-		g_variant_get(parameters, "(^as)", &checksums);
-		checksums_str = g_strjoinv(",", checksums);
-		g_debug("Called %s(%s)", method_name, checksums_str);
+	fu_daemon_schedule_process_quit(self);
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
 
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->checksums = g_ptr_array_new_with_free_func(g_free);
-		for (guint i = 0; checksums[i] != NULL; i++)
-			g_ptr_array_add(helper->checksums, g_strdup(checksums[i]));
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.set-approved-firmware",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_set_blocked_firmware_cb,
-					  g_steal_pointer(&helper));
+static void
+fu_daemon_method_self_sign(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *prop_value;
+	const gchar *prop_key;
+	g_autofree gchar *value = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	g_variant_get(call->parameters, "(sa{sv})", &value, &iter);
+	g_debug("Called %s(%s)", call->item->name, value);
+
+	/* get flags */
+	helper = g_new0(FuMainAuthHelper, 1);
+	while (g_variant_iter_next(iter, "{&sv}", &prop_key, &prop_value)) {
+		g_debug("got option %s", prop_key);
+		if (g_strcmp0(prop_key, "add-timestamp") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= JCAT_SIGN_FLAG_ADD_TIMESTAMP;
+		if (g_strcmp0(prop_key, "add-cert") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= JCAT_SIGN_FLAG_ADD_CERT;
+		g_variant_unref(prop_value);
+	}
+
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper->self = self;
+	helper->value = g_steal_pointer(&value);
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_self_sign_cb,
+				  g_steal_pointer(&helper));
+}
+
+static void
+fu_daemon_method_get_downgrades(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id;
+	g_autoptr(GPtrArray) releases = NULL;
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "Quit") == 0) {
-		if (!fu_engine_request_has_device_flag(request, FWUPD_DEVICE_FLAG_TRUSTED)) {
-			g_dbus_method_invocation_return_error_literal(invocation,
-								      FWUPD_ERROR,
-								      FWUPD_ERROR_PERMISSION_DENIED,
-								      "Permission denied");
-			return;
-		}
-		fu_daemon_schedule_process_quit(self);
-		g_dbus_method_invocation_return_value(invocation, NULL);
+	releases = fu_engine_get_downgrades(self->engine, call->request, device_id, &error);
+	if (releases == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "SelfSign") == 0) {
-		GVariant *prop_value;
-		const gchar *prop_key;
-		g_autofree gchar *value = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
-		g_autoptr(GVariantIter) iter = NULL;
-
-		g_variant_get(parameters, "(sa{sv})", &value, &iter);
-		g_debug("Called %s(%s)", method_name, value);
-
-		/* get flags */
-		helper = g_new0(FuMainAuthHelper, 1);
-		while (g_variant_iter_next(iter, "{&sv}", &prop_key, &prop_value)) {
-			g_debug("got option %s", prop_key);
-			if (g_strcmp0(prop_key, "add-timestamp") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= JCAT_SIGN_FLAG_ADD_TIMESTAMP;
-			if (g_strcmp0(prop_key, "add-cert") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= JCAT_SIGN_FLAG_ADD_CERT;
-			g_variant_unref(prop_value);
-		}
+	val = fu_daemon_release_array_to_variant(releases);
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
 
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		helper->self = self;
-		helper->value = g_steal_pointer(&value);
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.self-sign",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_self_sign_cb,
-					  g_steal_pointer(&helper));
+static void
+fu_daemon_method_get_upgrades(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id;
+	g_autoptr(GPtrArray) releases = NULL;
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetDowngrades") == 0) {
-		const gchar *device_id;
-		g_autoptr(GPtrArray) releases = NULL;
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		releases = fu_engine_get_downgrades(self->engine, request, device_id, &error);
-		if (releases == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_daemon_release_array_to_variant(releases);
-		g_dbus_method_invocation_return_value(invocation, val);
+	releases = fu_engine_get_upgrades(self->engine, call->request, device_id, &error);
+	if (releases == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetUpgrades") == 0) {
-		const gchar *device_id;
-		g_autoptr(GPtrArray) releases = NULL;
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		releases = fu_engine_get_upgrades(self->engine, request, device_id, &error);
-		if (releases == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_daemon_release_array_to_variant(releases);
-		g_dbus_method_invocation_return_value(invocation, val);
+	val = fu_daemon_release_array_to_variant(releases);
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
+
+static void
+fu_daemon_method_get_remotes(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) remotes = NULL;
+	g_debug("Called %s()", call->item->name);
+	remotes = fu_engine_get_remotes(self->engine, &error);
+	if (remotes == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetRemotes") == 0) {
-		g_autoptr(GPtrArray) remotes = NULL;
-		g_debug("Called %s()", method_name);
-		remotes = fu_engine_get_remotes(self->engine, &error);
-		if (remotes == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_daemon_remote_array_to_variant(remotes);
-		g_dbus_method_invocation_return_value(invocation, val);
+	val = fu_daemon_remote_array_to_variant(remotes);
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
+
+static void
+fu_daemon_method_get_history(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_debug("Called %s()", call->item->name);
+	devices = fu_engine_get_history(self->engine, &error);
+	if (devices == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetHistory") == 0) {
-		g_autoptr(GPtrArray) devices = NULL;
-		g_debug("Called %s()", method_name);
-		devices = fu_engine_get_history(self->engine, &error);
-		if (devices == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_daemon_device_array_to_variant(self, request, devices, &error);
-		if (val == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		g_dbus_method_invocation_return_value(invocation, val);
+	val = fu_daemon_device_array_to_variant(self, call->request, devices, &error);
+	if (val == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetHostSecurityAttrs") == 0) {
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+}
+
+static void
+fu_daemon_method_get_host_security_attrs(FuDaemon *self, FuDaemonMethodCall *call)
+{
 #ifdef HAVE_HSI
-		g_autoptr(FuSecurityAttrs) attrs = NULL;
+	GVariant *val = NULL;
+	g_autoptr(FuSecurityAttrs) attrs = NULL;
 #endif
-		g_debug("Called %s()", method_name);
+	g_debug("Called %s()", call->item->name);
 #ifndef HAVE_HSI
-		g_dbus_method_invocation_return_error_literal(invocation,
-							      FWUPD_ERROR,
-							      FWUPD_ERROR_NOT_SUPPORTED,
-							      "HSI support not enabled");
+	fu_daemon_method_invocation_return_error_literal(self,
+							 call->invocation,
+							 FWUPD_ERROR,
+							 FWUPD_ERROR_NOT_SUPPORTED,
+							 "HSI support not enabled");
 #else
-		if (self->machine_kind != FU_DAEMON_MACHINE_KIND_PHYSICAL &&
-		    g_getenv("UMOCKDEV_DIR") == NULL) {
-			g_dbus_method_invocation_return_error_literal(
-			    invocation,
-			    FWUPD_ERROR,
-			    FWUPD_ERROR_NOT_SUPPORTED,
-			    "HSI unavailable for hypervisor");
-			return;
-		}
-		attrs = fu_engine_get_host_security_attrs(self->engine);
-		val = fu_security_attrs_to_variant(attrs);
-		g_dbus_method_invocation_return_value(invocation, val);
+	if (self->machine_kind != FU_DAEMON_MACHINE_KIND_PHYSICAL &&
+	    g_getenv("UMOCKDEV_DIR") == NULL) {
+		fu_daemon_method_invocation_return_error_literal(self,
+								 call->invocation,
+								 FWUPD_ERROR,
+								 FWUPD_ERROR_NOT_SUPPORTED,
+								 "HSI unavailable for hypervisor");
+		return;
+	}
+	attrs = fu_engine_get_host_security_attrs(self->engine);
+	val = fu_security_attrs_to_variant(attrs);
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
 #endif
-		return;
-	}
-	if (g_strcmp0(method_name, "GetHostSecurityEvents") == 0) {
-		guint limit = 0;
+}
+
+static void
+fu_daemon_method_get_host_security_events(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	guint limit = 0;
 #ifdef HAVE_HSI
-		g_autoptr(FuSecurityAttrs) attrs = NULL;
+	GVariant *val = NULL;
+	g_autoptr(FuSecurityAttrs) attrs = NULL;
+	g_autoptr(GError) error = NULL;
 #endif
-		g_variant_get(parameters, "(u)", &limit);
-		g_debug("Called %s(%u)", method_name, limit);
+	g_variant_get(call->parameters, "(u)", &limit);
+	g_debug("Called %s(%u)", call->item->name, limit);
 #ifndef HAVE_HSI
-		g_dbus_method_invocation_return_error_literal(invocation,
-							      FWUPD_ERROR,
-							      FWUPD_ERROR_NOT_SUPPORTED,
-							      "HSI support not enabled");
+	fu_daemon_method_invocation_return_error_literal(self,
+							 call->invocation,
+							 FWUPD_ERROR,
+							 FWUPD_ERROR_NOT_SUPPORTED,
+							 "HSI support not enabled");
 #else
-		attrs = fu_engine_get_host_security_events(self->engine, limit, &error);
-		if (attrs == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_security_attrs_to_variant(attrs);
-		g_dbus_method_invocation_return_value(invocation, val);
+	attrs = fu_engine_get_host_security_events(self->engine, limit, &error);
+	if (attrs == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+		return;
+	}
+	val = fu_security_attrs_to_variant(attrs);
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
 #endif
+}
+
+static void
+fu_daemon_method_clear_results(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id;
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_engine_clear_results(self->engine, device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "ClearResults") == 0) {
-		const gchar *device_id;
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_engine_clear_results(self->engine, device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
+
+static void
+fu_daemon_method_emulation_load(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GBytes) data = NULL;
+
+	g_debug("Called %s()", call->item->name);
+
+	/* load data into engine */
+	data = g_variant_get_data_as_bytes(g_variant_get_child_value(call->parameters, 0));
+	if (!fu_engine_emulation_load(self->engine, data, &error)) {
+		fu_daemon_method_invocation_return_error(self,
+							 call->invocation,
+							 error->domain,
+							 error->code,
+							 "failed to load emulation data: %s",
+							 error->message);
 		return;
 	}
-	if (g_strcmp0(method_name, "EmulationLoad") == 0) {
-		g_autoptr(GBytes) data = NULL;
 
-		g_debug("Called %s()", method_name);
+	/* success */
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
 
-		/* load data into engine */
-		data = g_variant_get_data_as_bytes(g_variant_get_child_value(parameters, 0));
-		if (!fu_engine_emulation_load(self->engine, data, &error)) {
-			g_dbus_method_invocation_return_error(invocation,
-							      error->domain,
-							      error->code,
-							      "failed to load emulation data: %s",
-							      error->message);
-			return;
-		}
+static void
+fu_daemon_method_emulation_save(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GBytes) data = NULL;
+
+	g_debug("Called %s()", call->item->name);
 
-		/* success */
-		g_dbus_method_invocation_return_value(invocation, NULL);
+	/* save data from engine */
+	data = fu_engine_emulation_save(self->engine, &error);
+	if (data == NULL) {
+		fu_daemon_method_invocation_return_error(self,
+							 call->invocation,
+							 FWUPD_ERROR,
+							 FWUPD_ERROR_NOT_SUPPORTED,
+							 "failed to save emulation data: %s",
+							 error->message);
 		return;
 	}
-	if (g_strcmp0(method_name, "EmulationSave") == 0) {
-		g_autoptr(GBytes) data = NULL;
+	val = g_variant_new_from_bytes(G_VARIANT_TYPE_BYTESTRING, data, FALSE);
+	fu_daemon_method_invocation_return_value(self,
+						 call->invocation,
+						 g_variant_new_tuple(&val, 1));
+}
 
-		g_debug("Called %s()", method_name);
+static void
+fu_daemon_method_modify_device(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id;
+	const gchar *key = NULL;
+	const gchar *value = NULL;
 
-		/* save data from engine */
-		data = fu_engine_emulation_save(self->engine, &error);
-		if (data == NULL) {
-			g_dbus_method_invocation_return_error(invocation,
-							      FWUPD_ERROR,
-							      FWUPD_ERROR_NOT_SUPPORTED,
-							      "failed to save emulation data: %s",
-							      error->message);
-			return;
-		}
-		val = g_variant_new_from_bytes(G_VARIANT_TYPE_BYTESTRING, data, FALSE);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+	/* check the id exists */
+	g_variant_get(call->parameters, "(&s&s&s)", &device_id, &key, &value);
+	g_debug("Called %s(%s,%s=%s)", call->item->name, device_id, key, value);
+	if (!fu_engine_modify_device(self->engine, device_id, key, value, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "ModifyDevice") == 0) {
-		const gchar *device_id;
-		const gchar *key = NULL;
-		const gchar *value = NULL;
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
 
-		/* check the id exists */
-		g_variant_get(parameters, "(&s&s&s)", &device_id, &key, &value);
-		g_debug("Called %s(%s,%s=%s)", method_name, device_id, key, value);
-		if (!fu_engine_modify_device(self->engine, device_id, key, value, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+static void
+fu_daemon_method_get_results(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id = NULL;
+	g_autoptr(FwupdDevice) result = NULL;
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetResults") == 0) {
-		const gchar *device_id = NULL;
-		g_autoptr(FwupdDevice) result = NULL;
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		result = fu_engine_get_results(self->engine, device_id, &error);
-		if (result == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fwupd_device_to_variant(result);
-		g_dbus_method_invocation_return_value(invocation, g_variant_new_tuple(&val, 1));
+	result = fu_engine_get_results(self->engine, device_id, &error);
+	if (result == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "UpdateMetadata") == 0) {
+	val = fwupd_device_to_variant(result);
+	fu_daemon_method_invocation_return_value(self,
+						 call->invocation,
+						 g_variant_new_tuple(&val, 1));
+}
+
+static void
+fu_daemon_method_update_metadata(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
 #ifdef HAVE_GIO_UNIX
-		GDBusMessage *message;
-		GUnixFDList *fd_list;
-		const gchar *remote_id = NULL;
-		gint fd_data;
-		gint fd_sig;
-
-		g_variant_get(parameters, "(&shh)", &remote_id, &fd_data, &fd_sig);
-		g_debug("Called %s(%s,%i,%i)", method_name, remote_id, fd_data, fd_sig);
-
-		/* update the metadata store */
-		message = g_dbus_method_invocation_get_message(invocation);
-		fd_list = g_dbus_message_get_unix_fd_list(message);
-		if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 2) {
-			g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		fd_data = g_unix_fd_list_get(fd_list, 0, &error);
-		if (fd_data < 0) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		fd_sig = g_unix_fd_list_get(fd_list, 1, &error);
-		if (fd_sig < 0) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
+	GDBusMessage *message;
+	GUnixFDList *fd_list;
+	const gchar *remote_id = NULL;
+	gint fd_data;
+	gint fd_sig;
 
-		/* store new metadata (will close the fds when done) */
-		if (!fu_engine_update_metadata(self->engine, remote_id, fd_data, fd_sig, &error)) {
-			g_prefix_error(&error, "Failed to update metadata for %s: ", remote_id);
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
-#else
-		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
-		fu_daemon_method_invocation_return_gerror(invocation, error);
-#endif /* HAVE_GIO_UNIX */
+	g_variant_get(call->parameters, "(&shh)", &remote_id, &fd_data, &fd_sig);
+	g_debug("Called %s(%s,%i,%i)", call->item->name, remote_id, fd_data, fd_sig);
+
+	/* update the metadata store */
+	message = g_dbus_method_invocation_get_message(call->invocation);
+	fd_list = g_dbus_message_get_unix_fd_list(message);
+	if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 2) {
+		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "Unlock") == 0) {
-		const gchar *device_id = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
-
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->device_id = g_strdup(device_id);
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.device-unlock",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_unlock_cb,
-					  g_steal_pointer(&helper));
+	fd_data = g_unix_fd_list_get(fd_list, 0, &error);
+	if (fd_data < 0) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "Activate") == 0) {
-		const gchar *device_id = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
-		g_variant_get(parameters, "(&s)", &device_id);
-
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->device_id = g_strdup(device_id);
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.device-activate",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_activate_cb,
-					  g_steal_pointer(&helper));
+	fd_sig = g_unix_fd_list_get(fd_list, 1, &error);
+	if (fd_sig < 0) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "ModifyConfig") == 0) {
-		g_autofree gchar *key = NULL;
-		g_autofree gchar *section = NULL;
-		g_autofree gchar *value = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
 
-		g_variant_get(parameters, "(sss)", &section, &key, &value);
-		g_debug("Called %s([%s] %s=%s)", method_name, section, key, value);
-
-		/* authenticate */
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->section = g_steal_pointer(&section);
-		helper->key = g_steal_pointer(&key);
-		helper->value = g_steal_pointer(&value);
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.modify-config",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_modify_config_cb,
-					  g_steal_pointer(&helper));
+	/* store new metadata (will close the fds when done) */
+	if (!fu_engine_update_metadata(self->engine, remote_id, fd_data, fd_sig, &error)) {
+		g_prefix_error(&error, "Failed to update metadata for %s: ", remote_id);
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "ResetConfig") == 0) {
-		g_autofree gchar *section = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+#else
+	g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
+	fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+#endif /* HAVE_GIO_UNIX */
+}
 
-		g_variant_get(parameters, "(s)", &section);
-		g_debug("Called %s(%s)", method_name, section);
+static void
+fu_daemon_method_unlock(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
 
-		/* authenticate */
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->section = g_steal_pointer(&section);
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.reset-config",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_reset_config_cb,
-					  g_steal_pointer(&helper));
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "ModifyRemote") == 0) {
-		const gchar *remote_id = NULL;
-		const gchar *key = NULL;
-		const gchar *value = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
 
-		/* check the id exists */
-		g_variant_get(parameters, "(&s&s&s)", &remote_id, &key, &value);
-		g_debug("Called %s(%s,%s=%s)", method_name, remote_id, key, value);
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->device_id = g_strdup(device_id);
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_unlock_cb,
+				  g_steal_pointer(&helper));
+}
 
-		/* create helper object */
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->remote_id = g_strdup(remote_id);
-		helper->key = g_strdup(key);
-		helper->value = g_strdup(value);
-		helper->self = self;
+static void
+fu_daemon_method_activate(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+	g_variant_get(call->parameters, "(&s)", &device_id);
 
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.modify-remote",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_modify_remote_cb,
-					  g_steal_pointer(&helper));
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "VerifyUpdate") == 0) {
-		const gchar *device_id = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
 
-		/* check the id exists */
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->device_id = g_strdup(device_id);
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_activate_cb,
+				  g_steal_pointer(&helper));
+}
 
-		/* create helper object */
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->device_id = g_strdup(device_id);
-		helper->self = self;
+static void
+fu_daemon_method_modify_config(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autofree gchar *key = NULL;
+	g_autofree gchar *section = NULL;
+	g_autofree gchar *value = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+
+	g_variant_get(call->parameters, "(sss)", &section, &key, &value);
+	g_debug("Called %s([%s] %s=%s)", call->item->name, section, key, value);
+
+	/* authenticate */
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->section = g_steal_pointer(&section);
+	helper->key = g_steal_pointer(&key);
+	helper->value = g_steal_pointer(&value);
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_modify_config_cb,
+				  g_steal_pointer(&helper));
+}
 
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.verify-update",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_verify_update_cb,
-					  g_steal_pointer(&helper));
+static void
+fu_daemon_method_reset_config(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autofree gchar *section = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+
+	g_variant_get(call->parameters, "(s)", &section);
+	g_debug("Called %s(%s)", call->item->name, section);
+
+	/* authenticate */
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->section = g_steal_pointer(&section);
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_reset_config_cb,
+				  g_steal_pointer(&helper));
+}
+
+static void
+fu_daemon_method_modify_remote(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	const gchar *remote_id = NULL;
+	const gchar *key = NULL;
+	const gchar *value = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+
+	/* check the id exists */
+	g_variant_get(call->parameters, "(&s&s&s)", &remote_id, &key, &value);
+	g_debug("Called %s(%s,%s=%s)", call->item->name, remote_id, key, value);
+
+	/* create helper object */
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->remote_id = g_strdup(remote_id);
+	helper->key = g_strdup(key);
+	helper->value = g_strdup(value);
+	helper->self = self;
+
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_modify_remote_cb,
+				  g_steal_pointer(&helper));
+}
+
+static void
+fu_daemon_method_verify_update(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+
+	/* check the id exists */
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "Verify") == 0) {
-		const gchar *device_id = NULL;
-		g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
 
-		g_variant_get(parameters, "(&s)", &device_id);
-		g_debug("Called %s(%s)", method_name, device_id);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
+	/* create helper object */
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->device_id = g_strdup(device_id);
+	helper->self = self;
 
-		/* progress */
-		fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
-		g_signal_connect(FU_PROGRESS(progress),
-				 "percentage-changed",
-				 G_CALLBACK(fu_daemon_progress_percentage_changed_cb),
-				 self);
-		g_signal_connect(FU_PROGRESS(progress),
-				 "status-changed",
-				 G_CALLBACK(fu_daemon_progress_status_changed_cb),
-				 self);
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_verify_update_cb,
+				  g_steal_pointer(&helper));
+}
 
-		if (!fu_engine_verify(self->engine, device_id, progress, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
+static void
+fu_daemon_method_verify(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+	const gchar *device_id = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+
+	g_variant_get(call->parameters, "(&s)", &device_id);
+	g_debug("Called %s(%s)", call->item->name, device_id);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "SetFeatureFlags") == 0) {
-		guint64 feature_flags_u64 = 0;
-		g_autoptr(FuClient) client = NULL;
 
-		g_variant_get(parameters, "(t)", &feature_flags_u64);
-		g_debug("Called %s(%" G_GUINT64_FORMAT ")", method_name, feature_flags_u64);
+	/* progress */
+	fu_progress_set_profile(progress, g_getenv("FWUPD_VERBOSE") != NULL);
+	g_signal_connect(FU_PROGRESS(progress),
+			 "percentage-changed",
+			 G_CALLBACK(fu_daemon_progress_percentage_changed_cb),
+			 self);
+	g_signal_connect(FU_PROGRESS(progress),
+			 "status-changed",
+			 G_CALLBACK(fu_daemon_progress_status_changed_cb),
+			 self);
 
-		/* old flags for the same sender will be automatically destroyed */
-		client = fu_client_list_register(self->client_list, sender);
-		fu_client_set_feature_flags(client, feature_flags_u64);
-		g_dbus_method_invocation_return_value(invocation, NULL);
+	if (!fu_engine_verify(self->engine, device_id, progress, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "SetHints") == 0) {
-		const gchar *prop_key;
-		const gchar *prop_value;
-		g_autoptr(FuClient) client = NULL;
-		g_autoptr(GVariantIter) iter = NULL;
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
 
-		g_variant_get(parameters, "(a{ss})", &iter);
-		g_debug("Called %s()", method_name);
-		client = fu_client_list_register(self->client_list, sender);
-		while (g_variant_iter_next(iter, "{&s&s}", &prop_key, &prop_value)) {
-			g_debug("got hint %s=%s", prop_key, prop_value);
-			fu_client_insert_hint(client, prop_key, prop_value);
-		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
-		return;
-	}
-	if (g_strcmp0(method_name, "Inhibit") == 0) {
-		FuDaemonSystemInhibit *inhibit;
-		const gchar *reason = NULL;
-
-		g_variant_get(parameters, "(&s)", &reason);
-		g_debug("Called %s(%s)", method_name, reason);
-
-		/* watch */
-		inhibit = g_new0(FuDaemonSystemInhibit, 1);
-		inhibit->sender = g_strdup(sender);
-		inhibit->id = g_strdup_printf("dbus-%i", g_random_int_range(1, G_MAXINT - 1));
-		inhibit->watcher_id =
-		    g_bus_watch_name_on_connection(self->connection,
-						   sender,
-						   G_BUS_NAME_WATCHER_FLAGS_NONE,
-						   NULL,
-						   fu_daemon_inhibit_name_vanished_cb,
-						   self,
-						   NULL);
-		g_ptr_array_add(self->system_inhibits, inhibit);
-		fu_daemon_ensure_system_inhibit(self);
-		g_dbus_method_invocation_return_value(invocation,
-						      g_variant_new("(s)", inhibit->id));
-		return;
-	}
-	if (g_strcmp0(method_name, "Uninhibit") == 0) {
-		const gchar *inhibit_id = NULL;
-		gboolean found = FALSE;
-
-		g_variant_get(parameters, "(&s)", &inhibit_id);
-		g_debug("Called %s(%s)", method_name, inhibit_id);
-
-		/* find by id, then uninhibit device */
-		for (guint i = 0; i < self->system_inhibits->len; i++) {
-			FuDaemonSystemInhibit *inhibit =
-			    g_ptr_array_index(self->system_inhibits, i);
-			if (g_strcmp0(inhibit->id, inhibit_id) == 0) {
-				g_ptr_array_remove_index(self->system_inhibits, i);
-				fu_daemon_ensure_system_inhibit(self);
-				found = TRUE;
-				break;
-			}
-		}
-		if (!found) {
-			g_dbus_method_invocation_return_error_literal(invocation,
-								      FWUPD_ERROR,
-								      FWUPD_ERROR_NOT_FOUND,
-								      "Cannot find inhibit ID");
-			return;
-		}
-		g_dbus_method_invocation_return_value(invocation, NULL);
-		return;
+static void
+fu_daemon_method_set_feature_flags(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	guint64 feature_flags_u64 = 0;
+	g_autoptr(FuClient) client = NULL;
+
+	g_variant_get(call->parameters, "(t)", &feature_flags_u64);
+	g_debug("Called %s(%" G_GUINT64_FORMAT ")", call->item->name, feature_flags_u64);
+
+	/* old flags for the same call->sender will be automatically destroyed */
+	client = fu_client_list_register(self->client_list, call->sender);
+	fu_client_set_feature_flags(client, feature_flags_u64);
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
+
+static void
+fu_daemon_method_set_hints(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	const gchar *prop_key;
+	const gchar *prop_value;
+	g_autoptr(FuClient) client = NULL;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	g_variant_get(call->parameters, "(a{ss})", &iter);
+	g_debug("Called %s()", call->item->name);
+	client = fu_client_list_register(self->client_list, call->sender);
+	while (g_variant_iter_next(iter, "{&s&s}", &prop_key, &prop_value)) {
+		g_debug("got hint %s=%s", prop_key, prop_value);
+		fu_client_insert_hint(client, prop_key, prop_value);
 	}
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
 
-	if (g_strcmp0(method_name, "Install") == 0) {
-#ifdef HAVE_GIO_UNIX
-		GVariant *prop_value;
-		const gchar *device_id = NULL;
-		const gchar *prop_key;
-		gint32 fd_handle = 0;
-		gint fd;
-		GDBusMessage *message;
-		GUnixFDList *fd_list;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
-		g_autoptr(GVariantIter) iter = NULL;
+static void
+fu_daemon_method_inhibit(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	FuDaemonSystemInhibit *inhibit;
+	const gchar *reason = NULL;
+
+	g_variant_get(call->parameters, "(&s)", &reason);
+	g_debug("Called %s(%s)", call->item->name, reason);
+
+	/* watch */
+	inhibit = g_new0(FuDaemonSystemInhibit, 1);
+	inhibit->sender = g_strdup(call->sender);
+	inhibit->id = g_strdup_printf("dbus-%i", g_random_int_range(1, G_MAXINT - 1));
+	inhibit->watcher_id =
+	    g_bus_watch_name_on_connection(self->connection,
+					   call->sender,
+					   G_BUS_NAME_WATCHER_FLAGS_NONE,
+					   NULL,
+					   fu_daemon_inhibit_name_vanished_cb,
+					   self,
+					   NULL);
+	g_ptr_array_add(self->system_inhibits, inhibit);
+	fu_daemon_ensure_system_inhibit(self);
+	fu_daemon_method_invocation_return_value(self,
+						 call->invocation,
+						 g_variant_new("(s)", inhibit->id));
+}
 
-		/* check the id exists */
-		g_variant_get(parameters, "(&sha{sv})", &device_id, &fd_handle, &iter);
-		g_debug("Called %s(%s,%i)", method_name, device_id, fd_handle);
-		if (!fu_daemon_device_id_valid(device_id, &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
+static void
+fu_daemon_method_uninhibit(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	const gchar *inhibit_id = NULL;
+	gboolean found = FALSE;
 
-		/* create helper object */
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->request = g_steal_pointer(&request);
-		helper->progress = fu_progress_new(G_STRLOC);
-		helper->invocation = g_object_ref(invocation);
-		helper->device_id = g_strdup(device_id);
-		helper->self = self;
+	g_variant_get(call->parameters, "(&s)", &inhibit_id);
+	g_debug("Called %s(%s)", call->item->name, inhibit_id);
 
-		/* get flags */
-		while (g_variant_iter_next(iter, "{&sv}", &prop_key, &prop_value)) {
-			g_debug("got option %s", prop_key);
-			if (g_strcmp0(prop_key, "offline") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= FWUPD_INSTALL_FLAG_OFFLINE;
-			if (g_strcmp0(prop_key, "allow-older") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= FWUPD_INSTALL_FLAG_ALLOW_OLDER;
-			if (g_strcmp0(prop_key, "allow-reinstall") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= FWUPD_INSTALL_FLAG_ALLOW_REINSTALL;
-			if (g_strcmp0(prop_key, "allow-branch-switch") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= FWUPD_INSTALL_FLAG_ALLOW_BRANCH_SWITCH;
-			if (g_strcmp0(prop_key, "force") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= FWUPD_INSTALL_FLAG_FORCE;
-			if (g_strcmp0(prop_key, "no-history") == 0 &&
-			    g_variant_get_boolean(prop_value) == TRUE)
-				helper->flags |= FWUPD_INSTALL_FLAG_NO_HISTORY;
-			g_variant_unref(prop_value);
+	/* find by id, then uninhibit device */
+	for (guint i = 0; i < self->system_inhibits->len; i++) {
+		FuDaemonSystemInhibit *inhibit =
+		    g_ptr_array_index(self->system_inhibits, i);
+		if (g_strcmp0(inhibit->id, inhibit_id) == 0) {
+			g_ptr_array_remove_index(self->system_inhibits, i);
+			fu_daemon_ensure_system_inhibit(self);
+			found = TRUE;
+			break;
 		}
+	}
+	if (!found) {
+		fu_daemon_method_invocation_return_error_literal(self,
+								 call->invocation,
+								 FWUPD_ERROR,
+								 FWUPD_ERROR_NOT_FOUND,
+								 "Cannot find inhibit ID");
+		return;
+	}
+	fu_daemon_method_invocation_return_value(self, call->invocation, NULL);
+}
+
+static void
+fu_daemon_method_install(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(GError) error = NULL;
+#ifdef HAVE_GIO_UNIX
+	GVariant *prop_value;
+	const gchar *device_id = NULL;
+	const gchar *prop_key;
+	gint32 fd_handle = 0;
+	gint fd;
+	GDBusMessage *message;
+	GUnixFDList *fd_list;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	/* check the id exists */
+	g_variant_get(call->parameters, "(&sha{sv})", &device_id, &fd_handle, &iter);
+	g_debug("Called %s(%s,%i)", call->item->name, device_id, fd_handle);
+	if (!fu_daemon_device_id_valid(device_id, &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+		return;
+	}
+
+	/* create helper object */
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->request = g_steal_pointer(&call->request);
+	helper->progress = fu_progress_new(G_STRLOC);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->device_id = g_strdup(device_id);
+	helper->self = self;
+
+	/* get flags */
+	while (g_variant_iter_next(iter, "{&sv}", &prop_key, &prop_value)) {
+		g_debug("got option %s", prop_key);
+		if (g_strcmp0(prop_key, "offline") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= FWUPD_INSTALL_FLAG_OFFLINE;
+		if (g_strcmp0(prop_key, "allow-older") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= FWUPD_INSTALL_FLAG_ALLOW_OLDER;
+		if (g_strcmp0(prop_key, "allow-reinstall") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= FWUPD_INSTALL_FLAG_ALLOW_REINSTALL;
+		if (g_strcmp0(prop_key, "allow-branch-switch") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= FWUPD_INSTALL_FLAG_ALLOW_BRANCH_SWITCH;
+		if (g_strcmp0(prop_key, "force") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= FWUPD_INSTALL_FLAG_FORCE;
+		if (g_strcmp0(prop_key, "no-history") == 0 &&
+		    g_variant_get_boolean(prop_value) == TRUE)
+			helper->flags |= FWUPD_INSTALL_FLAG_NO_HISTORY;
+		g_variant_unref(prop_value);
+	}
 
 #ifndef HAVE_FWUPDOFFLINE
-		if (helper->flags & FWUPD_INSTALL_FLAG_OFFLINE) {
-			g_set_error(&error,
-				    FWUPD_ERROR,
-				    FWUPD_ERROR_INTERNAL,
-				    "no offline support");
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
+	if (helper->flags & FWUPD_INSTALL_FLAG_OFFLINE) {
+		g_set_error(&error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "no offline support");
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+		return;
+	}
 #endif
-		/* get the fd */
-		message = g_dbus_method_invocation_get_message(invocation);
-		fd_list = g_dbus_message_get_unix_fd_list(message);
-		if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 1) {
-			g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		fd = g_unix_fd_list_get(fd_list, 0, &error);
-		if (fd < 0) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		helper->stream = fu_unix_seekable_input_stream_new(fd, TRUE);
-
-		/* install all the things in the store */
-		helper->client = fu_client_list_register(self->client_list, sender);
-		helper->client_sender_changed_id =
-		    g_signal_connect(FU_CLIENT(helper->client),
-				     "notify::flags",
-				     G_CALLBACK(fu_daemon_client_flags_notify_cb),
-				     helper);
-		if (!fu_daemon_install_with_helper(g_steal_pointer(&helper), &error)) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-#else
-		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
-		fu_daemon_method_invocation_return_gerror(invocation, error);
-#endif /* HAVE_GIO_UNIX */
-
-		/* async return */
+	/* get the fd */
+	message = g_dbus_method_invocation_get_message(call->invocation);
+	fd_list = g_dbus_message_get_unix_fd_list(message);
+	if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 1) {
+		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetDetails") == 0) {
-#ifdef HAVE_GIO_UNIX
-		GDBusMessage *message;
-		GUnixFDList *fd_list;
-		gint32 fd_handle = 0;
-		gint fd;
-		g_autoptr(GPtrArray) results = NULL;
-		g_autoptr(GInputStream) stream = NULL;
-
-		/* get parameters */
-		g_variant_get(parameters, "(h)", &fd_handle);
-		g_debug("Called %s(%i)", method_name, fd_handle);
-
-		/* get the fd */
-		message = g_dbus_method_invocation_get_message(invocation);
-		fd_list = g_dbus_message_get_unix_fd_list(message);
-		if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 1) {
-			g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		fd = g_unix_fd_list_get(fd_list, 0, &error);
-		if (fd < 0) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
+	fd = g_unix_fd_list_get(fd_list, 0, &error);
+	if (fd < 0) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+		return;
+	}
+	helper->stream = fu_unix_seekable_input_stream_new(fd, TRUE);
 
-		/* get details about the file (will close the fd when done) */
-		stream = fu_unix_seekable_input_stream_new(fd, TRUE);
-		if (stream == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		results = fu_engine_get_details(self->engine, request, stream, &error);
-		if (results == NULL) {
-			fu_daemon_method_invocation_return_gerror(invocation, error);
-			return;
-		}
-		val = fu_daemon_result_array_to_variant(results);
-		g_dbus_method_invocation_return_value(invocation, val);
+	/* install all the things in the store */
+	helper->client = fu_client_list_register(self->client_list, call->sender);
+	helper->client_sender_changed_id =
+	    g_signal_connect(FU_CLIENT(helper->client),
+			     "notify::flags",
+			     G_CALLBACK(fu_daemon_client_flags_notify_cb),
+			     helper);
+	if (!fu_daemon_install_with_helper(g_steal_pointer(&helper), &error)) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+		return;
+	}
 #else
-		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
-		fu_daemon_method_invocation_return_gerror(invocation, error);
+	g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
+	fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 #endif /* HAVE_GIO_UNIX */
+}
+
+static void
+fu_daemon_method_get_details(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	g_autoptr(GError) error = NULL;
+#ifdef HAVE_GIO_UNIX
+	GDBusMessage *message;
+	GUnixFDList *fd_list;
+	gint32 fd_handle = 0;
+	gint fd;
+	g_autoptr(GPtrArray) results = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+
+	/* get call->parameters */
+	g_variant_get(call->parameters, "(h)", &fd_handle);
+	g_debug("Called %s(%i)", call->item->name, fd_handle);
+
+	/* get the fd */
+	message = g_dbus_method_invocation_get_message(call->invocation);
+	fd_list = g_dbus_message_get_unix_fd_list(message);
+	if (fd_list == NULL || g_unix_fd_list_get_length(fd_list) != 1) {
+		g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "invalid handle");
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "GetBiosSettings") == 0) {
-		gboolean authenticate = fu_engine_request_get_feature_flags(request) &
-					FWUPD_FEATURE_FLAG_ALLOW_AUTHENTICATION;
-
-		g_debug("Called %s", method_name);
-		if (!authenticate) {
-			/* if we cannot authenticate and the peer is not
-			 * inherently trusted, only return a non-sensitive
-			 * subset of the settings */
-			g_autoptr(FuBiosSettings) attrs =
-			    fu_context_get_bios_settings(fu_engine_get_context(self->engine));
-			val = fu_bios_settings_to_variant(
-			    attrs,
-			    fu_engine_request_get_device_flags(request) &
-				FWUPD_DEVICE_FLAG_TRUSTED);
-			g_dbus_method_invocation_return_value(invocation, val);
-		} else {
-			g_autoptr(FuMainAuthHelper) helper = NULL;
-
-			/* authenticate */
-			fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-			helper = g_new0(FuMainAuthHelper, 1);
-			helper->self = self;
-			helper->request = g_steal_pointer(&request);
-			helper->invocation = g_object_ref(invocation);
-			fu_polkit_authority_check(self->authority,
-						  sender,
-						  "org.freedesktop.fwupd.get-bios-settings",
-						  auth_flags,
-						  NULL,
-						  fu_daemon_authorize_get_bios_settings_cb,
-						  g_steal_pointer(&helper));
-		}
+	fd = g_unix_fd_list_get(fd_list, 0, &error);
+	if (fd < 0) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "SetBiosSettings") == 0) {
-		g_autoptr(FuMainAuthHelper) helper = NULL;
-		const gchar *key;
-		const gchar *value;
-		g_autoptr(GVariantIter) iter = NULL;
 
-		g_variant_get(parameters, "(a{ss})", &iter);
-		g_debug("Called %s()", method_name);
-
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->bios_settings =
-		    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
-		while (g_variant_iter_next(iter, "{&s&s}", &key, &value)) {
-			g_debug("got setting %s=%s", key, value);
-			g_hash_table_insert(helper->bios_settings, g_strdup(key), g_strdup(value));
-		}
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.set-bios-settings",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_set_bios_settings_cb,
-					  g_steal_pointer(&helper));
+	/* get details about the file (will close the fd when done) */
+	stream = fu_unix_seekable_input_stream_new(fd, TRUE);
+	if (stream == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
 		return;
 	}
-	if (g_strcmp0(method_name, "FixHostSecurityAttr") == 0) {
-		const gchar *appstream_id = NULL;
+	results = fu_engine_get_details(self->engine, call->request, stream, &error);
+	if (results == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+		return;
+	}
+	val = fu_daemon_result_array_to_variant(results);
+	fu_daemon_method_invocation_return_value(self, call->invocation, val);
+#else
+	g_set_error(&error, FWUPD_ERROR, FWUPD_ERROR_INTERNAL, "unsupported feature");
+	fu_daemon_method_invocation_return_gerror(self, call->invocation, error);
+#endif /* HAVE_GIO_UNIX */
+}
+
+static void
+fu_daemon_method_get_bios_settings(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	GVariant *val = NULL;
+	gboolean authenticate = fu_engine_request_get_feature_flags(call->request) &
+				FWUPD_FEATURE_FLAG_ALLOW_AUTHENTICATION;
+
+	g_debug("Called %s", call->item->name);
+	if (!authenticate) {
+		/* if we cannot authenticate and the peer is not
+		 * inherently trusted, only return a non-sensitive
+		 * subset of the settings */
+		g_autoptr(FuBiosSettings) attrs =
+		    fu_context_get_bios_settings(fu_engine_get_context(self->engine));
+		val = fu_bios_settings_to_variant(
+		    attrs,
+		    fu_engine_request_get_device_flags(call->request) &
+			FWUPD_DEVICE_FLAG_TRUSTED);
+		fu_daemon_method_invocation_return_value(self, call->invocation, val);
+	} else {
 		g_autoptr(FuMainAuthHelper) helper = NULL;
-		g_variant_get(parameters, "(&s)", &appstream_id);
-		g_debug("Called %s(%s)", method_name, appstream_id);
 
 		/* authenticate */
 		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
 		helper = g_new0(FuMainAuthHelper, 1);
 		helper->self = self;
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->key = g_strdup(appstream_id);
-		helper->is_fix = TRUE;
+		helper->request = g_steal_pointer(&call->request);
+		helper->invocation = g_object_ref(call->invocation);
 		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.fix-host-security-attr",
-					  auth_flags,
+					  call->sender,
+					  call->item->action_id,
+					  call->auth_flags,
 					  NULL,
-					  fu_daemon_authorize_fix_host_security_attr_cb,
+					  fu_daemon_authorize_get_bios_settings_cb,
 					  g_steal_pointer(&helper));
+	}
+}
+
+static void
+fu_daemon_method_set_bios_settings(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+	const gchar *key;
+	const gchar *value;
+	g_autoptr(GVariantIter) iter = NULL;
+
+	g_variant_get(call->parameters, "(a{ss})", &iter);
+	g_debug("Called %s()", call->item->name);
+
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->bios_settings =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	while (g_variant_iter_next(iter, "{&s&s}", &key, &value)) {
+		g_debug("got setting %s=%s", key, value);
+		g_hash_table_insert(helper->bios_settings, g_strdup(key), g_strdup(value));
+	}
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_set_bios_settings_cb,
+				  g_steal_pointer(&helper));
+}
+
+static void
+fu_daemon_method_fix_host_security_attr(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	const gchar *appstream_id = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+	g_variant_get(call->parameters, "(&s)", &appstream_id);
+	g_debug("Called %s(%s)", call->item->name, appstream_id);
+
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->key = g_strdup(appstream_id);
+	helper->is_fix = TRUE;
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_fix_host_security_attr_cb,
+				  g_steal_pointer(&helper));
+}
+
+static void
+fu_daemon_method_undo_host_security_attr(FuDaemon *self, FuDaemonMethodCall *call)
+{
+	const gchar *appstream_id = NULL;
+	g_autoptr(FuMainAuthHelper) helper = NULL;
+	g_variant_get(call->parameters, "(&s)", &appstream_id);
+	g_debug("Called %s(%s)", call->item->name, appstream_id);
+
+	/* authenticate */
+	fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
+	helper = g_new0(FuMainAuthHelper, 1);
+	helper->self = self;
+	helper->request = g_steal_pointer(&call->request);
+	helper->invocation = g_object_ref(call->invocation);
+	helper->key = g_strdup(appstream_id);
+	helper->is_fix = FALSE;
+	fu_polkit_authority_check(self->authority,
+				  call->sender,
+				  call->item->action_id,
+				  call->auth_flags,
+				  NULL,
+				  fu_daemon_authorize_undo_host_security_attr_cb,
+				  g_steal_pointer(&helper));
+}
+
+static const FuDaemonMethodItem fu_daemon_methods[] = {
+	{"Activate",
+	 "org.freedesktop.fwupd.device-activate",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_activate},
+	{"ClearResults", NULL, FU_DAEMON_METHOD_FLAG_NONE, fu_daemon_method_clear_results},
+	{"EmulationLoad", NULL, FU_DAEMON_METHOD_FLAG_NONE, fu_daemon_method_emulation_load},
+	{"EmulationSave", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_emulation_save},
+	{"FixHostSecurityAttr",
+	 "org.freedesktop.fwupd.fix-host-security-attr",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_fix_host_security_attr},
+	{"GetApprovedFirmware",
+	 NULL,
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_get_approved_firmware},
+	{"GetBiosSettings",
+	 "org.freedesktop.fwupd.get-bios-settings",
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_get_bios_settings},
+	{"GetBlockedFirmware",
+	 NULL,
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_get_blocked_firmware},
+	{"GetDetails", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_details},
+	{"GetDevices", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_devices},
+	{"GetDowngrades", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_downgrades},
+	{"GetHistory", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_history},
+	{"GetHostSecurityAttrs",
+	 NULL,
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_get_host_security_attrs},
+	{"GetHostSecurityEvents",
+	 NULL,
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_get_host_security_events},
+	{"GetMetrics", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_metrics},
+	{"GetPlugins", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_plugins},
+	{"GetReleases", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_releases},
+	{"GetRemotes", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_remotes},
+	{"GetReportMetadata",
+	 NULL,
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_get_report_metadata},
+	{"GetResults", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_results},
+	{"GetStartupProfile",
+	 NULL,
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_get_startup_profile},
+	{"GetUpgrades", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_get_upgrades},
+	{"Inhibit", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_inhibit},
+	{"Install", NULL, FU_DAEMON_METHOD_FLAG_NONE, fu_daemon_method_install},
+	{"ModifyConfig",
+	 "org.freedesktop.fwupd.modify-config",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_modify_config},
+	{"ModifyDevice", NULL, FU_DAEMON_METHOD_FLAG_NONE, fu_daemon_method_modify_device},
+	{"ModifyRemote",
+	 "org.freedesktop.fwupd.modify-remote",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_modify_remote},
+	{"Quit", NULL, FU_DAEMON_METHOD_FLAG_NONE, fu_daemon_method_quit},
+	{"ResetConfig",
+	 "org.freedesktop.fwupd.reset-config",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_reset_config},
+	{"SelfSign",
+	 "org.freedesktop.fwupd.self-sign",
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_self_sign},
+	{"SetApprovedFirmware",
+	 "org.freedesktop.fwupd.set-approved-firmware",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_set_approved_firmware},
+	{"SetBiosSettings",
+	 "org.freedesktop.fwupd.set-bios-settings",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_set_bios_settings},
+	{"SetBlockedFirmware",
+	 "org.freedesktop.fwupd.set-approved-firmware",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_set_blocked_firmware},
+	{"SetFeatureFlags",
+	 NULL,
+	 FU_DAEMON_METHOD_FLAG_READ_ONLY,
+	 fu_daemon_method_set_feature_flags},
+	{"SetHints", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_set_hints},
+	{"UndoHostSecurityAttr",
+	 "org.freedesktop.fwupd.undo-host-security-attr",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_undo_host_security_attr},
+	{"Uninhibit", NULL, FU_DAEMON_METHOD_FLAG_READ_ONLY, fu_daemon_method_uninhibit},
+	{"Unlock",
+	 "org.freedesktop.fwupd.device-unlock",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_unlock},
+	{"UpdateMetadata", NULL, FU_DAEMON_METHOD_FLAG_NONE, fu_daemon_method_update_metadata},
+	{"Verify", NULL, FU_DAEMON_METHOD_FLAG_NONE, fu_daemon_method_verify},
+	{"VerifyUpdate",
+	 "org.freedesktop.fwupd.verify-update",
+	 FU_DAEMON_METHOD_FLAG_NONE,
+	 fu_daemon_method_verify_update},
+};
+
+static void
+fu_daemon_daemon_method_call(GDBusConnection *connection,
+			     const gchar *sender,
+			     const gchar *object_path,
+			     const gchar *interface_name,
+			     const gchar *method_name,
+			     GVariant *parameters,
+			     GDBusMethodInvocation *invocation,
+			     gpointer user_data)
+{
+	FuDaemon *self = FU_DAEMON(user_data);
+	gint64 *start;
+	const FuDaemonMethodItem *item;
+	g_autoptr(GError) error = NULL;
+	FuDaemonMethodCall call = {
+	    .item = NULL,
+	    .sender = sender,
+	    .parameters = parameters,
+	    .invocation = invocation,
+	    .auth_flags = FU_POLKIT_AUTHORITY_CHECK_FLAG_ALLOW_USER_INTERACTION,
+	};
+
+	/* find the method */
+	item = g_hash_table_lookup(self->methods,
+				   GUINT_TO_POINTER(g_quark_try_string(method_name)));
+	if (item == NULL) {
+		fu_daemon_method_invocation_return_error(self,
+							 invocation,
+							 G_DBUS_ERROR,
+							 G_DBUS_ERROR_UNKNOWN_METHOD,
+							 "no such method %s",
+							 method_name);
+		return;
+	}
+	call.item = item;
+
+	/* the engine is iterated when waiting for replug, so only allow things that do not
+	 * modify device or engine state to be called during an update */
+	if (self->update_in_progress && (item->flags & FU_DAEMON_METHOD_FLAG_READ_ONLY) == 0) {
+		fu_daemon_method_invocation_return_error(self,
+							 invocation,
+							 FWUPD_ERROR,
+							 FWUPD_ERROR_BUSY,
+							 "Cannot call %s during an update",
+							 method_name);
 		return;
 	}
-	if (g_strcmp0(method_name, "UndoHostSecurityAttr") == 0) {
-		const gchar *appstream_id = NULL;
-		g_autoptr(FuMainAuthHelper) helper = NULL;
-		g_variant_get(parameters, "(&s)", &appstream_id);
-		g_debug("Called %s(%s)", method_name, appstream_id);
 
-		/* authenticate */
-		fu_daemon_set_status(self, FWUPD_STATUS_WAITING_FOR_AUTH);
-		helper = g_new0(FuMainAuthHelper, 1);
-		helper->self = self;
-		helper->request = g_steal_pointer(&request);
-		helper->invocation = g_object_ref(invocation);
-		helper->key = g_strdup(appstream_id);
-		helper->is_fix = FALSE;
-		fu_polkit_authority_check(self->authority,
-					  sender,
-					  "org.freedesktop.fwupd.undo-host-security-attr",
-					  auth_flags,
-					  NULL,
-					  fu_daemon_authorize_undo_host_security_attr_cb,
-					  g_steal_pointer(&helper));
+	/* build request */
+	call.request = fu_daemon_create_request(self, sender, &error);
+	if (call.request == NULL) {
+		fu_daemon_method_invocation_return_gerror(self, invocation, error);
 		return;
 	}
-	g_dbus_method_invocation_return_error(invocation,
-					      G_DBUS_ERROR,
-					      G_DBUS_ERROR_UNKNOWN_METHOD,
-					      "no such method %s",
-					      method_name);
+	if (fu_engine_request_has_device_flag(call.request, FWUPD_DEVICE_FLAG_TRUSTED))
+		call.auth_flags |= FU_POLKIT_AUTHORITY_CHECK_FLAG_USER_IS_TRUSTED;
+
+	/* activity */
+	fu_engine_idle_reset(self->engine);
+
+	/* the metric is added on return, which may be after an authentication check */
+	start = g_new(gint64, 1);
+	*start = g_get_monotonic_time();
+	g_object_set_data_full(G_OBJECT(invocation), "fwupd::StartTime", start, g_free);
+	item->func(self, &call);
+	g_clear_object(&call.request);
 }
 
 static GVariant *
@@ -2569,6 +3072,16 @@ static void
 fu_daemon_init(FuDaemon *self)
 {
 	self->status = FWUPD_STATUS_IDLE;
+	self->percentage_pending = G_MAXUINT;
+	self->pending_devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	self->methods = g_hash_table_new(g_direct_hash, g_direct_equal);
+	for (guint i = 0; i < G_N_ELEMENTS(fu_daemon_methods); i++) {
+		const FuDaemonMethodItem *item = &fu_daemon_methods[i];
+		g_hash_table_insert(self->methods,
+				    GUINT_TO_POINTER(g_quark_from_static_string(item->name)),
+				    (gpointer)item);
+	}
+	self->sender_uids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->loop = g_main_loop_new(NULL, FALSE);
 	self->system_inhibits =
 	    g_ptr_array_new_with_free_func((GDestroyNotify)fu_daemon_system_inhibit_free);
@@ -2580,6 +3093,11 @@ fu_daemon_finalize(GObject *obj)
 	FuDaemon *self = FU_DAEMON(obj);
 
 	g_ptr_array_unref(self->system_inhibits);
+	g_ptr_array_unref(self->pending_devices);
+	g_hash_table_unref(self->methods);
+	g_hash_table_unref(self->sender_uids);
+	if (self->pending_id != 0)
+		g_source_remove(self->pending_id);
 	if (self->client_list != NULL)
 		g_object_unref(self->client_list);
 	if (self->process_quit_id != 0)
@@ -34,6 +34,10 @@ struct _FuDeviceList {
 	GObject parent_instance;
 	GPtrArray *devices; /* of FuDeviceItem */
 	GRWLock devices_mutex;
+	GMutex index_mutex;	      /* for guid_index, connection_index and item_seq */
+	GHashTable *guid_index;	      /* (element-type utf8 GPtrArray<FuDeviceItem>) */
+	GHashTable *connection_index; /* (element-type utf8 GPtrArray<FuDeviceItem>) */
+	guint64 item_seq;
 };
 
 enum { SIGNAL_ADDED, SIGNAL_REMOVED, SIGNAL_CHANGED, SIGNAL_LAST };
@@ -45,6 +49,12 @@ typedef struct {
 	FuDevice *device_old;
 	FuDeviceList *self; /* no ref */
 	guint remove_id;
+	guint64 seq;		    /* the order in ->devices */
+	gboolean indexed;	    /* in ->devices */
+	GPtrArray *guid_keys;	    /* (element-type utf8) */
+	GPtrArray *connection_keys; /* (element-type utf8) */
+	gulong device_notify_ids[3];
+	gulong device_old_notify_ids[3];
 } FuDeviceItem;
 
 G_DEFINE_TYPE(FuDeviceList, fu_device_list, G_TYPE_OBJECT)
@@ -225,6 +235,185 @@ fu_device_list_get_active(FuDeviceList *self)
 	return devices;
 }
 
+/* index_mutex must be held */
+static void
+fu_device_list_index_insert(GHashTable *index, GPtrArray *keys, const gchar *key, FuDeviceItem *item)
+{
+	GPtrArray *items = g_hash_table_lookup(index, key);
+	if (items == NULL) {
+		items = g_ptr_array_new();
+		g_hash_table_insert(index, g_strdup(key), items);
+	}
+	if (g_ptr_array_find(items, item, NULL))
+		return;
+	g_ptr_array_add(items, item);
+	g_ptr_array_add(keys, g_strdup(key));
+}
+
+/* index_mutex must be held */
+static void
+fu_device_list_index_remove(GHashTable *index, GPtrArray *keys, FuDeviceItem *item)
+{
+	for (guint i = 0; i < keys->len; i++) {
+		const gchar *key = g_ptr_array_index(keys, i);
+		GPtrArray *items = g_hash_table_lookup(index, key);
+		if (items == NULL)
+			continue;
+		g_ptr_array_remove(items, item);
+		if (items->len == 0)
+			g_hash_table_remove(index, key);
+	}
+	g_ptr_array_set_size(keys, 0);
+}
+
+/* index_mutex must be held */
+static void
+fu_device_list_index_guids(FuDeviceList *self, FuDeviceItem *item)
+{
+	fu_device_list_index_remove(self->guid_index, item->guid_keys, item);
+	if (!item->indexed)
+		return;
+	if (item->device != NULL) {
+		GPtrArray *guids = fu_device_get_guids(item->device);
+		for (guint i = 0; i < guids->len; i++) {
+			const gchar *guid = g_ptr_array_index(guids, i);
+			fu_device_list_index_insert(self->guid_index, item->guid_keys, guid, item);
+		}
+	}
+	if (item->device_old != NULL) {
+		GPtrArray *guids = fu_device_get_guids(item->device_old);
+		for (guint i = 0; i < guids->len; i++) {
+			const gchar *guid = g_ptr_array_index(guids, i);
+			fu_device_list_index_insert(self->guid_index, item->guid_keys, guid, item);
+		}
+	}
+}
+
+static gchar *
+fu_device_list_connection_key(const gchar *physical_id, const gchar *logical_id)
+{
+	return g_strdup_printf("%s\n%s", physical_id, logical_id != NULL ? logical_id : "");
+}
+
+/* index_mutex must be held */
+static void
+fu_device_list_index_connections(FuDeviceList *self, FuDeviceItem *item)
+{
+	FuDevice *devices[] = {item->device, item->device_old};
+
+	fu_device_list_index_remove(self->connection_index, item->connection_keys, item);
+	if (!item->indexed)
+		return;
+	for (guint i = 0; i < G_N_ELEMENTS(devices); i++) {
+		g_autofree gchar *key = NULL;
+		if (devices[i] == NULL || fu_device_get_physical_id(devices[i]) == NULL)
+			continue;
+		key = fu_device_list_connection_key(fu_device_get_physical_id(devices[i]),
+						    fu_device_get_logical_id(devices[i]));
+		fu_device_list_index_insert(self->connection_index,
+					    item->connection_keys,
+					    key,
+					    item);
+	}
+}
+
+static void
+fu_device_list_item_reindex(FuDeviceItem *item)
+{
+	FuDeviceList *self = FU_DEVICE_LIST(item->self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->index_mutex);
+	fu_device_list_index_guids(self, item);
+	fu_device_list_index_connections(self, item);
+}
+
+static void
+fu_device_list_item_notify_connection_cb(FuDevice *device, GParamSpec *pspec, gpointer user_data)
+{
+	FuDeviceItem *item = (FuDeviceItem *)user_data;
+	FuDeviceList *self = FU_DEVICE_LIST(item->self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->index_mutex);
+	fu_device_list_index_connections(self, item);
+}
+
+static void
+fu_device_list_item_guid_added_cb(FuDevice *device, const gchar *guid, gpointer user_data)
+{
+	FuDeviceItem *item = (FuDeviceItem *)user_data;
+	FuDeviceList *self = FU_DEVICE_LIST(item->self);
+	g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&self->index_mutex);
+	if (!item->indexed)
+		return;
+	fu_device_list_index_insert(self->guid_index, item->guid_keys, guid, item);
+}
+
+static void
+fu_device_list_item_insert(FuDeviceList *self, FuDeviceItem *item)
+{
+	g_rw_lock_writer_lock(&self->devices_mutex);
+	g_mutex_lock(&self->index_mutex);
+	item->seq = self->item_seq++;
+	item->indexed = TRUE;
+	fu_device_list_index_guids(self, item);
+	fu_device_list_index_connections(self, item);
+	g_mutex_unlock(&self->index_mutex);
+	g_ptr_array_add(self->devices, item);
+	g_rw_lock_writer_unlock(&self->devices_mutex);
+}
+
+static void
+fu_device_list_item_remove(FuDeviceList *self, FuDeviceItem *item)
+{
+	g_rw_lock_writer_lock(&self->devices_mutex);
+	g_mutex_lock(&self->index_mutex);
+	item->indexed = FALSE;
+	fu_device_list_index_guids(self, item);
+	fu_device_list_index_connections(self, item);
+	g_mutex_unlock(&self->index_mutex);
+	g_ptr_array_remove(self->devices, item);
+	g_rw_lock_writer_unlock(&self->devices_mutex);
+}
+
+typedef gboolean (*FuDeviceListMatchFunc)(FuDevice *device, gconstpointer user_data);
+
+/* returns the earliest-added item where the device (or failing that, the old device) matches */
+static FuDeviceItem *
+fu_device_list_items_find_first(GPtrArray *items,
+				FuDeviceListMatchFunc match_cb,
+				gconstpointer user_data,
+				gboolean removed_only)
+{
+	FuDeviceItem *item_best = NULL;
+	for (guint i = 0; i < items->len; i++) {
+		FuDeviceItem *item = g_ptr_array_index(items, i);
+		if (removed_only && item->remove_id == 0)
+			continue;
+		if (item_best != NULL && item->seq > item_best->seq)
+			continue;
+		if (match_cb(item->device, user_data))
+			item_best = item;
+	}
+	if (item_best != NULL)
+		return item_best;
+	for (guint i = 0; i < items->len; i++) {
+		FuDeviceItem *item = g_ptr_array_index(items, i);
+		if (item->device_old == NULL)
+			continue;
+		if (removed_only && item->remove_id == 0)
+			continue;
+		if (item_best != NULL && item->seq > item_best->seq)
+			continue;
+		if (match_cb(item->device_old, user_data))
+			item_best = item;
+	}
+	return item_best;
+}
+
+static gboolean
+fu_device_list_match_guid_cb(FuDevice *device, gconstpointer user_data)
+{
+	return fwupd_device_has_guid(FWUPD_DEVICE(device), (const gchar *)user_data);
+}
+
 static FuDeviceItem *
 fu_device_list_find_by_device(FuDeviceList *self, FuDevice *device)
 {
@@ -246,21 +435,37 @@ fu_device_list_find_by_device(FuDeviceList *self, FuDevice *device)
 static FuDeviceItem *
 fu_device_list_find_by_guid(FuDeviceList *self, const gchar *guid)
 {
+	GPtrArray *items;
+	g_autofree gchar *guid_tmp = NULL;
 	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	g_autoptr(GMutexLocker) index_locker = NULL;
+
 	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (fu_device_has_guid(item->device, guid))
-			return item;
-	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (item->device_old == NULL)
-			continue;
-		if (fu_device_has_guid(item->device_old, guid))
-			return item;
+
+	/* make valid */
+	if (!fwupd_guid_is_valid(guid)) {
+		guid_tmp = fwupd_guid_hash_string(guid);
+		guid = guid_tmp;
 	}
-	return NULL;
+
+	index_locker = g_mutex_locker_new(&self->index_mutex);
+	items = g_hash_table_lookup(self->guid_index, guid);
+	if (items == NULL)
+		return NULL;
+	return fu_device_list_items_find_first(items, fu_device_list_match_guid_cb, guid, FALSE);
+}
+
+typedef struct {
+	const gchar *physical_id;
+	const gchar *logical_id;
+} FuDeviceListConnectionHelper;
+
+static gboolean
+fu_device_list_match_connection_cb(FuDevice *device, gconstpointer user_data)
+{
+	const FuDeviceListConnectionHelper *helper = (const FuDeviceListConnectionHelper *)user_data;
+	return g_strcmp0(fu_device_get_physical_id(device), helper->physical_id) == 0 &&
+	       g_strcmp0(fu_device_get_logical_id(device), helper->logical_id) == 0;
 }
 
 static FuDeviceItem *
@@ -268,28 +473,26 @@ fu_device_list_find_by_connection(FuDeviceList *self,
 				  const gchar *physical_id,
 				  const gchar *logical_id)
 {
+	GPtrArray *items;
+	FuDeviceListConnectionHelper helper = {.physical_id = physical_id,
+					       .logical_id = logical_id};
+	g_autofree gchar *key = NULL;
 	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_autoptr(GMutexLocker) index_locker = NULL;
+
 	if (physical_id == NULL)
 		return NULL;
 	locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
 	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		FuDevice *device = item_tmp->device;
-		if (device != NULL &&
-		    g_strcmp0(fu_device_get_physical_id(device), physical_id) == 0 &&
-		    g_strcmp0(fu_device_get_logical_id(device), logical_id) == 0)
-			return item_tmp;
-	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item_tmp = g_ptr_array_index(self->devices, i);
-		FuDevice *device = item_tmp->device_old;
-		if (device != NULL &&
-		    g_strcmp0(fu_device_get_physical_id(device), physical_id) == 0 &&
-		    g_strcmp0(fu_device_get_logical_id(device), logical_id) == 0)
-			return item_tmp;
-	}
-	return NULL;
+	index_locker = g_mutex_locker_new(&self->index_mutex);
+	key = fu_device_list_connection_key(physical_id, logical_id);
+	items = g_hash_table_lookup(self->connection_index, key);
+	if (items == NULL)
+		return NULL;
+	return fu_device_list_items_find_first(items,
+					       fu_device_list_match_connection_cb,
+					       &helper,
+					       FALSE);
 }
 
 static FuDeviceItem *
@@ -367,34 +570,41 @@ fu_device_list_get_old(FuDeviceList *self, FuDevice *device)
 	return g_object_ref(item->device_old);
 }
 
+static gboolean
+fu_device_list_match_guids_cb(FuDevice *device, gconstpointer user_data)
+{
+	GPtrArray *guids = (GPtrArray *)user_data;
+	for (guint i = 0; i < guids->len; i++) {
+		const gchar *guid = g_ptr_array_index(guids, i);
+		if (fu_device_has_guid(device, guid))
+			return TRUE;
+	}
+	return FALSE;
+}
+
 static FuDeviceItem *
 fu_device_list_get_by_guids_removed(FuDeviceList *self, GPtrArray *guids)
 {
+	g_autoptr(GPtrArray) items = g_ptr_array_new();
 	g_autoptr(GRWLockReaderLocker) locker = g_rw_lock_reader_locker_new(&self->devices_mutex);
+	g_autoptr(GMutexLocker) index_locker = NULL;
+
 	g_return_val_if_fail(locker != NULL, NULL);
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (item->remove_id == 0)
-			continue;
-		for (guint j = 0; j < guids->len; j++) {
-			const gchar *guid = g_ptr_array_index(guids, j);
-			if (fu_device_has_guid(item->device, guid))
-				return item;
-		}
-	}
-	for (guint i = 0; i < self->devices->len; i++) {
-		FuDeviceItem *item = g_ptr_array_index(self->devices, i);
-		if (item->device_old == NULL)
-			continue;
-		if (item->remove_id == 0)
+
+	/* all the items sharing at least one GUID */
+	index_locker = g_mutex_locker_new(&self->index_mutex);
+	for (guint j = 0; j < guids->len; j++) {
+		const gchar *guid = g_ptr_array_index(guids, j);
+		GPtrArray *items_tmp = g_hash_table_lookup(self->guid_index, guid);
+		if (items_tmp == NULL)
 			continue;
-		for (guint j = 0; j < guids->len; j++) {
-			const gchar *guid = g_ptr_array_index(guids, j);
-			if (fu_device_has_guid(item->device_old, guid))
-				return item;
+		for (guint i = 0; i < items_tmp->len; i++) {
+			FuDeviceItem *item = g_ptr_array_index(items_tmp, i);
+			if (!g_ptr_array_find(items, item, NULL))
+				g_ptr_array_add(items, item);
 		}
 	}
-	return NULL;
+	return fu_device_list_items_find_first(items, fu_device_list_match_guids_cb, guids, TRUE);
 }
 
 static gboolean
@@ -419,18 +629,14 @@ fu_device_list_device_delayed_remove_cb(gpointer user_data)
 				continue;
 			}
 			fu_device_list_emit_device_removed(self, child);
-			g_rw_lock_writer_lock(&self->devices_mutex);
-			g_ptr_array_remove(self->devices, child_item);
-			g_rw_lock_writer_unlock(&self->devices_mutex);
+			fu_device_list_item_remove(self, child_item);
 		}
 	}
 
 	/* just remove now */
 	g_info("doing delayed removal");
 	fu_device_list_emit_device_removed(self, item->device);
-	g_rw_lock_writer_lock(&self->devices_mutex);
-	g_ptr_array_remove(self->devices, item);
-	g_rw_lock_writer_unlock(&self->devices_mutex);
+	fu_device_list_item_remove(self, item);
 	return G_SOURCE_REMOVE;
 }
 
@@ -517,17 +723,13 @@ fu_device_list_remove(FuDeviceList *self, FuDevice *device)
 				continue;
 			}
 			fu_device_list_emit_device_removed(self, child);
-			g_rw_lock_writer_lock(&self->devices_mutex);
-			g_ptr_array_remove(self->devices, child_item);
-			g_rw_lock_writer_unlock(&self->devices_mutex);
+			fu_device_list_item_remove(self, child_item);
 		}
 	}
 
 	/* remove right now */
 	fu_device_list_emit_device_removed(self, item->device);
-	g_rw_lock_writer_lock(&self->devices_mutex);
-	g_ptr_array_remove(self->devices, item);
-	g_rw_lock_writer_unlock(&self->devices_mutex);
+	fu_device_list_item_remove(self, item);
 }
 
 static void
@@ -559,9 +761,35 @@ fu_device_list_item_finalized_cb(gpointer data, GObject *where_the_object_was)
 	g_critical("FuDevice %p was finalized without being removed from "
 		   "FuDeviceList, removing item!",
 		   where_the_object_was);
-	g_rw_lock_writer_lock(&self->devices_mutex);
-	g_ptr_array_remove(self->devices, item);
-	g_rw_lock_writer_unlock(&self->devices_mutex);
+
+	/* the signal handlers have already been destroyed */
+	memset(item->device_notify_ids, 0, sizeof(item->device_notify_ids));
+	fu_device_list_item_remove(self, item);
+}
+
+static void
+fu_device_list_item_watch(FuDeviceItem *item, FuDevice *device, gulong *notify_ids)
+{
+	notify_ids[0] = g_signal_connect(FU_DEVICE(device),
+					 "notify::physical-id",
+					 G_CALLBACK(fu_device_list_item_notify_connection_cb),
+					 item);
+	notify_ids[1] = g_signal_connect(FU_DEVICE(device),
+					 "notify::logical-id",
+					 G_CALLBACK(fu_device_list_item_notify_connection_cb),
+					 item);
+	notify_ids[2] = g_signal_connect(FU_DEVICE(device),
+					 "guid-added",
+					 G_CALLBACK(fu_device_list_item_guid_added_cb),
+					 item);
+}
+
+static void
+fu_device_list_item_unwatch(FuDevice *device, gulong *notify_ids)
+{
+	g_clear_signal_handler(&notify_ids[0], device);
+	g_clear_signal_handler(&notify_ids[1], device);
+	g_clear_signal_handler(&notify_ids[2], device);
 }
 
 /* this should never be required, and yet here we are */
@@ -570,13 +798,25 @@ fu_device_list_item_set_device(FuDeviceItem *item, FuDevice *device)
 {
 	if (item->device != NULL) {
 		g_object_weak_unref(G_OBJECT(item->device), fu_device_list_item_finalized_cb, item);
+		fu_device_list_item_unwatch(item->device, item->device_notify_ids);
 	}
 	if (device != NULL) {
 		g_object_weak_ref(G_OBJECT(device), fu_device_list_item_finalized_cb, item);
+		fu_device_list_item_watch(item, device, item->device_notify_ids);
 	}
 	g_set_object(&item->device, device);
 }
 
+static void
+fu_device_list_item_set_device_old(FuDeviceItem *item, FuDevice *device_old)
+{
+	if (item->device_old != NULL)
+		fu_device_list_item_unwatch(item->device_old, item->device_old_notify_ids);
+	if (device_old != NULL)
+		fu_device_list_item_watch(item, device_old, item->device_old_notify_ids);
+	g_set_object(&item->device_old, device_old);
+}
+
 static void
 fu_device_list_clear_wait_for_replug(FuDeviceList *self, FuDeviceItem *item)
 {
@@ -707,8 +947,9 @@ fu_device_list_replace(FuDeviceList *self, FuDeviceItem *item, FuDevice *device)
 	fu_device_incorporate_update_state(item->device, device);
 
 	/* assign the new device */
-	g_set_object(&item->device_old, item->device);
+	fu_device_list_item_set_device_old(item, item->device);
 	fu_device_list_item_set_device(item, device);
+	fu_device_list_item_reindex(item);
 	fu_device_list_emit_device_changed(self, device);
 
 	/* debug */
@@ -767,8 +1008,9 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 						       FU_DEVICE_INTERNAL_FLAG_UNCONNECTED);
 			fu_device_incorporate_problem_update_in_progress(device, item->device);
 			fu_device_incorporate_update_state(device, item->device);
-			g_set_object(&item->device_old, item->device);
+			fu_device_list_item_set_device_old(item, item->device);
 			fu_device_list_item_set_device(item, device);
+			fu_device_list_item_reindex(item);
 			fu_device_list_clear_wait_for_replug(self, item);
 			fu_device_list_emit_device_changed(self, device);
 			return;
@@ -818,10 +1060,10 @@ fu_device_list_add(FuDeviceList *self, FuDevice *device)
 	/* add helper */
 	item = g_new0(FuDeviceItem, 1);
 	item->self = self; /* no ref */
+	item->guid_keys = g_ptr_array_new_with_free_func(g_free);
+	item->connection_keys = g_ptr_array_new_with_free_func(g_free);
 	fu_device_list_item_set_device(item, device);
-	g_rw_lock_writer_lock(&self->devices_mutex);
-	g_ptr_array_add(self->devices, item);
-	g_rw_lock_writer_unlock(&self->devices_mutex);
+	fu_device_list_item_insert(self, item);
 	fu_device_list_emit_device_added(self, device);
 }
 
@@ -864,6 +1106,14 @@ fu_device_list_get_wait_for_replug(FuDeviceList *self)
 	return devices;
 }
 
+static gboolean
+fu_device_list_wait_for_replug_timeout_cb(gpointer user_data)
+{
+	gboolean *timed_out = (gboolean *)user_data;
+	*timed_out = TRUE;
+	return G_SOURCE_REMOVE;
+}
+
 /**
  * fu_device_list_wait_for_replug:
  * @self: a device list
@@ -880,8 +1130,9 @@ fu_device_list_get_wait_for_replug(FuDeviceList *self)
 gboolean
 fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
 {
+	gboolean timed_out = FALSE;
 	guint remove_delay = 0;
-	g_autoptr(GTimer) timer = g_timer_new();
+	guint timeout_id;
 	g_autoptr(GPtrArray) devices_wfr1 = NULL;
 	g_autoptr(GPtrArray) devices_wfr2 = NULL;
 
@@ -912,15 +1163,17 @@ fu_device_list_wait_for_replug(FuDeviceList *self, GError **error)
 		g_info("waiting %ums for replug", remove_delay);
 	}
 
-	/* time to unplug and then re-plug */
-	do {
-		g_autoptr(GPtrArray) devices_wfr_tmp = NULL;
-		g_usleep(1000);
-		g_main_context_iteration(NULL, FALSE);
-		devices_wfr_tmp = fu_device_list_get_wait_for_replug(self);
+	/* time to unplug and then re-plug, only waking up to process events */
+	timeout_id =
+	    g_timeout_add(remove_delay, fu_device_list_wait_for_replug_timeout_cb, &timed_out);
+	while (!timed_out) {
+		g_autoptr(GPtrArray) devices_wfr_tmp = fu_device_list_get_wait_for_replug(self);
 		if (devices_wfr_tmp->len == 0)
 			break;
-	} while (g_timer_elapsed(timer, NULL) * 1000.f < remove_delay);
+		g_main_context_iteration(NULL, TRUE);
+	}
+	if (!timed_out)
+		g_source_remove(timeout_id);
 
 	/* check that no other devices are still waiting for replug */
 	devices_wfr2 = fu_device_list_get_wait_for_replug(self);
@@ -1006,9 +1259,10 @@ fu_device_list_item_free(FuDeviceItem *item)
 {
 	if (item->remove_id != 0)
 		g_source_remove(item->remove_id);
-	if (item->device_old != NULL)
-		g_object_unref(item->device_old);
+	fu_device_list_item_set_device_old(item, NULL);
 	fu_device_list_item_set_device(item, NULL);
+	g_ptr_array_unref(item->guid_keys);
+	g_ptr_array_unref(item->connection_keys);
 	g_free(item);
 }
 
@@ -1075,7 +1329,12 @@ static void
 fu_device_list_init(FuDeviceList *self)
 {
 	self->devices = g_ptr_array_new_with_free_func((GDestroyNotify)fu_device_list_item_free);
+	self->guid_index =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+	self->connection_index =
+	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
 	g_rw_lock_init(&self->devices_mutex);
+	g_mutex_init(&self->index_mutex);
 }
 
 static void
@@ -1085,6 +1344,9 @@ fu_device_list_finalize(GObject *obj)
 
 	g_rw_lock_clear(&self->devices_mutex);
 	g_ptr_array_unref(self->devices);
+	g_hash_table_unref(self->guid_index);
+	g_hash_table_unref(self->connection_index);
+	g_mutex_clear(&self->index_mutex);
 
 	G_OBJECT_CLASS(fu_device_list_parent_class)->finalize(obj);
 }
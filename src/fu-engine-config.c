@@ -228,6 +228,18 @@ fu_engine_config_get_idle_timeout(FuEngineConfig *self)
 	return fu_config_get_value_u64(FU_CONFIG(self), "fwupd", "IdleTimeout");
 }
 
+guint
+fu_engine_config_get_security_history_max_age(FuEngineConfig *self)
+{
+	return fu_config_get_value_u64(FU_CONFIG(self), "fwupd", "SecurityHistoryMaxAge");
+}
+
+guint
+fu_engine_config_get_security_history_max_entries(FuEngineConfig *self)
+{
+	return fu_config_get_value_u64(FU_CONFIG(self), "fwupd", "SecurityHistoryMaxEntries");
+}
+
 GPtrArray *
 fu_engine_config_get_disabled_devices(FuEngineConfig *self)
 {
@@ -414,7 +426,10 @@ fu_engine_config_init(FuEngineConfig *self)
 	fu_engine_set_config_default(self, "P2pPolicy", FU_DEFAULT_P2P_POLICY);
 	fu_engine_set_config_default(self, "ReleaseDedupe", "true");
 	fu_engine_set_config_default(self, "ReleasePriority", "local");
+	fu_engine_set_config_default(self, "SecurityHistoryMaxAge", "365"); /* days */
+	fu_engine_set_config_default(self, "SecurityHistoryMaxEntries", "1000");
 	fu_engine_set_config_default(self, "ShowDevicePrivate", "true");
+	fu_engine_set_config_default(self, "SignalCoalesceWindow", "100"); /* ms */
 	fu_engine_set_config_default(self, "TestDevices", "false");
 	fu_engine_set_config_default(self, "TrustedReports", "VendorId=$OEM");
 	fu_engine_set_config_default(self, "TrustedUids", NULL);
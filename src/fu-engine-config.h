@@ -19,6 +19,10 @@ guint64
 fu_engine_config_get_archive_size_max(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 guint
 fu_engine_config_get_idle_timeout(FuEngineConfig *self) G_GNUC_NON_NULL(1);
+guint
+fu_engine_config_get_security_history_max_age(FuEngineConfig *self) G_GNUC_NON_NULL(1);
+guint
+fu_engine_config_get_security_history_max_entries(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 GPtrArray *
 fu_engine_config_get_disabled_devices(FuEngineConfig *self) G_GNUC_NON_NULL(1);
 GPtrArray *
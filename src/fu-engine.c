@@ -118,14 +118,16 @@ struct _FuEngine {
 	guint percentage;
 	FuHistory *history;
 	FuIdle *idle;
-	XbSilo *silo;
-	XbQuery *query_component_by_guid;
-	XbQuery *query_container_checksum1; /* container checksum -> release */
-	XbQuery *query_container_checksum2; /* artifact checksum -> release */
-	XbQuery *query_tag_by_guid_version;
+	FuMetrics *metrics;
+	FuProfiler *profiler;
+	GPtrArray *silos;	      /* (element-type FuEngineSilo) in remote order */
+	GHashTable *component_index;  /* (element-type utf8 GPtrArray<XbNode>) of GUID */
+	GHashTable *release_index;    /* (element-type XbNode GPtrArray<XbNode>) of component */
+	GHashTable *release_failures; /* (element-type utf8) of device ID and release */
 	guint coldplug_id;
 	FuPluginList *plugin_list;
 	GPtrArray *plugin_filter;
+	GPtrArray *plugins_deferred; /* (element-type FuPlugin) */
 	FuContext *ctx;
 	GHashTable *approved_firmware;	      /* (nullable) */
 	GHashTable *blocked_firmware;	      /* (nullable) */
@@ -164,6 +166,34 @@ static guint signals[SIGNAL_LAST] = {0};
 
 G_DEFINE_TYPE(FuEngine, fu_engine, G_TYPE_OBJECT)
 
+/* each remote is compiled into its own silo, so that refreshing one does not rebuild the others */
+typedef struct {
+	gchar *id;	 /* remote ID, or "local" */
+	gchar *filename; /* cache file, or NULL if not cached */
+	XbSilo *silo;
+	XbQuery *query_component_by_guid;
+	XbQuery *query_container_checksum1; /* container checksum -> release */
+	XbQuery *query_container_checksum2; /* artifact checksum -> release */
+	XbQuery *query_tag_by_guid_version;
+} FuEngineSilo;
+
+static void
+fu_engine_silo_free(FuEngineSilo *item)
+{
+	g_free(item->id);
+	g_free(item->filename);
+	g_object_unref(item->silo);
+	if (item->query_component_by_guid != NULL)
+		g_object_unref(item->query_component_by_guid);
+	if (item->query_container_checksum1 != NULL)
+		g_object_unref(item->query_container_checksum1);
+	if (item->query_container_checksum2 != NULL)
+		g_object_unref(item->query_container_checksum2);
+	if (item->query_tag_by_guid_version != NULL)
+		g_object_unref(item->query_tag_by_guid_version);
+	g_free(item);
+}
+
 gboolean
 fu_engine_get_loaded(FuEngine *self)
 {
@@ -222,6 +252,9 @@ fu_engine_emit_changed(FuEngine *self)
 static void
 fu_engine_emit_device_changed_safe(FuEngine *self, FuDevice *device)
 {
+	/* requirements may depend on the version or flags of any device, even during coldplug */
+	g_hash_table_remove_all(self->release_failures);
+
 	/* do nothing */
 	if (!self->loaded)
 		return;
@@ -253,6 +286,52 @@ fu_engine_get_context(FuEngine *self)
 	return self->ctx;
 }
 
+FuMetrics *
+fu_engine_get_metrics(FuEngine *self)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	return self->metrics;
+}
+
+FuProfiler *
+fu_engine_get_profiler(FuEngine *self)
+{
+	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
+	return self->profiler;
+}
+
+typedef struct {
+	const gchar *kind; /* static string */
+	gchar *name;
+	gint64 start;
+	guint span;
+} FuEngineMeasure;
+
+/* measure something like "plugin" and "dell:coldplug" for both the metrics and the profiler,
+ * which only records during startup -- end with fu_engine_measure_end() */
+static FuEngineMeasure *
+fu_engine_measure_begin(FuEngine *self, const gchar *kind, const gchar *id, const gchar *action)
+{
+	FuEngineMeasure *measure = g_new0(FuEngineMeasure, 1);
+	measure->kind = kind;
+	measure->name = g_strdup_printf("%s:%s", id != NULL ? id : "unknown", action);
+	measure->span = fu_profiler_begin(self->profiler, kind, measure->name);
+	measure->start = g_get_monotonic_time();
+	return measure;
+}
+
+static void
+fu_engine_measure_end(FuEngine *self, FuEngineMeasure *measure)
+{
+	fu_profiler_end(self->profiler, measure->span);
+	fu_metrics_add(self->metrics,
+		       measure->kind,
+		       measure->name,
+		       g_get_monotonic_time() - measure->start);
+	g_free(measure->name);
+	g_free(measure);
+}
+
 static void
 fu_engine_set_status(FuEngine *self, FwupdStatus status)
 {
@@ -438,15 +517,25 @@ fu_engine_device_added_cb(FuDeviceList *device_list, FuDevice *device, FuEngine
 	fu_engine_ensure_device_display_required_inhibit(self, device);
 	fu_engine_ensure_device_system_inhibit(self, device);
 	fu_engine_acquiesce_reset(self);
+	g_hash_table_remove_all(self->release_failures);
 	g_signal_emit(self, signals[SIGNAL_DEVICE_ADDED], 0, device);
 }
 
+/* deferred using FU_PLUGIN_RULE_DEVICE_BACKEND and not yet started */
+static gboolean
+fu_engine_plugin_is_deferred(FuEngine *self, FuPlugin *plugin)
+{
+	return g_ptr_array_find(self->plugins_deferred, plugin, NULL);
+}
+
 static void
 fu_engine_device_runner_device_removed(FuEngine *self, FuDevice *device)
 {
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
+		if (fu_engine_plugin_is_deferred(self, plugin_tmp))
+			continue;
 		fu_plugin_runner_device_removed(plugin_tmp, device);
 	}
 }
@@ -456,6 +545,7 @@ fu_engine_device_removed_cb(FuDeviceList *device_list, FuDevice *device, FuEngin
 {
 	fu_engine_device_runner_device_removed(self, device);
 	fu_engine_acquiesce_reset(self);
+	g_hash_table_remove_all(self->release_failures);
 	g_signal_handlers_disconnect_by_data(device, self);
 	g_signal_emit(self, signals[SIGNAL_DEVICE_REMOVED], 0, device);
 }
@@ -468,23 +558,17 @@ fu_engine_device_changed_cb(FuDeviceList *device_list, FuDevice *device, FuEngin
 	fu_engine_acquiesce_reset(self);
 }
 
-/* add any client-side BKC tags */
 static gboolean
-fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError **error)
+fu_engine_add_local_release_metadata_silo(FuEngineSilo *item,
+					  FuRelease *release,
+					  GPtrArray *guids,
+					  GError **error)
 {
-	FuDevice *dev = fu_release_get_device(release);
-	GPtrArray *guids;
-
-	/* no device matched */
-	if (dev == NULL)
-		return TRUE;
-
 	/* not set up */
-	if (self->query_tag_by_guid_version == NULL)
+	if (item->query_tag_by_guid_version == NULL)
 		return TRUE;
 
 	/* use prepared query for each GUID */
-	guids = fu_device_get_guids(dev);
 	for (guint i = 0; i < guids->len; i++) {
 		const gchar *guid = g_ptr_array_index(guids, i);
 		g_autoptr(GError) error_local = NULL;
@@ -497,8 +581,8 @@ fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError
 					   1,
 					   fu_release_get_version(release),
 					   NULL);
-		tags = xb_silo_query_with_context(self->silo,
-						  self->query_tag_by_guid_version,
+		tags = xb_silo_query_with_context(item->silo,
+						  item->query_tag_by_guid_version,
 						  &context,
 						  &error_local);
 		if (tags == NULL) {
@@ -518,6 +602,29 @@ fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError
 	return TRUE;
 }
 
+/* add any client-side BKC tags */
+static gboolean
+fu_engine_add_local_release_metadata(FuEngine *self, FuRelease *release, GError **error)
+{
+	FuDevice *dev = fu_release_get_device(release);
+
+	/* no device matched */
+	if (dev == NULL)
+		return TRUE;
+
+	for (guint i = 0; i < self->silos->len; i++) {
+		FuEngineSilo *item = g_ptr_array_index(self->silos, i);
+		if (!fu_engine_add_local_release_metadata_silo(item,
+							       release,
+							       fu_device_get_guids(dev),
+							       error))
+			return FALSE;
+	}
+
+	/* success */
+	return TRUE;
+}
+
 /* private, for self tests */
 void
 fu_engine_add_remote(FuEngine *self, FwupdRemote *remote)
@@ -649,23 +756,26 @@ fu_engine_get_release_for_checksum(FuEngine *self, const gchar *csum)
 {
 	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
 	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, csum, NULL);
-	if (self->query_container_checksum1 != NULL) {
-		g_autoptr(XbNode) rel =
-		    xb_silo_query_first_with_context(self->silo,
-						     self->query_container_checksum1,
-						     &context,
-						     NULL);
-		if (rel != NULL)
-			return g_steal_pointer(&rel);
-	}
-	if (self->query_container_checksum2 != NULL) {
-		g_autoptr(XbNode) rel =
-		    xb_silo_query_first_with_context(self->silo,
-						     self->query_container_checksum2,
-						     &context,
-						     NULL);
-		if (rel != NULL)
-			return g_steal_pointer(&rel);
+	for (guint i = 0; i < self->silos->len; i++) {
+		FuEngineSilo *item = g_ptr_array_index(self->silos, i);
+		if (item->query_container_checksum1 != NULL) {
+			g_autoptr(XbNode) rel =
+			    xb_silo_query_first_with_context(item->silo,
+							     item->query_container_checksum1,
+							     &context,
+							     NULL);
+			if (rel != NULL)
+				return g_steal_pointer(&rel);
+		}
+		if (item->query_container_checksum2 != NULL) {
+			g_autoptr(XbNode) rel =
+			    xb_silo_query_first_with_context(item->silo,
+							     item->query_container_checksum2,
+							     &context,
+							     NULL);
+			if (rel != NULL)
+				return g_steal_pointer(&rel);
+		}
 	}
 
 	/* failed */
@@ -676,17 +786,21 @@ fu_engine_get_release_for_checksum(FuEngine *self, const gchar *csum)
 gchar *
 fu_engine_get_remote_id_for_stream(FuEngine *self, GInputStream *stream)
 {
-	GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1, 0};
+	const GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1};
+	g_autoptr(GPtrArray) checksums = NULL;
 
 	g_return_val_if_fail(FU_IS_ENGINE(self), NULL);
 	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
 
-	for (guint i = 0; checksum_types[i] != 0; i++) {
-		g_autofree gchar *csum = NULL;
-		g_autoptr(XbNode) rel = NULL;
-		csum = fu_input_stream_compute_checksum(stream, checksum_types[i], NULL);
-		if (csum != NULL)
-			rel = fu_engine_get_release_for_checksum(self, csum);
+	checksums = fu_input_stream_compute_checksums(stream,
+						      checksum_types,
+						      G_N_ELEMENTS(checksum_types),
+						      NULL);
+	if (checksums == NULL)
+		return NULL;
+	for (guint i = 0; i < checksums->len; i++) {
+		const gchar *csum = g_ptr_array_index(checksums, i);
+		g_autoptr(XbNode) rel = fu_engine_get_release_for_checksum(self, csum);
 		if (rel != NULL) {
 			const gchar *remote_id =
 			    xb_node_query_text(rel,
@@ -1235,27 +1349,10 @@ fu_engine_verify_update(FuEngine *self,
 static XbNode *
 fu_engine_get_component_by_guid(FuEngine *self, const gchar *guid)
 {
-	g_autoptr(GError) error_local = NULL;
-	g_autoptr(XbNode) component = NULL;
-	g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
-
-	/* no components in silo */
-	if (self->query_component_by_guid == NULL)
-		return NULL;
-
-	xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-	xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-	component = xb_silo_query_first_with_context(self->silo,
-						     self->query_component_by_guid,
-						     &context,
-						     &error_local);
-	if (component == NULL) {
-		if (!g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) &&
-		    !g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT))
-			g_warning("ignoring: %s", error_local->message);
+	GPtrArray *components = g_hash_table_lookup(self->component_index, guid);
+	if (components == NULL || components->len == 0)
 		return NULL;
-	}
-	return g_object_ref(component);
+	return g_object_ref(g_ptr_array_index(components, 0));
 }
 
 XbNode *
@@ -1313,14 +1410,14 @@ fu_engine_verify_from_local_metadata(FuEngine *self, FuDevice *device, GError **
 }
 
 static XbNode *
-fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError **error)
+fu_engine_verify_from_system_metadata_silo(FuEngineSilo *item, FuDevice *device, GError **error)
 {
 	FwupdVersionFormat fmt = fu_device_get_version_format(device);
 	GPtrArray *guids = fu_device_get_guids(device);
 	g_autoptr(XbQuery) query = NULL;
 
 	/* prepare query with bound GUID parameter */
-	query = xb_query_new_full(self->silo,
+	query = xb_query_new_full(item->silo,
 				  "components/component[@type='firmware']/"
 				  "provides/firmware[@type='flashed'][text()=?]/"
 				  "../../releases/release",
@@ -1340,7 +1437,7 @@ fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError *
 
 		/* bind GUID and then query */
 		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-		releases = xb_silo_query_with_context(self->silo, query, &context, &error_local);
+		releases = xb_silo_query_with_context(item->silo, query, &context, &error_local);
 		if (releases == NULL) {
 			if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND) ||
 			    g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT)) {
@@ -1364,6 +1461,31 @@ fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError *
 	return NULL;
 }
 
+static XbNode *
+fu_engine_verify_from_system_metadata(FuEngine *self, FuDevice *device, GError **error)
+{
+	for (guint i = 0; i < self->silos->len; i++) {
+		FuEngineSilo *item = g_ptr_array_index(self->silos, i);
+		g_autoptr(GError) error_local = NULL;
+		g_autoptr(XbNode) rel = NULL;
+
+		/* no components in silo */
+		if (item->query_component_by_guid == NULL)
+			continue;
+		rel = fu_engine_verify_from_system_metadata_silo(item, device, &error_local);
+		if (rel != NULL)
+			return g_steal_pointer(&rel);
+		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND)) {
+			g_propagate_error(error, g_steal_pointer(&error_local));
+			return NULL;
+		}
+	}
+
+	/* not found */
+	g_set_error_literal(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND, "failed to find release");
+	return NULL;
+}
+
 /**
  * fu_engine_verify:
  * @self: a #FuEngine
@@ -1813,6 +1935,8 @@ fu_engine_composite_prepare(FuEngine *self, GPtrArray *devices, GError **error)
 
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
+		if (fu_engine_plugin_is_deferred(self, plugin_tmp))
+			continue;
 		if (!fu_plugin_runner_composite_prepare(plugin_tmp, devices, error))
 			return FALSE;
 	}
@@ -1862,6 +1986,8 @@ fu_engine_composite_cleanup(FuEngine *self, GPtrArray *devices, GError **error)
 
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
+		if (fu_engine_plugin_is_deferred(self, plugin_tmp))
+			continue;
 		if (!fu_plugin_runner_composite_cleanup(plugin_tmp, devices, error))
 			return FALSE;
 	}
@@ -1976,6 +2102,79 @@ fu_engine_install_release_version_check(FuEngine *self,
  *
  * Returns: %TRUE for success
  **/
+static gboolean
+fu_engine_install_releases_sequence(FuEngine *self,
+				    GPtrArray *releases,
+				    GPtrArray *devices,
+				    FuProgress *progress,
+				    FwupdInstallFlags flags,
+				    GError **error)
+{
+	fu_progress_set_id(progress, G_STRLOC);
+	fu_progress_set_steps(progress, releases->len);
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		GInputStream *stream = fu_release_get_stream(release);
+		if (stream == NULL) {
+			g_set_error_literal(error,
+					    FWUPD_ERROR,
+					    FWUPD_ERROR_NOT_SUPPORTED,
+					    "no stream for release");
+			return FALSE;
+		}
+		if (!fu_engine_install_release(self,
+					       release,
+					       stream,
+					       fu_progress_get_child(progress),
+					       flags,
+					       error)) {
+			g_autoptr(GError) error_local = NULL;
+			if (!fu_engine_composite_cleanup(self, devices, &error_local)) {
+				g_warning("failed to cleanup failed composite action: %s",
+					  error_local->message);
+			}
+			return FALSE;
+		}
+		fu_progress_step_done(progress);
+	}
+	return TRUE;
+}
+
+static gboolean
+fu_engine_install_releases_history(FuEngine *self,
+				   GPtrArray *releases,
+				   GPtrArray *devices,
+				   FuProgress *progress,
+				   FwupdInstallFlags flags,
+				   GError **error)
+{
+	gboolean ret;
+	g_autoptr(GError) error_local = NULL;
+
+	if ((flags & FWUPD_INSTALL_FLAG_NO_HISTORY) > 0)
+		return fu_engine_install_releases_sequence(self,
+							   releases,
+							   devices,
+							   progress,
+							   flags,
+							   error);
+
+	/* only sync the history database once for all the devices -- the failed update-state
+	 * has to be recorded too, so this is committed even if one of the installs failed */
+	if (!fu_history_begin_transaction(self->history, error))
+		return FALSE;
+	ret = fu_engine_install_releases_sequence(self, releases, devices, progress, flags, error);
+	if (!fu_history_commit_transaction(self->history, &error_local)) {
+		if (!ret) {
+			g_warning("failed to record history: %s", error_local->message);
+			return FALSE;
+		}
+		g_propagate_error(error, g_steal_pointer(&error_local));
+		return FALSE;
+	}
+	return ret;
+}
+
 gboolean
 fu_engine_install_releases(FuEngine *self,
 			   FuEngineRequest *request,
@@ -2031,33 +2230,8 @@ fu_engine_install_releases(FuEngine *self,
 	}
 
 	/* all authenticated, so install all the things */
-	fu_progress_set_id(progress, G_STRLOC);
-	fu_progress_set_steps(progress, releases->len);
-	for (guint i = 0; i < releases->len; i++) {
-		FuRelease *release = g_ptr_array_index(releases, i);
-		GInputStream *stream = fu_release_get_stream(release);
-		if (stream == NULL) {
-			g_set_error_literal(error,
-					    FWUPD_ERROR,
-					    FWUPD_ERROR_NOT_SUPPORTED,
-					    "no stream for release");
-			return FALSE;
-		}
-		if (!fu_engine_install_release(self,
-					       release,
-					       stream,
-					       fu_progress_get_child(progress),
-					       flags,
-					       error)) {
-			g_autoptr(GError) error_local = NULL;
-			if (!fu_engine_composite_cleanup(self, devices, &error_local)) {
-				g_warning("failed to cleanup failed composite action: %s",
-					  error_local->message);
-			}
-			return FALSE;
-		}
-		fu_progress_step_done(progress);
-	}
+	if (!fu_engine_install_releases_history(self, releases, devices, progress, flags, error))
+		return FALSE;
 
 	/* set all the device statuses back to unknown */
 	for (guint i = 0; i < releases->len; i++) {
@@ -2487,12 +2661,16 @@ fu_engine_install_release(FuEngine *self,
 
 	/* add the checksum of the container blob if not already set */
 	if (fwupd_release_get_checksums(FWUPD_RELEASE(release))->len == 0) {
-		GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1, 0};
-		for (guint i = 0; checksum_types[i] != 0; i++) {
-			g_autofree gchar *checksum =
-			    fu_input_stream_compute_checksum(stream, checksum_types[i], error);
-			if (checksum == NULL)
-				return FALSE;
+		const GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1};
+		g_autoptr(GPtrArray) checksums = NULL;
+		checksums = fu_input_stream_compute_checksums(stream,
+							      checksum_types,
+							      G_N_ELEMENTS(checksum_types),
+							      error);
+		if (checksums == NULL)
+			return FALSE;
+		for (guint i = 0; i < checksums->len; i++) {
+			const gchar *checksum = g_ptr_array_index(checksums, i);
 			fwupd_release_add_checksum(FWUPD_RELEASE(release), checksum);
 		}
 	}
@@ -3024,6 +3202,8 @@ fu_engine_prepare(FuEngine *self,
 		return FALSE;
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
+		if (fu_engine_plugin_is_deferred(self, plugin_tmp))
+			continue;
 		if (!fu_plugin_runner_prepare(plugin_tmp, device, progress, flags, error))
 			return FALSE;
 	}
@@ -3069,6 +3249,8 @@ fu_engine_cleanup(FuEngine *self,
 		return FALSE;
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
+		if (fu_engine_plugin_is_deferred(self, plugin_tmp))
+			continue;
 		if (!fu_plugin_runner_cleanup(plugin_tmp, device, progress, flags, error))
 			return FALSE;
 	}
@@ -3313,7 +3495,9 @@ fu_engine_write_firmware(FuEngine *self,
 			 FwupdInstallFlags flags,
 			 GError **error)
 {
+	FuEngineMeasure *measure;
 	FuPlugin *plugin;
+	gboolean ret;
 	g_autofree gchar *str = NULL;
 	g_autoptr(FuDevice) device = NULL;
 	g_autoptr(FuDeviceLocker) poll_locker = NULL;
@@ -3344,12 +3528,18 @@ fu_engine_write_firmware(FuEngine *self,
 	    fu_plugin_list_find_by_name(self->plugin_list, fu_device_get_plugin(device), error);
 	if (plugin == NULL)
 		return FALSE;
-	if (!fu_plugin_runner_write_firmware(plugin,
-					     device,
-					     stream_fw,
-					     progress,
-					     flags,
-					     &error_write)) {
+	measure = fu_engine_measure_begin(self,
+					  "plugin",
+					  fu_plugin_get_name(plugin),
+					  "write-firmware");
+	ret = fu_plugin_runner_write_firmware(plugin,
+					      device,
+					      stream_fw,
+					      progress,
+					      flags,
+					      &error_write);
+	fu_engine_measure_end(self, measure);
+	if (!ret) {
 		g_autoptr(GError) error_attach = NULL;
 		g_autoptr(GError) error_cleanup = NULL;
 
@@ -3675,91 +3865,167 @@ fu_engine_get_item_by_id_fallback_history(FuEngine *self, const gchar *id, GErro
 	return NULL;
 }
 
+/* in silo order, so the first component for each GUID matches the first query result */
+static void
+fu_engine_create_component_index(FuEngine *self, FuEngineSilo *item)
+{
+	g_autoptr(GPtrArray) provides = NULL;
+
+	provides = xb_silo_query(item->silo,
+				 "components/component/provides/firmware[@type='flashed']",
+				 0,
+				 NULL);
+	if (provides == NULL)
+		return;
+	for (guint i = 0; i < provides->len; i++) {
+		XbNode *n = g_ptr_array_index(provides, i);
+		const gchar *guid = xb_node_get_text(n);
+		GPtrArray *components;
+		g_autoptr(XbNode) component = NULL;
+		g_autoptr(XbNode) parent = NULL;
+
+		if (guid == NULL)
+			continue;
+		parent = xb_node_get_parent(n);
+		if (parent == NULL)
+			continue;
+		component = xb_node_get_parent(parent);
+		if (component == NULL)
+			continue;
+		components = g_hash_table_lookup(self->component_index, guid);
+		if (components == NULL) {
+			components = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+			g_hash_table_insert(self->component_index, g_strdup(guid), components);
+		}
+		if (g_ptr_array_find(components, component, NULL))
+			continue;
+		g_ptr_array_add(components, g_steal_pointer(&component));
+	}
+}
+
 static gboolean
-fu_engine_create_silo_index(FuEngine *self, GError **error)
+fu_engine_silo_create_index(FuEngineSilo *item, GError **error)
 {
 	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GError) error_container_checksum1 = NULL;
 	g_autoptr(GError) error_container_checksum2 = NULL;
 	g_autoptr(GError) error_tag_by_guid_version = NULL;
 
+	/* prepare tag query with bound GUID parameter, which is only found in the local silo */
+	item->query_tag_by_guid_version =
+	    xb_query_new_full(item->silo,
+			      "local/components/component[@merge='append']/provides/"
+			      "firmware[text()=?]/../../releases/release[@version=?]/../../"
+			      "tags/tag",
+			      XB_QUERY_FLAG_OPTIMIZE,
+			      &error_tag_by_guid_version);
+	if (item->query_tag_by_guid_version == NULL)
+		g_debug("ignoring prepared query: %s", error_tag_by_guid_version->message);
+
 	/* print what we've got */
-	components = xb_silo_query(self->silo, "components/component[@type='firmware']", 0, NULL);
+	components = xb_silo_query(item->silo, "components/component[@type='firmware']", 0, NULL);
 	if (components == NULL)
 		return TRUE;
-	g_info("%u components now in silo", components->len);
-
-	/* clear old prepared queries */
-	g_clear_object(&self->query_component_by_guid);
-	g_clear_object(&self->query_container_checksum1);
-	g_clear_object(&self->query_container_checksum2);
-	g_clear_object(&self->query_tag_by_guid_version);
+	g_info("%u components now in silo for %s", components->len, item->id);
 
 	/* build the index */
-	if (!xb_silo_query_build_index(self->silo, "components/component", "type", error))
+	if (!xb_silo_query_build_index(item->silo, "components/component", "type", error))
 		return FALSE;
-	if (!xb_silo_query_build_index(self->silo,
+	if (!xb_silo_query_build_index(item->silo,
 				       "components/component[@type='firmware']/provides/firmware",
 				       "type",
 				       error))
 		return FALSE;
-	if (!xb_silo_query_build_index(self->silo,
+	if (!xb_silo_query_build_index(item->silo,
 				       "components/component/provides/firmware",
 				       NULL,
 				       error))
 		return FALSE;
-	if (!xb_silo_query_build_index(self->silo,
+	if (!xb_silo_query_build_index(item->silo,
 				       "components/component[@type='firmware']/tags/tag",
 				       "namespace",
 				       error))
 		return FALSE;
 
 	/* create prepared queries to save time later */
-	self->query_component_by_guid =
-	    xb_query_new_full(self->silo,
+	item->query_component_by_guid =
+	    xb_query_new_full(item->silo,
 			      "components/component/provides/firmware[@type=$'flashed'][text()=?]/"
 			      "../..",
 			      XB_QUERY_FLAG_OPTIMIZE,
 			      error);
-	if (self->query_component_by_guid == NULL) {
+	if (item->query_component_by_guid == NULL) {
 		g_prefix_error(error, "failed to prepare query: ");
 		return FALSE;
 	}
 
 	/* old-style <checksum target="container"> and new-style <artifact> */
-	self->query_container_checksum1 =
-	    xb_query_new_full(self->silo,
+	item->query_container_checksum1 =
+	    xb_query_new_full(item->silo,
 			      "components/component[@type='firmware']/releases/release/"
 			      "checksum[@target='container'][text()=?]/..",
 			      XB_QUERY_FLAG_OPTIMIZE,
 			      &error_container_checksum1);
-	if (self->query_container_checksum1 == NULL)
+	if (item->query_container_checksum1 == NULL)
 		g_debug("ignoring prepared query: %s", error_container_checksum1->message);
-	self->query_container_checksum2 =
-	    xb_query_new_full(self->silo,
+	item->query_container_checksum2 =
+	    xb_query_new_full(item->silo,
 			      "components/component[@type='firmware']/releases/release/"
 			      "artifacts/artifact[@type='binary']/checksum[text()=?]/"
 			      "../../..",
 			      XB_QUERY_FLAG_OPTIMIZE,
 			      &error_container_checksum2);
-	if (self->query_container_checksum2 == NULL)
+	if (item->query_container_checksum2 == NULL)
 		g_debug("ignoring prepared query: %s", error_container_checksum2->message);
 
-	/* prepare tag query with bound GUID parameter */
-	self->query_tag_by_guid_version =
-	    xb_query_new_full(self->silo,
-			      "local/components/component[@merge='append']/provides/"
-			      "firmware[text()=?]/../../releases/release[@version=?]/../../"
-			      "tags/tag",
-			      XB_QUERY_FLAG_OPTIMIZE,
-			      &error_tag_by_guid_version);
-	if (self->query_tag_by_guid_version == NULL)
-		g_debug("ignoring prepared query: %s", error_tag_by_guid_version->message);
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_engine_add_silo(FuEngine *self,
+		   const gchar *id,
+		   const gchar *filename,
+		   XbSilo *silo,
+		   GError **error)
+{
+	FuEngineSilo *item = g_new0(FuEngineSilo, 1);
+
+	item->id = g_strdup(id);
+	item->filename = g_strdup(filename);
+	item->silo = g_object_ref(silo);
+	g_ptr_array_add(self->silos, item);
+	if (!fu_engine_silo_create_index(item, error))
+		return FALSE;
+
+	/* avoid querying each silo for each GUID of each device */
+	fu_engine_create_component_index(self, item);
 
 	/* success */
 	return TRUE;
 }
 
+static void
+fu_engine_clear_silos(FuEngine *self)
+{
+	/* these all point into the old silos */
+	g_hash_table_remove_all(self->component_index);
+	g_hash_table_remove_all(self->release_index);
+	g_hash_table_remove_all(self->release_failures);
+	g_ptr_array_set_size(self->silos, 0);
+}
+
+static gboolean
+fu_engine_has_components(FuEngine *self)
+{
+	for (guint i = 0; i < self->silos->len; i++) {
+		FuEngineSilo *item = g_ptr_array_index(self->silos, i);
+		if (item->query_component_by_guid != NULL)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 /* for the self tests */
 void
 fu_engine_set_silo(FuEngine *self, XbSilo *silo)
@@ -3767,8 +4033,8 @@ fu_engine_set_silo(FuEngine *self, XbSilo *silo)
 	g_autoptr(GError) error_local = NULL;
 	g_return_if_fail(FU_IS_ENGINE(self));
 	g_return_if_fail(XB_IS_SILO(silo));
-	g_set_object(&self->silo, silo);
-	if (!fu_engine_create_silo_index(self, &error_local))
+	fu_engine_clear_silos(self);
+	if (!fu_engine_add_silo(self, "self-test", NULL, silo, &error_local))
 		g_warning("failed to create indexes: %s", error_local->message);
 }
 
@@ -4002,98 +4268,190 @@ fu_engine_load_metadata_store_local(FuEngine *self,
 		xb_builder_import_source(builder, source);
 	}
 
-	/* success */
-	return TRUE;
+	/* success */
+	return TRUE;
+}
+
+static XbBuilder *
+fu_engine_metadata_builder_new(void)
+{
+	XbBuilder *builder = xb_builder_new();
+
+	/* invalidate the cache if the fwupd version changes */
+	xb_builder_append_guid(builder, SOURCE_VERSION);
+
+	/* verbose profiling */
+	if (g_getenv("FWUPD_XMLB_VERBOSE") != NULL) {
+		xb_builder_set_profile_flags(builder,
+					     XB_SILO_PROFILE_FLAG_XPATH |
+						 XB_SILO_PROFILE_FLAG_DEBUG);
+	}
+	return builder;
+}
+
+/* each silo is cached in its own file, so only the silos with changed sources get rebuilt */
+static gboolean
+fu_engine_load_metadata_silo(FuEngine *self,
+			     XbBuilder *builder,
+			     FwupdRemote *remote,
+			     FuEngineLoadFlags flags,
+			     GError **error)
+{
+	XbBuilderCompileFlags compile_flags = XB_BUILDER_COMPILE_FLAG_IGNORE_INVALID;
+	const gchar *id = remote != NULL ? fwupd_remote_get_id(remote) : "local";
+	g_autofree gchar *xmlbfn = NULL;
+	g_autoptr(XbSilo) silo = NULL;
+
+	/* on a read-only filesystem don't care about the cache GUID */
+	if (flags & FU_ENGINE_LOAD_FLAG_READONLY)
+		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
+
+	/* ensure silo is up to date, without leaving a temporary file behind when not caching */
+	if (flags & FU_ENGINE_LOAD_FLAG_NO_CACHE) {
+		silo = xb_builder_compile(builder, compile_flags, NULL, error);
+	} else {
+		g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+		g_autoptr(GFile) xmlb = NULL;
+
+		/* any name is a valid remote ID, so keep local metadata out of their directory */
+		if (remote != NULL) {
+			g_autofree gchar *basename = g_strdup_printf("%s.xmlb", id);
+			xmlbfn = g_build_filename(cachedirpkg, "metadata", basename, NULL);
+		} else {
+			xmlbfn = g_build_filename(cachedirpkg, "local.xmlb", NULL);
+		}
+		if (!fu_path_mkdir_parent(xmlbfn, error))
+			return FALSE;
+		xmlb = g_file_new_for_path(xmlbfn);
+		silo = xb_builder_ensure(builder, xmlb, compile_flags, NULL, error);
+	}
+	if (silo == NULL) {
+		g_prefix_error(error, "cannot create %s.xmlb: ", id);
+		return FALSE;
+	}
+	return fu_engine_add_silo(self, id, xmlbfn, silo, error);
+}
+
+static gboolean
+fu_engine_load_metadata_store_remote(FuEngine *self,
+				     FwupdRemote *remote,
+				     FuEngineLoadFlags flags,
+				     GError **error)
+{
+	const gchar *path = fwupd_remote_get_filename_cache(remote);
+	g_autoptr(GFile) file = NULL;
+	g_autoptr(XbBuilder) builder = fu_engine_metadata_builder_new();
+	g_autoptr(XbBuilderFixup) fixup = NULL;
+	g_autoptr(XbBuilderNode) custom = NULL;
+	g_autoptr(XbBuilderSource) source = xb_builder_source_new();
+
+	/* generate all metadata on demand */
+	if (fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_DIRECTORY) {
+		g_info("loading metadata for remote '%s'", fwupd_remote_get_id(remote));
+		if (!fu_engine_create_metadata(self, builder, remote, error))
+			return FALSE;
+		return fu_engine_load_metadata_silo(self, builder, remote, flags, error);
+	}
+
+	/* rebuild if the signed metadata changes */
+	if (fwupd_remote_get_checksum(remote) != NULL)
+		xb_builder_append_guid(builder, fwupd_remote_get_checksum(remote));
+
+	/* save the remote-id in the custom metadata space */
+	file = g_file_new_for_path(path);
+	if (!xb_builder_source_load_file(source, file, XB_BUILDER_SOURCE_FLAG_NONE, NULL, error))
+		return FALSE;
+
+	/* fix up any legacy installed files */
+	fixup = xb_builder_fixup_new("AppStreamUpgrade",
+				     fu_engine_appstream_upgrade_cb,
+				     self,
+				     NULL);
+	xb_builder_fixup_set_max_depth(fixup, 3);
+	xb_builder_source_add_fixup(source, fixup);
+
+	/* add metadata */
+	custom = xb_builder_node_new("custom");
+	xb_builder_node_insert_text(custom, "value", path, "key", "fwupd::FilenameCache", NULL);
+	xb_builder_node_insert_text(custom,
+				    "value",
+				    fwupd_remote_get_id(remote),
+				    "key",
+				    "fwupd::RemoteId",
+				    NULL);
+	xb_builder_source_set_info(source, custom);
+
+	/* we need to watch for changes? */
+	xb_builder_import_source(builder, source);
+	return fu_engine_load_metadata_silo(self, builder, remote, flags, error);
+}
+
+static void
+fu_engine_delete_metadata_silo_file(const gchar *fn)
+{
+	g_autoptr(GError) error_local = NULL;
+	g_autoptr(GFile) file = g_file_new_for_path(fn);
+
+	g_info("deleting stale %s", fn);
+	if (!g_file_delete(file, NULL, &error_local))
+		g_info("failed to delete %s: %s", fn, error_local->message);
+}
+
+/* delete the combined silo used by older versions and the silos of removed or disabled remotes */
+static void
+fu_engine_prune_metadata_silos(FuEngine *self)
+{
+	g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
+	g_autofree gchar *metadata_path = g_build_filename(cachedirpkg, "metadata", NULL);
+	g_autofree gchar *xmlbfn_legacy = g_build_filename(cachedirpkg, "metadata.xmlb", NULL);
+	g_autoptr(GPtrArray) xmlbfns = NULL;
+
+	if (g_file_test(xmlbfn_legacy, G_FILE_TEST_EXISTS))
+		fu_engine_delete_metadata_silo_file(xmlbfn_legacy);
+	xmlbfns = fu_path_glob(metadata_path, "*.xmlb", NULL);
+	if (xmlbfns == NULL)
+		return;
+	for (guint i = 0; i < xmlbfns->len; i++) {
+		const gchar *fn = g_ptr_array_index(xmlbfns, i);
+		gboolean found = FALSE;
+
+		for (guint j = 0; j < self->silos->len; j++) {
+			FuEngineSilo *item = g_ptr_array_index(self->silos, j);
+			if (g_strcmp0(fn, item->filename) == 0) {
+				found = TRUE;
+				break;
+			}
+		}
+		if (!found)
+			fu_engine_delete_metadata_silo_file(fn);
+	}
 }
 
 static gboolean
 fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **error)
 {
 	GPtrArray *remotes;
-	XbBuilderCompileFlags compile_flags = XB_BUILDER_COMPILE_FLAG_IGNORE_INVALID;
-	g_autoptr(GFile) xmlb = NULL;
-	g_autoptr(XbBuilder) builder = xb_builder_new();
-
-	/* clear existing silo */
-	g_clear_object(&self->silo);
-
-	/* invalidate the cache if the fwupd version changes */
-	xb_builder_append_guid(builder, SOURCE_VERSION);
+	g_autoptr(XbBuilder) builder = fu_engine_metadata_builder_new();
 
-	/* verbose profiling */
-	if (g_getenv("FWUPD_XMLB_VERBOSE") != NULL) {
-		xb_builder_set_profile_flags(builder,
-					     XB_SILO_PROFILE_FLAG_XPATH |
-						 XB_SILO_PROFILE_FLAG_DEBUG);
-	}
+	/* clear existing silos */
+	fu_engine_clear_silos(self);
 
 	/* load each enabled metadata file */
 	remotes = fu_remote_list_get_all(self->remote_list);
 	for (guint i = 0; i < remotes->len; i++) {
-		const gchar *path = NULL;
+		FwupdRemote *remote = g_ptr_array_index(remotes, i);
 		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GFile) file = NULL;
-		g_autoptr(XbBuilderFixup) fixup = NULL;
-		g_autoptr(XbBuilderNode) custom = NULL;
-		g_autoptr(XbBuilderSource) source = xb_builder_source_new();
 
-		FwupdRemote *remote = g_ptr_array_index(remotes, i);
 		if (!fwupd_remote_has_flag(remote, FWUPD_REMOTE_FLAG_ENABLED))
 			continue;
-		path = fwupd_remote_get_filename_cache(remote);
-		if (!g_file_test(path, G_FILE_TEST_EXISTS))
-			continue;
-
-		/* generate all metadata on demand */
-		if (fwupd_remote_get_kind(remote) == FWUPD_REMOTE_KIND_DIRECTORY) {
-			g_info("loading metadata for remote '%s'", fwupd_remote_get_id(remote));
-			if (!fu_engine_create_metadata(self, builder, remote, &error_local)) {
-				g_warning("failed to generate remote %s: %s",
-					  fwupd_remote_get_id(remote),
-					  error_local->message);
-			}
+		if (!g_file_test(fwupd_remote_get_filename_cache(remote), G_FILE_TEST_EXISTS))
 			continue;
-		}
-
-		/* save the remote-id in the custom metadata space */
-		file = g_file_new_for_path(path);
-		if (!xb_builder_source_load_file(source,
-						 file,
-						 XB_BUILDER_SOURCE_FLAG_NONE,
-						 NULL,
-						 &error_local)) {
+		if (!fu_engine_load_metadata_store_remote(self, remote, flags, &error_local)) {
 			g_warning("failed to load remote %s: %s",
 				  fwupd_remote_get_id(remote),
 				  error_local->message);
 			continue;
 		}
-
-		/* fix up any legacy installed files */
-		fixup = xb_builder_fixup_new("AppStreamUpgrade",
-					     fu_engine_appstream_upgrade_cb,
-					     self,
-					     NULL);
-		xb_builder_fixup_set_max_depth(fixup, 3);
-		xb_builder_source_add_fixup(source, fixup);
-
-		/* add metadata */
-		custom = xb_builder_node_new("custom");
-		xb_builder_node_insert_text(custom,
-					    "value",
-					    path,
-					    "key",
-					    "fwupd::FilenameCache",
-					    NULL);
-		xb_builder_node_insert_text(custom,
-					    "value",
-					    fwupd_remote_get_id(remote),
-					    "key",
-					    "fwupd::RemoteId",
-					    NULL);
-		xb_builder_source_set_info(source, custom);
-
-		/* we need to watch for changes? */
-		xb_builder_import_source(builder, source);
 	}
 
 	/* add any client-side data, e.g. BKC tags */
@@ -4104,30 +4462,16 @@ fu_engine_load_metadata_store(FuEngine *self, FuEngineLoadFlags flags, GError **
 		return FALSE;
 	if (!fu_engine_load_metadata_store_local(self, builder, FU_PATH_KIND_DATADIR_PKG, error))
 		return FALSE;
-
-	/* on a read-only filesystem don't care about the cache GUID */
-	if (flags & FU_ENGINE_LOAD_FLAG_READONLY)
-		compile_flags |= XB_BUILDER_COMPILE_FLAG_IGNORE_GUID;
-
-	/* ensure silo is up to date */
-	if (flags & FU_ENGINE_LOAD_FLAG_NO_CACHE) {
-		g_autoptr(GFileIOStream) iostr = NULL;
-		xmlb = g_file_new_tmp(NULL, &iostr, error);
-		if (xmlb == NULL)
-			return FALSE;
-	} else {
-		g_autofree gchar *cachedirpkg = fu_path_from_kind(FU_PATH_KIND_CACHEDIR_PKG);
-		g_autofree gchar *xmlbfn = g_build_filename(cachedirpkg, "metadata.xmlb", NULL);
-		xmlb = g_file_new_for_path(xmlbfn);
-	}
-	self->silo = xb_builder_ensure(builder, xmlb, compile_flags, NULL, error);
-	if (self->silo == NULL) {
-		g_prefix_error(error, "cannot create metadata.xmlb: ");
+	if (!fu_engine_load_metadata_silo(self, builder, NULL, flags, error))
 		return FALSE;
-	}
+	g_info("%u GUIDs now in component index", g_hash_table_size(self->component_index));
+
+	/* only the silos that were just loaded are still useful */
+	if ((flags & (FU_ENGINE_LOAD_FLAG_NO_CACHE | FU_ENGINE_LOAD_FLAG_READONLY)) == 0)
+		fu_engine_prune_metadata_silos(self);
 
 	/* success */
-	return fu_engine_create_silo_index(self, error);
+	return TRUE;
 }
 
 static void
@@ -4152,6 +4496,7 @@ fu_engine_config_changed_cb(FuEngineConfig *config, FuEngine *self)
 	GPtrArray *remotes = fu_remote_list_get_all(self->remote_list);
 
 	fu_idle_set_timeout(self->idle, fu_engine_config_get_idle_timeout(config));
+	g_hash_table_remove_all(self->release_failures);
 
 	/* allow changing the hardcoded ESP location */
 	if (fu_engine_config_get_esp_location(config) != NULL)
@@ -4252,7 +4597,8 @@ fu_engine_get_system_jcat_result(FuEngine *self, FwupdRemote *remote, GError **e
 	blob = fu_bytes_get_contents(fwupd_remote_get_filename_cache(remote), error);
 	if (blob == NULL)
 		return NULL;
-	istream = fu_input_stream_from_path(fwupd_remote_get_filename_cache_sig(remote), error);
+	istream =
+	    fu_input_stream_from_path_mapped(fwupd_remote_get_filename_cache_sig(remote), error);
 	if (istream == NULL)
 		return NULL;
 	if (!jcat_file_import_stream(jcat_file, istream, JCAT_IMPORT_FLAG_NONE, NULL, error)) {
@@ -4703,10 +5049,10 @@ fu_engine_get_details(FuEngine *self,
 		      GInputStream *stream,
 		      GError **error)
 {
-	GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1, 0};
+	const GChecksumType checksum_types[] = {G_CHECKSUM_SHA256, G_CHECKSUM_SHA1};
 	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GPtrArray) details = NULL;
-	g_autoptr(GPtrArray) checksums = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) checksums = NULL;
 	g_autoptr(FuCabinet) cabinet = NULL;
 	g_autoptr(XbNode) rel_by_csum = NULL;
 
@@ -4724,13 +5070,12 @@ fu_engine_get_details(FuEngine *self,
 		return NULL;
 
 	/* calculate the checksums of the blob */
-	for (guint i = 0; checksum_types[i] != 0; i++) {
-		g_autofree gchar *checksum =
-		    fu_input_stream_compute_checksum(stream, checksum_types[i], error);
-		if (checksum == NULL)
-			return NULL;
-		g_ptr_array_add(checksums, g_steal_pointer(&checksum));
-	}
+	checksums = fu_input_stream_compute_checksums(stream,
+						      checksum_types,
+						      G_N_ELEMENTS(checksum_types),
+						      error);
+	if (checksums == NULL)
+		return NULL;
 
 	/* does this exist in any enabled remote */
 	for (guint i = 0; i < checksums->len; i++) {
@@ -5159,6 +5504,19 @@ fu_engine_check_release_is_blocked(FuEngine *self, FuRelease *release)
 	return FALSE;
 }
 
+static GPtrArray *
+fu_engine_get_releases_for_component(FuEngine *self, XbNode *component, GError **error)
+{
+	GPtrArray *releases = g_hash_table_lookup(self->release_index, component);
+	if (releases == NULL) {
+		releases = xb_node_query(component, "releases/release", 0, error);
+		if (releases == NULL)
+			return NULL;
+		g_hash_table_insert(self->release_index, g_object_ref(component), releases);
+	}
+	return g_ptr_array_ref(releases);
+}
+
 static gboolean
 fu_engine_add_releases_for_device_component(FuEngine *self,
 					    FuEngineRequest *request,
@@ -5169,6 +5527,7 @@ fu_engine_add_releases_for_device_component(FuEngine *self,
 {
 	FwupdFeatureFlags feature_flags;
 	FwupdVersionFormat fmt = fu_device_get_version_format(device);
+	gboolean no_requirements;
 	g_autoptr(GError) error_local = NULL;
 	g_autoptr(GPtrArray) releases_tmp = NULL;
 	FwupdInstallFlags install_flags =
@@ -5180,7 +5539,7 @@ fu_engine_add_releases_for_device_component(FuEngine *self,
 #endif
 
 	/* get all releases */
-	releases_tmp = xb_node_query(component, "releases/release", 0, &error_local);
+	releases_tmp = fu_engine_get_releases_for_component(self, component, &error_local);
 	if (releases_tmp == NULL) {
 		if (g_error_matches(error_local, G_IO_ERROR, G_IO_ERROR_NOT_FOUND))
 			return TRUE;
@@ -5190,6 +5549,8 @@ fu_engine_add_releases_for_device_component(FuEngine *self,
 		return FALSE;
 	}
 	feature_flags = fu_engine_request_get_feature_flags(request);
+	no_requirements =
+	    fu_engine_request_has_flag(request, FU_ENGINE_REQUEST_FLAG_NO_REQUIREMENTS);
 	for (guint i = 0; i < releases_tmp->len; i++) {
 		XbNode *rel = g_ptr_array_index(releases_tmp, i);
 		const gchar *remote_id;
@@ -5199,9 +5560,21 @@ fu_engine_add_releases_for_device_component(FuEngine *self,
 		gint vercmp;
 		GPtrArray *checksums;
 		GPtrArray *locations;
+		g_autofree gchar *failure_key = NULL;
 		g_autoptr(FuRelease) release = fu_release_new();
 		g_autoptr(GError) error_loop = NULL;
 
+		/* already failed the requirements, and nothing has changed since */
+		failure_key =
+		    g_strdup_printf("%s:%p:%" G_GUINT64_FORMAT ":%" G_GUINT64_FORMAT ":%i",
+				    fu_device_get_id(device),
+				    rel,
+				    (guint64)feature_flags,
+				    (guint64)fu_engine_request_get_device_flags(request),
+				    no_requirements);
+		if (g_hash_table_contains(self->release_failures, failure_key))
+			continue;
+
 		/* create new FwupdRelease for the XbNode */
 		fu_release_set_request(release, request);
 		fu_release_set_device(release, device);
@@ -5213,6 +5586,7 @@ fu_engine_add_releases_for_device_component(FuEngine *self,
 					    install_flags,
 					    &error_loop)) {
 			g_debug("failed to set release for component: %s", error_loop->message);
+			g_hash_table_add(self->release_failures, g_steal_pointer(&failure_key));
 			continue;
 		}
 
@@ -5328,8 +5702,8 @@ fu_engine_get_releases_for_device(FuEngine *self,
 	g_autoptr(GPtrArray) branches = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 
-	/* no components in silo */
-	if (self->query_component_by_guid == NULL) {
+	/* no components in any silo */
+	if (!fu_engine_has_components(self)) {
 		g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no components in silo");
 		return NULL;
 	}
@@ -5373,18 +5747,10 @@ fu_engine_get_releases_for_device(FuEngine *self,
 	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	for (guint j = 0; j < device_guids->len; j++) {
 		const gchar *guid = g_ptr_array_index(device_guids, j);
-		g_autoptr(GError) error_local = NULL;
-		g_autoptr(GPtrArray) components = NULL;
-		g_auto(XbQueryContext) context = XB_QUERY_CONTEXT_INIT();
+		GPtrArray *components = g_hash_table_lookup(self->component_index, guid);
 
-		xb_query_context_set_flags(&context, XB_QUERY_FLAG_USE_INDEXES);
-		xb_value_bindings_bind_str(xb_query_context_get_bindings(&context), 0, guid, NULL);
-		components = xb_silo_query_with_context(self->silo,
-							self->query_component_by_guid,
-							&context,
-							&error_local);
 		if (components == NULL) {
-			g_debug("%s was not found: %s", guid, error_local->message);
+			g_debug("%s was not found", guid);
 			continue;
 		}
 
@@ -5666,6 +6032,19 @@ fu_engine_add_blocked_firmware(FuEngine *self, const gchar *checksum)
 	g_hash_table_add(self->blocked_firmware, g_strdup(checksum));
 }
 
+static gboolean
+fu_engine_save_blocked_firmware(FuEngine *self, GPtrArray *checksums, GError **error)
+{
+	if (!fu_history_clear_blocked_firmware(self->history, error))
+		return FALSE;
+	for (guint i = 0; i < checksums->len; i++) {
+		const gchar *csum = g_ptr_array_index(checksums, i);
+		if (!fu_history_add_blocked_firmware(self->history, csum, error))
+			return FALSE;
+	}
+	return TRUE;
+}
+
 gboolean
 fu_engine_set_blocked_firmware(FuEngine *self, GPtrArray *checksums, GError **error)
 {
@@ -5680,14 +6059,13 @@ fu_engine_set_blocked_firmware(FuEngine *self, GPtrArray *checksums, GError **er
 	}
 
 	/* save database */
-	if (!fu_history_clear_blocked_firmware(self->history, error))
+	if (!fu_history_begin_transaction(self->history, error))
+		return FALSE;
+	if (!fu_engine_save_blocked_firmware(self, checksums, error)) {
+		fu_history_rollback_transaction(self->history);
 		return FALSE;
-	for (guint i = 0; i < checksums->len; i++) {
-		const gchar *csum = g_ptr_array_index(checksums, i);
-		if (!fu_history_add_blocked_firmware(self->history, csum, error))
-			return FALSE;
 	}
-	return TRUE;
+	return fu_history_commit_transaction(self->history, error);
 }
 
 gchar *
@@ -5963,9 +6341,22 @@ fu_engine_plugins_startup(FuEngine *self, FuProgress *progress)
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, plugins->len);
 	for (guint i = 0; i < plugins->len; i++) {
+		FuEngineMeasure *measure;
+		gboolean ret;
 		g_autoptr(GError) error = NULL;
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_startup(plugin, fu_progress_get_child(progress), &error)) {
+
+		if (fu_engine_plugin_is_deferred(self, plugin)) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+		measure = fu_engine_measure_begin(self,
+						  "plugin",
+						  fu_plugin_get_name(plugin),
+						  "startup");
+		ret = fu_plugin_runner_startup(plugin, fu_progress_get_child(progress), &error);
+		fu_engine_measure_end(self, measure);
+		if (!ret) {
 			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
 			if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
 				fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
@@ -5984,9 +6375,22 @@ fu_engine_plugins_ready(FuEngine *self, FuProgress *progress)
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, plugins->len);
 	for (guint i = 0; i < plugins->len; i++) {
+		FuEngineMeasure *measure;
+		gboolean ret;
 		g_autoptr(GError) error = NULL;
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_ready(plugin, fu_progress_get_child(progress), &error)) {
+
+		if (fu_engine_plugin_is_deferred(self, plugin)) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+		measure = fu_engine_measure_begin(self,
+						  "plugin",
+						  fu_plugin_get_name(plugin),
+						  "ready");
+		ret = fu_plugin_runner_ready(plugin, fu_progress_get_child(progress), &error);
+		fu_engine_measure_end(self, measure);
+		if (!ret) {
 			if (g_error_matches(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
 				fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
 			}
@@ -6008,9 +6412,22 @@ fu_engine_plugins_coldplug(FuEngine *self, FuProgress *progress)
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_set_steps(progress, plugins->len);
 	for (guint i = 0; i < plugins->len; i++) {
+		FuEngineMeasure *measure;
+		gboolean ret;
 		g_autoptr(GError) error = NULL;
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
-		if (!fu_plugin_runner_coldplug(plugin, fu_progress_get_child(progress), &error)) {
+
+		if (fu_engine_plugin_is_deferred(self, plugin)) {
+			fu_progress_step_done(progress);
+			continue;
+		}
+		measure = fu_engine_measure_begin(self,
+						  "plugin",
+						  fu_plugin_get_name(plugin),
+						  "coldplug");
+		ret = fu_plugin_runner_coldplug(plugin, fu_progress_get_child(progress), &error);
+		fu_engine_measure_end(self, measure);
+		if (!ret) {
 			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
 			g_info("disabling plugin because: %s", error->message);
 			fu_progress_add_flag(progress, FU_PROGRESS_FLAG_CHILD_FINISHED);
@@ -6042,6 +6459,8 @@ fu_engine_plugin_device_register(FuEngine *self, FuDevice *device)
 	plugins = fu_plugin_list_get_all(self->plugin_list);
 	for (guint i = 0; i < plugins->len; i++) {
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
+		if (fu_engine_plugin_is_deferred(self, plugin))
+			continue;
 		fu_plugin_runner_device_register(plugin, device);
 	}
 	for (guint i = 0; i < self->backends->len; i++) {
@@ -6566,6 +6985,43 @@ fu_engine_is_plugin_name_enabled(FuEngine *self, const gchar *name)
 	return FALSE;
 }
 
+/* any one of the values may match */
+static gboolean
+fu_engine_plugin_check_requirements(FuEngine *self, FuPlugin *plugin, GError **error)
+{
+	GPtrArray *values = fu_plugin_get_rules(plugin, FU_PLUGIN_RULE_REQUIRES_CPU);
+	const gchar *vendor = fu_cpu_vendor_to_string(fu_cpu_get_vendor());
+	g_autoptr(GString) str = g_string_new(NULL);
+
+	if (values == NULL)
+		return TRUE;
+	for (guint i = 0; i < values->len; i++) {
+		const gchar *value = g_ptr_array_index(values, i);
+		if (g_strcmp0(vendor, value) == 0)
+			return TRUE;
+		if (str->len > 0)
+			g_string_append(str, "|");
+		g_string_append(str, value);
+	}
+	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "requires %s", str->str);
+	return FALSE;
+}
+
+/* plugins without any FU_PLUGIN_RULE_DEVICE_BACKEND rules accept devices from all backends */
+static gboolean
+fu_engine_plugin_has_device_backend(FuPlugin *plugin, FuBackend *backend)
+{
+	GPtrArray *backends = fu_plugin_get_rules(plugin, FU_PLUGIN_RULE_DEVICE_BACKEND);
+	if (backends == NULL)
+		return TRUE;
+	for (guint i = 0; i < backends->len; i++) {
+		const gchar *name = g_ptr_array_index(backends, i);
+		if (g_strcmp0(name, fu_backend_get_name(backend)) == 0)
+			return TRUE;
+	}
+	return FALSE;
+}
+
 void
 fu_engine_add_plugin_filter(FuEngine *self, const gchar *plugin_glob)
 {
@@ -6580,7 +7036,6 @@ fu_engine_add_plugin_filter(FuEngine *self, const gchar *plugin_glob)
 static gboolean
 fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngine *self)
 {
-	g_autoptr(XbNode) n = NULL;
 	g_autofree gchar *xpath = NULL;
 
 	if (fu_engine_config_get_enumerate_all_devices(self->config))
@@ -6589,8 +7044,13 @@ fu_engine_plugin_check_supported_cb(FuPlugin *plugin, const gchar *guid, FuEngin
 	xpath = g_strdup_printf("components/component[@type='firmware']/"
 				"provides/firmware[@type='flashed'][text()='%s']",
 				guid);
-	n = xb_silo_query_first(self->silo, xpath, NULL);
-	return n != NULL;
+	for (guint i = 0; i < self->silos->len; i++) {
+		FuEngineSilo *item = g_ptr_array_index(self->silos, i);
+		g_autoptr(XbNode) n = xb_silo_query_first(item->silo, xpath, NULL);
+		if (n != NULL)
+			return TRUE;
+	}
+	return FALSE;
 }
 
 FuEngineConfig *
@@ -6725,7 +7185,7 @@ fu_engine_attrs_calculate_hsi_for_chassis(FuEngine *self)
 }
 
 static gboolean
-fu_engine_record_security_attrs(FuEngine *self, GError **error)
+fu_engine_record_security_attrs_internal(FuEngine *self, GError **error)
 {
 	g_autoptr(GPtrArray) attrs_array = NULL;
 	g_autofree gchar *json = NULL;
@@ -6764,6 +7224,19 @@ fu_engine_record_security_attrs(FuEngine *self, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_engine_record_security_attrs(FuEngine *self, GError **error)
+{
+	/* the check for the previous boot and the write are synced to disk once */
+	if (!fu_history_begin_transaction(self->history, error))
+		return FALSE;
+	if (!fu_engine_record_security_attrs_internal(self, error)) {
+		fu_history_rollback_transaction(self->history);
+		return FALSE;
+	}
+	return fu_history_commit_transaction(self->history, error);
+}
+
 static void
 fu_engine_security_attrs_depsolve(FuEngine *self)
 {
@@ -7124,6 +7597,7 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 	g_autoptr(GPtrArray) devices = fu_device_list_get_active(self->device_list);
 	g_autoptr(GPtrArray) vals = NULL;
 	g_autoptr(GError) error = NULL;
+	g_autoptr(GError) error_compact = NULL;
 
 	/* already valid */
 	if (self->host_security_id != NULL || self->host_emulation)
@@ -7145,6 +7619,8 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 	/* call into plugins */
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
+		if (fu_engine_plugin_is_deferred(self, plugin_tmp))
+			continue;
 		fu_plugin_runner_add_security_attrs(plugin_tmp, self->host_security_attrs);
 	}
 
@@ -7171,6 +7647,14 @@ fu_engine_ensure_security_attrs(FuEngine *self)
 	/* record into the database (best effort) */
 	if (!fu_engine_record_security_attrs(self, &error))
 		g_warning("failed to record HSI attributes: %s", error->message);
+
+	/* keep the database a bounded size */
+	if (!fu_history_compact_security_attrs(
+		self->history,
+		(guint64)fu_engine_config_get_security_history_max_age(self->config) * 24 * 60 * 60,
+		fu_engine_config_get_security_history_max_entries(self->config),
+		&error_compact))
+		g_warning("failed to compact HSI attributes: %s", error_compact->message);
 #endif
 }
 
@@ -7334,6 +7818,7 @@ fu_engine_plugins_init(FuEngine *self, FuProgress *progress, GError **error)
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
 	g_autoptr(GPtrArray) plugins_disabled = g_ptr_array_new_with_free_func(g_free);
 	g_autoptr(GPtrArray) plugins_disabled_rt = g_ptr_array_new_with_free_func(g_free);
+	g_autoptr(GPtrArray) plugins_deferred = g_ptr_array_new_with_free_func(g_free);
 
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
@@ -7341,6 +7826,7 @@ fu_engine_plugins_init(FuEngine *self, FuProgress *progress, GError **error)
 	for (guint i = 0; i < plugins->len; i++) {
 		FuPlugin *plugin = g_ptr_array_index(plugins, i);
 		const gchar *name = fu_plugin_get_name(plugin);
+		g_autoptr(GError) error_local = NULL;
 
 		/* progress */
 		fu_progress_set_name(fu_progress_get_child(progress), name);
@@ -7358,6 +7844,13 @@ fu_engine_plugins_init(FuEngine *self, FuProgress *progress, GError **error)
 		/* init plugin, adding device and firmware GTypes */
 		fu_plugin_runner_init(plugin);
 
+		/* the manifest does not match this hardware, so never start the plugin */
+		if (!fu_engine_plugin_check_requirements(self, plugin, &error_local)) {
+			g_debug("%s %s", name, error_local->message);
+			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
+		}
+
 		/* runtime disabled */
 		if (fu_plugin_has_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED)) {
 			g_ptr_array_add(plugins_disabled_rt, g_strdup(name));
@@ -7386,6 +7879,12 @@ fu_engine_plugins_init(FuEngine *self, FuProgress *progress, GError **error)
 				 "rules-changed",
 				 G_CALLBACK(fu_engine_plugin_rules_changed_cb),
 				 self);
+
+		/* started when the first device it can handle is added */
+		if (fu_plugin_get_rules(plugin, FU_PLUGIN_RULE_DEVICE_BACKEND) != NULL) {
+			g_ptr_array_add(plugins_deferred, g_strdup(name));
+			g_ptr_array_add(self->plugins_deferred, g_object_ref(plugin));
+		}
 		fu_progress_step_done(progress);
 	}
 
@@ -7402,6 +7901,12 @@ fu_engine_plugins_init(FuEngine *self, FuProgress *progress, GError **error)
 		str = g_strjoinv(", ", (gchar **)plugins_disabled_rt->pdata);
 		g_info("plugins runtime-disabled: %s", str);
 	}
+	if (plugins_deferred->len > 0) {
+		g_autofree gchar *str = NULL;
+		g_ptr_array_add(plugins_deferred, NULL);
+		str = g_strjoinv(", ", (gchar **)plugins_deferred->pdata);
+		g_info("plugins deferred: %s", str);
+	}
 
 	/* depsolve into the correct order */
 	if (!fu_plugin_list_depsolve(self->plugin_list, error))
@@ -7526,14 +8031,63 @@ fu_engine_backend_device_removed_cb(FuBackend *backend, FuDevice *device, FuEngi
 	}
 }
 
+/* starts a plugin deferred using FU_PLUGIN_RULE_DEVICE_BACKEND */
+static gboolean
+fu_engine_plugin_ensure_started(FuEngine *self, FuPlugin *plugin, GError **error)
+{
+	FuEngineMeasure *measure;
+	gboolean ret;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error_local = NULL;
+
+	/* not deferred, or already started */
+	if (!g_ptr_array_remove(self->plugins_deferred, plugin))
+		return TRUE;
+
+	g_info("starting deferred plugin %s", fu_plugin_get_name(plugin));
+	measure = fu_engine_measure_begin(self, "plugin", fu_plugin_get_name(plugin), "startup");
+	ret = fu_plugin_runner_startup(plugin, progress, &error_local);
+	fu_engine_measure_end(self, measure);
+	if (!ret) {
+		fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_DISABLED);
+		if (g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED))
+			fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
+		g_info("disabling plugin because: %s", error_local->message);
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "plugin %s failed to start: %s",
+			    fu_plugin_get_name(plugin),
+			    error_local->message);
+		return FALSE;
+	}
+
+	/* the other plugins were made ready at the end of the engine load */
+	if (self->loaded) {
+		g_autoptr(FuProgress) progress_ready = fu_progress_new(G_STRLOC);
+		g_autoptr(GError) error_ready = NULL;
+		if (!fu_plugin_runner_ready(plugin, progress_ready, &error_ready)) {
+			if (g_error_matches(error_ready, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED))
+				fu_plugin_add_flag(plugin, FWUPD_PLUGIN_FLAG_NO_HARDWARE);
+			g_info("failed to make plugin ready: %s", error_ready->message);
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
 static gboolean
 fu_engine_backend_device_added_run_plugin(FuEngine *self,
+					  FuBackend *backend,
 					  FuDevice *device,
 					  const gchar *plugin_name,
 					  FuProgress *progress,
 					  GError **error)
 {
+	FuEngineMeasure *measure;
 	FuPlugin *plugin;
+	gboolean ret;
 
 	/* find plugin */
 	fu_progress_set_name(progress, plugin_name);
@@ -7541,8 +8095,24 @@ fu_engine_backend_device_added_run_plugin(FuEngine *self,
 	if (plugin == NULL)
 		return FALSE;
 
+	/* the plugin only handles devices from specific backends */
+	if (!fu_engine_plugin_has_device_backend(plugin, backend)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_NOT_SUPPORTED,
+			    "%s does not handle devices from the %s backend",
+			    plugin_name,
+			    fu_backend_get_name(backend));
+		return FALSE;
+	}
+	if (!fu_engine_plugin_ensure_started(self, plugin, error))
+		return FALSE;
+
 	/* run the ->probe() then ->setup() vfuncs */
-	if (!fu_plugin_runner_backend_device_added(plugin, device, progress, error)) {
+	measure = fu_engine_measure_begin(self, "plugin", plugin_name, "backend-device-added");
+	ret = fu_plugin_runner_backend_device_added(plugin, device, progress, error);
+	fu_engine_measure_end(self, measure);
+	if (!ret) {
 #ifdef SUPPORTED_BUILD
 		/* sanity check */
 		if (*error == NULL) {
@@ -7562,7 +8132,10 @@ fu_engine_backend_device_added_run_plugin(FuEngine *self,
 }
 
 static void
-fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuProgress *progress)
+fu_engine_backend_device_added_run_plugins(FuEngine *self,
+					   FuBackend *backend,
+					   FuDevice *device,
+					   FuProgress *progress)
 {
 	g_autoptr(GPtrArray) possible_plugins = fu_device_get_possible_plugins(device);
 
@@ -7573,6 +8146,7 @@ fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuP
 		const gchar *plugin_name = g_ptr_array_index(possible_plugins, i);
 		g_autoptr(GError) error_local = NULL;
 		if (!fu_engine_backend_device_added_run_plugin(self,
+							       backend,
 							       device,
 							       plugin_name,
 							       fu_progress_get_child(progress),
@@ -7593,8 +8167,13 @@ fu_engine_backend_device_added_run_plugins(FuEngine *self, FuDevice *device, FuP
 }
 
 static void
-fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *progress)
+fu_engine_backend_device_added(FuEngine *self,
+			       FuBackend *backend,
+			       FuDevice *device,
+			       FuProgress *progress)
 {
+	FuEngineMeasure *measure;
+	gboolean ret;
 	g_autofree gchar *str1 = NULL;
 	g_autofree gchar *str2 = NULL;
 	g_autoptr(GError) error_local = NULL;
@@ -7612,7 +8191,10 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 
 	/* add any extra quirks */
 	fu_device_set_context(device, self->ctx);
-	if (!fu_device_probe(device, &error_local)) {
+	measure = fu_engine_measure_begin(self, "backend", fu_backend_get_name(backend), "probe");
+	ret = fu_device_probe(device, &error_local);
+	fu_engine_measure_end(self, measure);
+	if (!ret) {
 		if (!g_error_matches(error_local, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED)) {
 			g_warning("failed to probe device %s: %s",
 				  fu_device_get_backend_id(device),
@@ -7638,7 +8220,10 @@ fu_engine_backend_device_added(FuEngine *self, FuDevice *device, FuProgress *pro
 	fu_engine_check_firmware_attributes(self, device, TRUE);
 
 	/* can be specified using a quirk */
-	fu_engine_backend_device_added_run_plugins(self, device, fu_progress_get_child(progress));
+	fu_engine_backend_device_added_run_plugins(self,
+						   backend,
+						   device,
+						   fu_progress_get_child(progress));
 	fu_progress_step_done(progress);
 }
 
@@ -7646,7 +8231,7 @@ static void
 fu_engine_backend_device_added_cb(FuBackend *backend, FuDevice *device, FuEngine *self)
 {
 	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
-	fu_engine_backend_device_added(self, device, progress);
+	fu_engine_backend_device_added(self, backend, device, progress);
 }
 
 static void
@@ -7689,6 +8274,8 @@ fu_engine_backend_device_changed_cb(FuBackend *backend, FuDevice *device, FuEngi
 	for (guint j = 0; j < plugins->len; j++) {
 		FuPlugin *plugin_tmp = g_ptr_array_index(plugins, j);
 		g_autoptr(GError) error = NULL;
+		if (fu_engine_plugin_is_deferred(self, plugin_tmp))
+			continue;
 		if (!fu_plugin_runner_backend_device_changed(plugin_tmp, device, &error)) {
 #ifdef SUPPORTED_BUILD
 			/* sanity check */
@@ -7863,6 +8450,10 @@ fu_engine_update_history_database(FuEngine *self, GError **error)
 	devices = fu_history_get_devices(self->history, error);
 	if (devices == NULL)
 		return FALSE;
+
+	/* only sync the database once */
+	if (!fu_history_begin_transaction(self->history, error))
+		return FALSE;
 	for (guint i = 0; i < devices->len; i++) {
 		FuDevice *dev = g_ptr_array_index(devices, i);
 		g_autoptr(GError) error_local = NULL;
@@ -7882,7 +8473,7 @@ fu_engine_update_history_database(FuEngine *self, GError **error)
 			g_warning("failed to update history database: %s", error_local->message);
 		}
 	}
-	return TRUE;
+	return fu_history_commit_transaction(self->history, error);
 }
 
 static void
@@ -8020,6 +8611,23 @@ fu_common_win32_registry_get_string(HKEY hkey,
 }
 #endif
 
+static void
+fu_engine_backend_watch(FuEngine *self, FuBackend *backend)
+{
+	g_signal_connect(FU_BACKEND(backend),
+			 "device-added",
+			 G_CALLBACK(fu_engine_backend_device_added_cb),
+			 self);
+	g_signal_connect(FU_BACKEND(backend),
+			 "device-removed",
+			 G_CALLBACK(fu_engine_backend_device_removed_cb),
+			 self);
+	g_signal_connect(FU_BACKEND(backend),
+			 "device-changed",
+			 G_CALLBACK(fu_engine_backend_device_changed_cb),
+			 self);
+}
+
 static gboolean
 fu_engine_backends_coldplug_backend_add_devices(FuEngine *self,
 						FuBackend *backend,
@@ -8033,7 +8641,10 @@ fu_engine_backends_coldplug_backend_add_devices(FuEngine *self,
 	fu_progress_set_steps(progress, devices->len);
 	for (guint i = 0; i < devices->len; i++) {
 		FuDevice *device = g_ptr_array_index(devices, i);
-		fu_engine_backend_device_added(self, device, fu_progress_get_child(progress));
+		fu_engine_backend_device_added(self,
+					       backend,
+					       device,
+					       fu_progress_get_child(progress));
 		fu_progress_step_done(progress);
 	}
 
@@ -8047,6 +8658,9 @@ fu_engine_backends_coldplug_backend(FuEngine *self,
 				    FuProgress *progress,
 				    GError **error)
 {
+	FuEngineMeasure *measure;
+	gboolean ret;
+
 	/* progress */
 	fu_progress_set_id(progress, G_STRLOC);
 	fu_progress_add_flag(progress, FU_PROGRESS_FLAG_NO_PROFILE);
@@ -8055,7 +8669,13 @@ fu_engine_backends_coldplug_backend(FuEngine *self,
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 99, "add-devices");
 
 	/* coldplug */
-	if (!fu_backend_coldplug(backend, fu_progress_get_child(progress), error))
+	measure = fu_engine_measure_begin(self,
+					  "backend",
+					  fu_backend_get_name(backend),
+					  "coldplug");
+	ret = fu_backend_coldplug(backend, fu_progress_get_child(progress), error);
+	fu_engine_measure_end(self, measure);
+	if (!ret)
 		return FALSE;
 	fu_progress_step_done(progress);
 
@@ -8067,21 +8687,18 @@ fu_engine_backends_coldplug_backend(FuEngine *self,
 	fu_progress_step_done(progress);
 
 	/* success */
-	g_signal_connect(FU_BACKEND(backend),
-			 "device-added",
-			 G_CALLBACK(fu_engine_backend_device_added_cb),
-			 self);
-	g_signal_connect(FU_BACKEND(backend),
-			 "device-removed",
-			 G_CALLBACK(fu_engine_backend_device_removed_cb),
-			 self);
-	g_signal_connect(FU_BACKEND(backend),
-			 "device-changed",
-			 G_CALLBACK(fu_engine_backend_device_changed_cb),
-			 self);
+	fu_engine_backend_watch(self, backend);
 	return TRUE;
 }
 
+/* this is only used by the self tests, as the backend is never set up or coldplugged */
+void
+fu_engine_add_backend(FuEngine *self, FuBackend *backend)
+{
+	g_ptr_array_add(self->backends, g_object_ref(backend));
+	fu_engine_backend_watch(self, backend);
+}
+
 static void
 fu_engine_backends_coldplug(FuEngine *self, FuProgress *progress)
 {
@@ -8116,6 +8733,21 @@ fu_engine_backends_coldplug(FuEngine *self, FuProgress *progress)
 	}
 }
 
+/* ends the profiler span for the current step of fu_engine_load() and begins the next */
+static void
+fu_engine_load_step_done(FuEngine *self, FuProgress *progress, guint *phase)
+{
+	fu_profiler_end(self->profiler, *phase);
+	fu_progress_step_done(progress);
+	if (fu_progress_get_percentage(progress) == 100) {
+		*phase = 0;
+		return;
+	}
+	*phase = fu_profiler_begin(self->profiler,
+				   "phase",
+				   fu_progress_get_name(fu_progress_get_child(progress)));
+}
+
 /**
  * fu_engine_load:
  * @self: a #FuEngine
@@ -8132,6 +8764,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 {
 	FuPlugin *plugin_uefi;
 	FuQuirksLoadFlags quirks_flags = FU_QUIRKS_LOAD_FLAG_NONE;
+	guint phase;
 	GPtrArray *plugins = fu_plugin_list_get_all(self->plugin_list);
 	const gchar *host_emulate = g_getenv("FWUPD_HOST_EMULATE");
 	g_autoptr(GPtrArray) checksums_approved = NULL;
@@ -8171,6 +8804,9 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 90, "backend-coldplug");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "plugins-ready");
 	fu_progress_add_step(progress, FWUPD_STATUS_LOADING, 1, "update-history-db");
+	phase = fu_profiler_begin(self->profiler,
+				  "phase",
+				  fu_progress_get_name(fu_progress_get_child(progress)));
 
 	/* sanity check libraries are in sync with daemon */
 	if (g_strcmp0(fwupd_version_string(), VERSION) != 0) {
@@ -8205,7 +8841,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 		g_prefix_error(error, "Failed to load config: ");
 		return FALSE;
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* set the hardcoded ESP */
 	if (fu_engine_config_get_esp_location(self->config) != NULL) {
@@ -8228,11 +8864,11 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 			return FALSE;
 		}
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* create client certificate */
 	fu_engine_ensure_client_certificate(self);
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* get hardcoded approved and blocked firmware */
 	checksums_approved = fu_engine_config_get_approved_firmware(self->config);
@@ -8261,14 +8897,14 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 		const gchar *csum = g_ptr_array_index(checksums_blocked, i);
 		fu_engine_add_blocked_firmware(self, csum);
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* load plugins early, as we have to call ->load() *before* building quirk silo */
 	if (!fu_engine_load_plugins(self, flags, fu_progress_get_child(progress), error)) {
 		g_prefix_error(error, "failed to load plugins: ");
 		return FALSE;
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* migrate per-plugin settings into fwupd.conf */
 	plugin_uefi = fu_plugin_list_find_by_name(self->plugin_list, "uefi_capsule", NULL);
@@ -8297,7 +8933,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 		quirks_flags |= FU_QUIRKS_LOAD_FLAG_NO_CACHE;
 	if (!fu_context_load_quirks(self->ctx, quirks_flags, &error_quirks))
 		g_warning("Failed to load quirks: %s", error_quirks->message);
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* load SMBIOS and the hwids */
 	if (flags & FU_ENGINE_LOAD_FLAG_HWINFO) {
@@ -8307,14 +8943,14 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 					    error))
 			return FALSE;
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* load AppStream metadata */
 	if (!fu_engine_load_metadata_store(self, flags, error)) {
 		g_prefix_error(error, "Failed to load AppStream data: ");
 		return FALSE;
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* watch the local.d directories for changes */
 	if (!fu_engine_load_local_metadata_watches(self, error))
@@ -8391,10 +9027,19 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG) {
 		for (guint i = 0; i < self->backends->len; i++) {
 			FuBackend *backend = g_ptr_array_index(self->backends, i);
+			FuEngineMeasure *measure;
+			gboolean ret;
 			g_autoptr(GError) error_backend = NULL;
-			if (!fu_backend_setup(backend,
-					      fu_progress_get_child(progress),
-					      &error_backend)) {
+
+			measure = fu_engine_measure_begin(self,
+							  "backend",
+							  fu_backend_get_name(backend),
+							  "setup");
+			ret = fu_backend_setup(backend,
+					       fu_progress_get_child(progress),
+					       &error_backend);
+			fu_engine_measure_end(self, measure);
+			if (!ret) {
 				g_info("failed to setup backend %s: %s",
 				       fu_backend_get_name(backend),
 				       error_backend->message);
@@ -8402,7 +9047,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 			}
 		}
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* delete old data files */
 	if (!fu_engine_cleanup_state(error)) {
@@ -8415,7 +9060,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 		g_prefix_error(error, "failed to init plugins: ");
 		return FALSE;
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* set quirks for each hwid */
 	if (fu_context_has_flag(self->ctx, FU_CONTEXT_FLAG_LOADED_HWINFO)) {
@@ -8425,7 +9070,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 			fu_engine_load_quirks_for_hwid(self, hwid);
 		}
 	}
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* set up battery threshold */
 	if (fu_context_has_flag(self->ctx, FU_CONTEXT_FLAG_LOADED_HWINFO))
@@ -8449,25 +9094,25 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 	/* add devices */
 	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG) {
 		fu_engine_plugins_startup(self, fu_progress_get_child(progress));
-		fu_progress_step_done(progress);
+		fu_engine_load_step_done(self, progress, &phase);
 		fu_engine_plugins_coldplug(self, fu_progress_get_child(progress));
-		fu_progress_step_done(progress);
+		fu_engine_load_step_done(self, progress, &phase);
 	} else {
-		fu_progress_step_done(progress);
-		fu_progress_step_done(progress);
+		fu_engine_load_step_done(self, progress, &phase);
+		fu_engine_load_step_done(self, progress, &phase);
 	}
 
 	/* coldplug backends */
 	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG)
 		fu_engine_backends_coldplug(self, fu_progress_get_child(progress));
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* coldplug done, so plugin is ready */
 	if (flags & FU_ENGINE_LOAD_FLAG_COLDPLUG) {
 		fu_engine_plugins_ready(self, fu_progress_get_child(progress));
-		fu_progress_step_done(progress);
+		fu_engine_load_step_done(self, progress, &phase);
 	} else {
-		fu_progress_step_done(progress);
+		fu_engine_load_step_done(self, progress, &phase);
 	}
 
 	/* dump plugin information to the console */
@@ -8482,11 +9127,14 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 		fu_plugin_add_string(plugin, 0, str);
 	}
 	g_info("%s", str->str);
+	g_info("quirk cache: %u hits, %u misses",
+	       fu_quirks_get_cache_hits(fu_context_get_quirks(self->ctx)),
+	       fu_quirks_get_cache_misses(fu_context_get_quirks(self->ctx)));
 
 	/* update the db for devices that were updated during the reboot */
 	if (!fu_engine_update_history_database(self, error))
 		return FALSE;
-	fu_progress_step_done(progress);
+	fu_engine_load_step_done(self, progress, &phase);
 
 	/* update the devices JSON file */
 	if (!fu_engine_update_devices_file(self, &error_json_devices))
@@ -8504,6 +9152,7 @@ fu_engine_load(FuEngine *self, FuEngineLoadFlags flags, FuProgress *progress, GE
 #endif
 
 	fu_engine_set_status(self, FWUPD_STATUS_IDLE);
+	fu_profiler_stop(self->profiler);
 	self->loaded = TRUE;
 
 	/* let clients know engine finished starting up */
@@ -8872,9 +9521,12 @@ fu_engine_init(FuEngine *self)
 	self->remote_list = fu_remote_list_new();
 	self->device_list = fu_device_list_new();
 	self->idle = fu_idle_new();
+	self->metrics = fu_metrics_new();
+	self->profiler = fu_profiler_new();
 	self->history = fu_history_new();
 	self->plugin_list = fu_plugin_list_new();
 	self->plugin_filter = g_ptr_array_new_with_free_func(g_free);
+	self->plugins_deferred = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->host_security_attrs = fu_security_attrs_new();
 	self->backends = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	self->local_monitors = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
@@ -8883,6 +9535,16 @@ fu_engine_init(FuEngine *self)
 	self->emulation_backend_ids = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
 	self->device_changed_allowlist =
 	    g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->component_index = g_hash_table_new_full(g_str_hash,
+						      g_str_equal,
+						      g_free,
+						      (GDestroyNotify)g_ptr_array_unref);
+	self->release_index = g_hash_table_new_full(g_direct_hash,
+						    g_direct_equal,
+						    (GDestroyNotify)g_object_unref,
+						    (GDestroyNotify)g_ptr_array_unref);
+	self->release_failures = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	self->silos = g_ptr_array_new_with_free_func((GDestroyNotify)fu_engine_silo_free);
 #ifdef HAVE_PASSIM
 	self->passim_client = passim_client_new();
 #endif
@@ -8908,16 +9570,10 @@ fu_engine_finalize(GObject *obj)
 		g_file_monitor_cancel(monitor);
 	}
 
-	if (self->silo != NULL)
-		g_object_unref(self->silo);
-	if (self->query_component_by_guid != NULL)
-		g_object_unref(self->query_component_by_guid);
-	if (self->query_container_checksum1 != NULL)
-		g_object_unref(self->query_container_checksum1);
-	if (self->query_container_checksum2 != NULL)
-		g_object_unref(self->query_container_checksum2);
-	if (self->query_tag_by_guid_version != NULL)
-		g_object_unref(self->query_tag_by_guid_version);
+	g_hash_table_unref(self->release_failures);
+	g_hash_table_unref(self->release_index);
+	g_hash_table_unref(self->component_index);
+	g_ptr_array_unref(self->silos);
 	if (self->coldplug_id != 0)
 		g_source_remove(self->coldplug_id);
 	if (self->approved_firmware != NULL)
@@ -8938,6 +9594,8 @@ fu_engine_finalize(GObject *obj)
 	g_free(self->host_security_id);
 	g_object_unref(self->host_security_attrs);
 	g_object_unref(self->idle);
+	g_object_unref(self->metrics);
+	g_object_unref(self->profiler);
 	g_object_unref(self->config);
 	g_object_unref(self->remote_list);
 	g_object_unref(self->ctx);
@@ -8945,6 +9603,7 @@ fu_engine_finalize(GObject *obj)
 	g_object_unref(self->device_list);
 	g_object_unref(self->jcat_context);
 	g_ptr_array_unref(self->plugin_filter);
+	g_ptr_array_unref(self->plugins_deferred);
 	g_ptr_array_unref(self->backends);
 	g_ptr_array_unref(self->local_monitors);
 	g_hash_table_unref(self->emulation_phases);
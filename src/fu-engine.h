@@ -15,6 +15,8 @@
 
 #include "fu-cabinet.h"
 #include "fu-engine-config.h"
+#include "fu-metrics.h"
+#include "fu-profiler.h"
 #include "fu-release.h"
 
 #define FU_TYPE_ENGINE (fu_engine_get_type())
@@ -229,6 +231,10 @@ gboolean
 fu_engine_reset_config(FuEngine *self, const gchar *section, GError **error) G_GNUC_NON_NULL(1, 2);
 FuContext *
 fu_engine_get_context(FuEngine *self) G_GNUC_NON_NULL(1);
+FuMetrics *
+fu_engine_get_metrics(FuEngine *self) G_GNUC_NON_NULL(1);
+FuProfiler *
+fu_engine_get_profiler(FuEngine *self) G_GNUC_NON_NULL(1);
 GPtrArray *
 fu_engine_get_releases_for_device(FuEngine *self,
 				  FuEngineRequest *request,
@@ -237,6 +243,8 @@ fu_engine_get_releases_for_device(FuEngine *self,
 
 /* for the self tests */
 void
+fu_engine_add_backend(FuEngine *self, FuBackend *backend) G_GNUC_NON_NULL(1, 2);
+void
 fu_engine_add_device(FuEngine *self, FuDevice *device) G_GNUC_NON_NULL(1, 2);
 void
 fu_engine_add_plugin(FuEngine *self, FuPlugin *plugin) G_GNUC_NON_NULL(1, 2);
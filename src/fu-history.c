@@ -36,8 +36,9 @@
  * v11	no changes, bumped due to bungled migration to v10
  * v12	add install_duration to history
  * v13	add release_flags to history
+ * v14	add indexes for history and hsi_history
  */
-#define FU_HISTORY_CURRENT_SCHEMA_VERSION 13
+#define FU_HISTORY_CURRENT_SCHEMA_VERSION 14
 
 static void
 fu_history_finalize(GObject *object);
@@ -47,6 +48,10 @@ struct _FuHistory {
 #ifdef HAVE_SQLITE
 	sqlite3 *db;
 	GRWLock db_mutex;
+	GThread *transaction_thread; /* (atomic), holding the writer lock */
+	guint transaction_depth;
+	GMutex stmts_mutex;
+	GHashTable *stmts; /* (element-type utf8 sqlite3_stmt) */
 #endif
 };
 
@@ -58,6 +63,88 @@ G_DEFINE_TYPE(FuHistory, fu_history, G_TYPE_OBJECT)
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(sqlite3_stmt, sqlite3_finalize);
 #pragma clang diagnostic pop
 
+/* the thread with a transaction in progress already holds the writer lock */
+typedef struct {
+	GRWLock *lock; /* nullable */
+	gboolean writer;
+} FuHistoryLocker;
+
+static FuHistoryLocker *
+fu_history_locker_new(FuHistory *self, gboolean writer)
+{
+	FuHistoryLocker *locker = g_new0(FuHistoryLocker, 1);
+	if (g_atomic_pointer_get(&self->transaction_thread) == g_thread_self())
+		return locker;
+	locker->lock = &self->db_mutex;
+	locker->writer = writer;
+	if (writer)
+		g_rw_lock_writer_lock(locker->lock);
+	else
+		g_rw_lock_reader_lock(locker->lock);
+	return locker;
+}
+
+static void
+fu_history_locker_free(FuHistoryLocker *locker)
+{
+	if (locker->lock != NULL) {
+		if (locker->writer)
+			g_rw_lock_writer_unlock(locker->lock);
+		else
+			g_rw_lock_reader_unlock(locker->lock);
+	}
+	g_free(locker);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuHistoryLocker, fu_history_locker_free)
+
+/* a prepared statement borrowed from the per-connection cache */
+typedef struct {
+	FuHistory *self;
+	sqlite3_stmt *stmt;
+} FuHistoryStmt;
+
+static FuHistoryStmt *
+fu_history_stmt_acquire(FuHistory *self, const gchar *sql)
+{
+	sqlite3_stmt *stmt = NULL;
+	FuHistoryStmt *stmt_cached;
+
+	/* statements are removed from the cache while in use, so that concurrent readers holding
+	 * the reader lock never step the same statement */
+	g_mutex_lock(&self->stmts_mutex);
+	g_hash_table_steal_extended(self->stmts, sql, NULL, (gpointer *)&stmt);
+	g_mutex_unlock(&self->stmts_mutex);
+	if (stmt == NULL) {
+		if (sqlite3_prepare_v2(self->db, sql, -1, &stmt, NULL) != SQLITE_OK)
+			return NULL;
+	}
+	stmt_cached = g_new0(FuHistoryStmt, 1);
+	stmt_cached->self = self;
+	stmt_cached->stmt = stmt;
+	return stmt_cached;
+}
+
+static void
+fu_history_stmt_release(FuHistoryStmt *stmt_cached)
+{
+	FuHistory *self = stmt_cached->self;
+	const gchar *sql = sqlite3_sql(stmt_cached->stmt);
+
+	/* make ready for the next caller, the SQL text is owned by the statement */
+	sqlite3_reset(stmt_cached->stmt);
+	sqlite3_clear_bindings(stmt_cached->stmt);
+	g_mutex_lock(&self->stmts_mutex);
+	if (!g_hash_table_contains(self->stmts, sql))
+		g_hash_table_insert(self->stmts, (gpointer)sql, stmt_cached->stmt);
+	else
+		sqlite3_finalize(stmt_cached->stmt);
+	g_mutex_unlock(&self->stmts_mutex);
+	g_free(stmt_cached);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FuHistoryStmt, fu_history_stmt_release)
+
 static FuDevice *
 fu_history_device_from_stmt(sqlite3_stmt *stmt)
 {
@@ -193,6 +280,22 @@ fu_history_stmt_exec(FuHistory *self, sqlite3_stmt *stmt, GPtrArray *array, GErr
 	return TRUE;
 }
 
+static gboolean
+fu_history_exec(FuHistory *self, const gchar *sql, GError **error)
+{
+	gint rc = sqlite3_exec(self->db, sql, NULL, NULL, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_WRITE,
+			    "failed to execute %s: %s",
+			    sql,
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 static gboolean
 fu_history_create_database(FuHistory *self, GError **error)
 {
@@ -233,6 +336,9 @@ fu_history_create_database(FuHistory *self, GError **error)
 			  "timestamp TIMESTAMP DEFAULT CURRENT_TIMESTAMP,"
 			  "hsi_details TEXT DEFAULT NULL,"
 			  "hsi_score TEXT DEFAULT NULL);"
+			  "CREATE INDEX IF NOT EXISTS idx_history_device_id ON history (device_id);"
+			  "CREATE INDEX IF NOT EXISTS idx_hsi_history_timestamp "
+			  "ON hsi_history (timestamp);"
 			  "COMMIT;",
 			  NULL,
 			  NULL,
@@ -450,6 +556,28 @@ fu_history_migrate_database_v11(FuHistory *self, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_history_migrate_database_v12(FuHistory *self, GError **error)
+{
+	gint rc;
+	rc = sqlite3_exec(self->db,
+			  "CREATE INDEX IF NOT EXISTS idx_history_device_id ON history (device_id);"
+			  "CREATE INDEX IF NOT EXISTS idx_hsi_history_timestamp "
+			  "ON hsi_history (timestamp);",
+			  NULL,
+			  NULL,
+			  NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to create indexes: %s",
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	return TRUE;
+}
+
 /* returns 0 if database is not initialized */
 static guint
 fu_history_get_schema_version(FuHistory *self)
@@ -531,6 +659,10 @@ fu_history_create_or_migrate(FuHistory *self, guint schema_ver, GError **error)
 	case 12:
 		if (!fu_history_migrate_database_v11(self, error))
 			return FALSE;
+	/* fall through */
+	case 13:
+		if (!fu_history_migrate_database_v12(self, error))
+			return FALSE;
 		/* no longer fall through */
 		break;
 	default:
@@ -572,9 +704,22 @@ fu_history_open(FuHistory *self, const gchar *filename, GError **error)
 
 	/* turn off the lookaside cache */
 	sqlite3_db_config(self->db, SQLITE_DBCONFIG_LOOKASIDE, NULL, 0, 0);
+
+	/* only one fsync per transaction rather than one for the journal and one for the
+	 * database -- synchronous=FULL is kept as the pending state has to survive a reboot */
+	rc = sqlite3_exec(self->db, "PRAGMA journal_mode=WAL;", NULL, NULL, NULL);
+	if (rc != SQLITE_OK)
+		g_debug("failed to enable WAL: %s", sqlite3_errmsg(self->db));
 	return TRUE;
 }
 
+static void
+fu_history_close(FuHistory *self)
+{
+	g_hash_table_remove_all(self->stmts);
+	g_clear_pointer(&self->db, sqlite3_close);
+}
+
 static gboolean
 fu_history_load(FuHistory *self, GError **error)
 {
@@ -583,7 +728,7 @@ fu_history_load(FuHistory *self, GError **error)
 	g_autofree gchar *dirname = NULL;
 	g_autofree gchar *filename = NULL;
 	g_autoptr(GFile) file = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	g_autoptr(FuHistoryLocker) locker = fu_history_locker_new(self, TRUE);
 
 	/* already done */
 	if (self->db != NULL)
@@ -626,10 +771,14 @@ fu_history_load(FuHistory *self, GError **error)
 		if (!fu_history_create_or_migrate(self, schema_ver, &error_migrate)) {
 			/* this is fatal to the daemon, so delete the database
 			 * and try again with something empty */
+			g_autofree gchar *filename_wal = g_strdup_printf("%s-wal", filename);
+			g_autofree gchar *filename_shm = g_strdup_printf("%s-shm", filename);
 			g_warning("failed to migrate %s database: %s",
 				  filename,
 				  error_migrate->message);
-			sqlite3_close(self->db);
+			fu_history_close(self);
+			(void)g_unlink(filename_wal);
+			(void)g_unlink(filename_shm);
 			if (g_unlink(filename) != 0) {
 				g_set_error(error,
 					    FWUPD_ERROR,
@@ -674,6 +823,121 @@ fu_history_get_device_flags_filtered(FuDevice *device)
 }
 #endif
 
+#ifdef HAVE_SQLITE
+static void
+fu_history_transaction_unlock(FuHistory *self)
+{
+	if (--self->transaction_depth > 0)
+		return;
+	g_atomic_pointer_set(&self->transaction_thread, NULL);
+	g_rw_lock_writer_unlock(&self->db_mutex);
+}
+#endif
+
+/**
+ * fu_history_begin_transaction:
+ * @self: a #FuHistory
+ * @error: (nullable): optional return location for an error
+ *
+ * Starts a transaction so that a batch of writes is only synced to disk once.
+ *
+ * The database cannot be used by any other thread until the transaction has finished.
+ * Transactions can be nested, and each successful call must be balanced by a call to either
+ * fu_history_commit_transaction() or fu_history_rollback_transaction().
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_history_begin_transaction(FuHistory *self, GError **error)
+{
+#ifdef HAVE_SQLITE
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return FALSE;
+
+	/* held until the outermost transaction is committed or rolled back */
+	if (g_atomic_pointer_get(&self->transaction_thread) != g_thread_self()) {
+		g_rw_lock_writer_lock(&self->db_mutex);
+		g_atomic_pointer_set(&self->transaction_thread, g_thread_self());
+	}
+	self->transaction_depth++;
+	if (!fu_history_exec(self, "SAVEPOINT fu_history;", error)) {
+		fu_history_transaction_unlock(self);
+		return FALSE;
+	}
+	return TRUE;
+#else
+	return TRUE;
+#endif
+}
+
+/**
+ * fu_history_commit_transaction:
+ * @self: a #FuHistory
+ * @error: (nullable): optional return location for an error
+ *
+ * Ends a transaction started with fu_history_begin_transaction(), writing the changes to disk
+ * if this is the outermost transaction.
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_history_commit_transaction(FuHistory *self, GError **error)
+{
+#ifdef HAVE_SQLITE
+	gboolean ret;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(self->transaction_thread == g_thread_self(), FALSE);
+
+	/* never leave the savepoint open if the changes could not be written */
+	ret = fu_history_exec(self, "RELEASE SAVEPOINT fu_history;", error);
+	if (!ret) {
+		(void)fu_history_exec(self,
+				      "ROLLBACK TO SAVEPOINT fu_history;"
+				      "RELEASE SAVEPOINT fu_history;",
+				      NULL);
+	}
+	fu_history_transaction_unlock(self);
+	return ret;
+#else
+	return TRUE;
+#endif
+}
+
+/**
+ * fu_history_rollback_transaction:
+ * @self: a #FuHistory
+ *
+ * Ends a transaction started with fu_history_begin_transaction(), discarding all the changes
+ * made since it was started.
+ *
+ * Since: 2.0.0
+ **/
+void
+fu_history_rollback_transaction(FuHistory *self)
+{
+#ifdef HAVE_SQLITE
+	g_autoptr(GError) error_local = NULL;
+
+	g_return_if_fail(FU_IS_HISTORY(self));
+	g_return_if_fail(self->transaction_thread == g_thread_self());
+
+	/* the savepoint is still on the stack after the rollback, and so has to be released too */
+	if (!fu_history_exec(self,
+			     "ROLLBACK TO SAVEPOINT fu_history; RELEASE SAVEPOINT fu_history;",
+			     &error_local))
+		g_warning("failed to roll back history: %s", error_local->message);
+	fu_history_transaction_unlock(self);
+#endif
+}
+
 /**
  * fu_history_modify_device:
  * @self: a #FuHistory
@@ -690,9 +954,9 @@ gboolean
 fu_history_modify_device(FuHistory *self, FuDevice *device, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -702,22 +966,19 @@ fu_history_modify_device(FuHistory *self, FuDevice *device, GError **error)
 		return FALSE;
 
 	/* overwrite entry if it exists */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("modifying device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
-	rc = sqlite3_prepare_v2(self->db,
-				"UPDATE history SET "
-				"update_state = ?1, "
-				"update_error = ?2, "
-				"checksum_device = ?6, "
-				"device_modified = ?7, "
-				"install_duration = ?8, "
-				"flags = ?3 "
-				"WHERE device_id = ?4;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "UPDATE history SET "
+					      "update_state = ?1, "
+					      "update_error = ?2, "
+					      "checksum_device = ?6, "
+					      "device_modified = ?7, "
+					      "install_duration = ?8, "
+					      "flags = ?3 "
+					      "WHERE device_id = ?4;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -725,6 +986,7 @@ fu_history_modify_device(FuHistory *self, FuDevice *device, GError **error)
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 
 	sqlite3_bind_int(stmt, 1, fu_device_get_update_state(device));
 	sqlite3_bind_text(stmt, 2, fu_device_get_update_error(device), -1, SQLITE_STATIC);
@@ -774,10 +1036,10 @@ fu_history_modify_device_release(FuHistory *self,
 				 GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
 	g_autofree gchar *metadata = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -790,22 +1052,19 @@ fu_history_modify_device_release(FuHistory *self,
 	metadata = _convert_hash_to_string(fu_release_get_metadata(release));
 
 	/* overwrite entry if it exists */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("modifying device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
-	rc = sqlite3_prepare_v2(self->db,
-				"UPDATE history SET "
-				"update_state = ?1, "
-				"update_error = ?2, "
-				"checksum_device = ?6, "
-				"device_modified = ?7, "
-				"metadata = ?8, "
-				"flags = ?3 "
-				"WHERE device_id = ?4;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "UPDATE history SET "
+					      "update_state = ?1, "
+					      "update_error = ?2, "
+					      "checksum_device = ?6, "
+					      "device_modified = ?7, "
+					      "metadata = ?8, "
+					      "flags = ?3 "
+					      "WHERE device_id = ?4;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -813,6 +1072,7 @@ fu_history_modify_device_release(FuHistory *self,
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 
 	sqlite3_bind_int(stmt, 1, fu_device_get_update_state(device));
 	sqlite3_bind_text(stmt, 2, fu_device_get_update_error(device), -1, SQLITE_STATIC);
@@ -834,37 +1094,16 @@ fu_history_modify_device_release(FuHistory *self,
 #endif
 }
 
-/**
- * fu_history_add_device:
- * @self: a #FuHistory
- * @device: a device
- * @release: a #FuRelease
- * @error: (nullable): optional return location for an error
- *
- * Adds a device to the history database
- *
- * Returns: @TRUE if successful, @FALSE for failure
- *
- * Since: 1.0.4
- **/
-gboolean
-fu_history_add_device(FuHistory *self, FuDevice *device, FuRelease *release, GError **error)
-{
 #ifdef HAVE_SQLITE
+static gboolean
+fu_history_replace_device(FuHistory *self, FuDevice *device, FuRelease *release, GError **error)
+{
 	const gchar *checksum_device;
 	const gchar *checksum = NULL;
-	gint rc;
 	g_autofree gchar *metadata = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
-
-	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
-	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
-	g_return_val_if_fail(FU_IS_RELEASE(release), FALSE);
-
-	/* lazy load */
-	if (!fu_history_load(self, error))
-		return FALSE;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	/* ensure all old device(s) with this ID are removed */
 	if (!fu_history_remove_device(self, device, error))
@@ -878,36 +1117,33 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FuRelease *release, GEr
 	metadata = _convert_hash_to_string(fu_release_get_metadata(release));
 
 	/* add */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
-	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO history (device_id,"
-				"update_state,"
-				"update_error,"
-				"flags,"
-				"filename,"
-				"checksum,"
-				"display_name,"
-				"plugin,"
-				"guid_default,"
-				"metadata,"
-				"device_created,"
-				"device_modified,"
-				"version_old,"
-				"version_new,"
-				"checksum_device,"
-				"protocol,"
-				"release_id,"
-				"appstream_id,"
-				"version_format,"
-				"install_duration,"
-				"release_flags) "
-				"VALUES (?1,?2,?3,?4,?5,?6,?7,?8,?9,?10,"
-				"?11,?12,?13,?14,?15,?16,?17,?18,?19,?20,?21)",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "INSERT INTO history (device_id,"
+					      "update_state,"
+					      "update_error,"
+					      "flags,"
+					      "filename,"
+					      "checksum,"
+					      "display_name,"
+					      "plugin,"
+					      "guid_default,"
+					      "metadata,"
+					      "device_created,"
+					      "device_modified,"
+					      "version_old,"
+					      "version_new,"
+					      "checksum_device,"
+					      "protocol,"
+					      "release_id,"
+					      "appstream_id,"
+					      "version_format,"
+					      "install_duration,"
+					      "release_flags) "
+					      "VALUES (?1,?2,?3,?4,?5,?6,?7,?8,?9,?10,"
+					      "?11,?12,?13,?14,?15,?16,?17,?18,?19,?20,?21)");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -915,6 +1151,7 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FuRelease *release, GEr
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	sqlite3_bind_text(stmt, 1, fu_device_get_id(device), -1, SQLITE_STATIC);
 	sqlite3_bind_int(stmt, 2, fu_device_get_update_state(device));
 	sqlite3_bind_text(stmt, 3, fu_device_get_update_error(device), -1, SQLITE_STATIC);
@@ -937,6 +1174,38 @@ fu_history_add_device(FuHistory *self, FuDevice *device, FuRelease *release, GEr
 	sqlite3_bind_int(stmt, 20, fu_device_get_install_duration(device));
 	sqlite3_bind_int(stmt, 21, fu_release_get_flags(release));
 	return fu_history_stmt_exec(self, stmt, NULL, error);
+}
+#endif
+
+/**
+ * fu_history_add_device:
+ * @self: a #FuHistory
+ * @device: a device
+ * @release: a #FuRelease
+ * @error: (nullable): optional return location for an error
+ *
+ * Adds a device to the history database
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 1.0.4
+ **/
+gboolean
+fu_history_add_device(FuHistory *self, FuDevice *device, FuRelease *release, GError **error)
+{
+#ifdef HAVE_SQLITE
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
+	g_return_val_if_fail(FU_IS_RELEASE(release), FALSE);
+
+	/* the delete and the insert only need to be synced once */
+	if (!fu_history_begin_transaction(self, error))
+		return FALSE;
+	if (!fu_history_replace_device(self, device, release, error)) {
+		fu_history_rollback_transaction(self);
+		return FALSE;
+	}
+	return fu_history_commit_transaction(self, error);
 #else
 	return TRUE;
 #endif
@@ -957,9 +1226,9 @@ gboolean
 fu_history_remove_all(FuHistory *self, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 
@@ -968,11 +1237,11 @@ fu_history_remove_all(FuHistory *self, GError **error)
 		return FALSE;
 
 	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("removing all devices");
-	rc = sqlite3_prepare_v2(self->db, "DELETE FROM history;", -1, &stmt, NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self, "DELETE FROM history;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -980,6 +1249,7 @@ fu_history_remove_all(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 #else
 	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
@@ -1003,9 +1273,9 @@ gboolean
 fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(FU_IS_DEVICE(device), FALSE);
@@ -1014,15 +1284,11 @@ fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error)
 	if (!fu_history_load(self, error))
 		return FALSE;
 
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
 	g_debug("remove device %s [%s]", fu_device_get_name(device), fu_device_get_id(device));
-	rc = sqlite3_prepare_v2(self->db,
-				"DELETE FROM history WHERE device_id = ?1;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self, "DELETE FROM history WHERE device_id = ?1;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1030,6 +1296,7 @@ fu_history_remove_device(FuHistory *self, FuDevice *device, GError **error)
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	sqlite3_bind_text(stmt, 1, fu_device_get_id(device), -1, SQLITE_STATIC);
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 #else
@@ -1053,10 +1320,10 @@ FuDevice *
 fu_history_get_device_by_id(FuHistory *self, const gchar *device_id, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
 	g_autoptr(GPtrArray) array_tmp = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 	g_return_val_if_fail(device_id != NULL, NULL);
@@ -1066,36 +1333,33 @@ fu_history_get_device_by_id(FuHistory *self, const gchar *device_id, GError **er
 		return NULL;
 
 	/* get all the devices */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, FALSE);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc = sqlite3_prepare_v2(self->db,
-				"SELECT device_id, "
-				"checksum, "
-				"plugin, "
-				"device_created, "
-				"device_modified, "
-				"display_name, "
-				"filename, "
-				"flags, "
-				"metadata, "
-				"guid_default, "
-				"update_state, "
-				"update_error, "
-				"version_new, "
-				"version_old, "
-				"checksum_device, "
-				"protocol, "
-				"release_id, "
-				"appstream_id, "
-				"version_format, "
-				"install_duration, "
-				"release_flags FROM history WHERE "
-				"device_id = ?1 ORDER BY device_created DESC "
-				"LIMIT 1",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "SELECT device_id, "
+					      "checksum, "
+					      "plugin, "
+					      "device_created, "
+					      "device_modified, "
+					      "display_name, "
+					      "filename, "
+					      "flags, "
+					      "metadata, "
+					      "guid_default, "
+					      "update_state, "
+					      "update_error, "
+					      "version_new, "
+					      "version_old, "
+					      "checksum_device, "
+					      "protocol, "
+					      "release_id, "
+					      "appstream_id, "
+					      "version_format, "
+					      "install_duration, "
+					      "release_flags FROM history WHERE "
+					      "device_id = ?1 ORDER BY device_created DESC "
+					      "LIMIT 1");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1103,6 +1367,7 @@ fu_history_get_device_by_id(FuHistory *self, const gchar *device_id, GError **er
 			    sqlite3_errmsg(self->db));
 		return NULL;
 	}
+	stmt = stmt_cached->stmt;
 	sqlite3_bind_text(stmt, 1, device_id, -1, SQLITE_STATIC);
 	array_tmp = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 	if (!fu_history_stmt_exec(self, stmt, array_tmp, error))
@@ -1134,9 +1399,9 @@ fu_history_get_devices(FuHistory *self, GError **error)
 {
 	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 #ifdef HAVE_SQLITE
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	gint rc;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1147,35 +1412,32 @@ fu_history_get_devices(FuHistory *self, GError **error)
 	}
 
 	/* get all the devices */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, FALSE);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc = sqlite3_prepare_v2(self->db,
-				"SELECT device_id, "
-				"checksum, "
-				"plugin, "
-				"device_created, "
-				"device_modified, "
-				"display_name, "
-				"filename, "
-				"flags, "
-				"metadata, "
-				"guid_default, "
-				"update_state, "
-				"update_error, "
-				"version_new, "
-				"version_old, "
-				"checksum_device, "
-				"protocol, "
-				"release_id, "
-				"appstream_id, "
-				"version_format, "
-				"install_duration, "
-				"release_flags FROM history "
-				"ORDER BY device_modified ASC;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "SELECT device_id, "
+					      "checksum, "
+					      "plugin, "
+					      "device_created, "
+					      "device_modified, "
+					      "display_name, "
+					      "filename, "
+					      "flags, "
+					      "metadata, "
+					      "guid_default, "
+					      "update_state, "
+					      "update_error, "
+					      "version_new, "
+					      "version_old, "
+					      "checksum_device, "
+					      "protocol, "
+					      "release_id, "
+					      "appstream_id, "
+					      "version_format, "
+					      "install_duration, "
+					      "release_flags FROM history "
+					      "ORDER BY device_modified ASC;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1183,6 +1445,7 @@ fu_history_get_devices(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return NULL;
 	}
+	stmt = stmt_cached->stmt;
 	if (!fu_history_stmt_exec(self, stmt, array, error))
 		return NULL;
 #endif
@@ -1206,8 +1469,9 @@ fu_history_get_approved_firmware(FuHistory *self, GError **error)
 	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func(g_free);
 #ifdef HAVE_SQLITE
 	gint rc;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1218,14 +1482,10 @@ fu_history_get_approved_firmware(FuHistory *self, GError **error)
 	}
 
 	/* get all the approved firmware */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, FALSE);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc = sqlite3_prepare_v2(self->db,
-				"SELECT checksum FROM approved_firmware;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self, "SELECT checksum FROM approved_firmware;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1233,6 +1493,7 @@ fu_history_get_approved_firmware(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return NULL;
 	}
+	stmt = stmt_cached->stmt;
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
 		const gchar *tmp = (const gchar *)sqlite3_column_text(stmt, 0);
 		g_ptr_array_add(array, g_strdup(tmp));
@@ -1264,9 +1525,9 @@ gboolean
 fu_history_clear_approved_firmware(FuHistory *self, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 
@@ -1275,10 +1536,10 @@ fu_history_clear_approved_firmware(FuHistory *self, GError **error)
 		return FALSE;
 
 	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
-	rc = sqlite3_prepare_v2(self->db, "DELETE FROM approved_firmware;", -1, &stmt, NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self, "DELETE FROM approved_firmware;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1286,6 +1547,7 @@ fu_history_clear_approved_firmware(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 #else
 	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
@@ -1309,9 +1571,9 @@ gboolean
 fu_history_add_approved_firmware(FuHistory *self, const gchar *checksum, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(checksum != NULL, FALSE);
@@ -1321,15 +1583,12 @@ fu_history_add_approved_firmware(FuHistory *self, const gchar *checksum, GError
 		return FALSE;
 
 	/* add */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
-	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO approved_firmware (checksum) "
-				"VALUES (?1)",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "INSERT INTO approved_firmware (checksum) "
+					      "VALUES (?1)");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1337,6 +1596,7 @@ fu_history_add_approved_firmware(FuHistory *self, const gchar *checksum, GError
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	sqlite3_bind_text(stmt, 1, checksum, -1, SQLITE_STATIC);
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 #else
@@ -1362,8 +1622,9 @@ fu_history_get_blocked_firmware(FuHistory *self, GError **error)
 	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func(g_free);
 #ifdef HAVE_SQLITE
 	gint rc;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1374,11 +1635,10 @@ fu_history_get_blocked_firmware(FuHistory *self, GError **error)
 	}
 
 	/* get all the blocked firmware */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, FALSE);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc =
-	    sqlite3_prepare_v2(self->db, "SELECT checksum FROM blocked_firmware;", -1, &stmt, NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self, "SELECT checksum FROM blocked_firmware;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1386,6 +1646,7 @@ fu_history_get_blocked_firmware(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return NULL;
 	}
+	stmt = stmt_cached->stmt;
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
 		const gchar *tmp = (const gchar *)sqlite3_column_text(stmt, 0);
 		g_ptr_array_add(array, g_strdup(tmp));
@@ -1417,9 +1678,9 @@ gboolean
 fu_history_clear_blocked_firmware(FuHistory *self, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 
@@ -1428,10 +1689,10 @@ fu_history_clear_blocked_firmware(FuHistory *self, GError **error)
 		return FALSE;
 
 	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
-	rc = sqlite3_prepare_v2(self->db, "DELETE FROM blocked_firmware;", -1, &stmt, NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self, "DELETE FROM blocked_firmware;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1439,6 +1700,7 @@ fu_history_clear_blocked_firmware(FuHistory *self, GError **error)
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 #else
 	g_set_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_SUPPORTED, "no sqlite support");
@@ -1462,9 +1724,9 @@ gboolean
 fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 	g_return_val_if_fail(checksum != NULL, FALSE);
@@ -1474,15 +1736,12 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 		return FALSE;
 
 	/* add */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
-	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO blocked_firmware (checksum) "
-				"VALUES (?1)",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "INSERT INTO blocked_firmware (checksum) "
+					      "VALUES (?1)");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1490,6 +1749,7 @@ fu_history_add_blocked_firmware(FuHistory *self, const gchar *checksum, GError *
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	sqlite3_bind_text(stmt, 1, checksum, -1, SQLITE_STATIC);
 	return fu_history_stmt_exec(self, stmt, NULL, error);
 #else
@@ -1505,24 +1765,21 @@ fu_history_add_security_attribute(FuHistory *self,
 				  GError **error)
 {
 #ifdef HAVE_SQLITE
-	gint rc;
-	g_autoptr(sqlite3_stmt) stmt = NULL;
-	g_autoptr(GRWLockWriterLocker) locker = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
 
 	/* lazy load */
 	if (!fu_history_load(self, error))
 		return FALSE;
 	/* remove entries */
-	locker = g_rw_lock_writer_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, TRUE);
 	g_return_val_if_fail(locker != NULL, FALSE);
-	rc = sqlite3_prepare_v2(self->db,
-				"INSERT INTO hsi_history (hsi_details, hsi_score)"
-				"VALUES (?1, ?2)",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "INSERT INTO hsi_history (hsi_details, hsi_score)"
+					      "VALUES (?1, ?2)");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1530,6 +1787,7 @@ fu_history_add_security_attribute(FuHistory *self,
 			    sqlite3_errmsg(self->db));
 		return FALSE;
 	}
+	stmt = stmt_cached->stmt;
 	sqlite3_bind_text(stmt, 1, security_attr_json, -1, SQLITE_STATIC);
 	sqlite3_bind_text(stmt, 2, hsi_score, -1, SQLITE_STATIC);
 	return fu_history_stmt_exec(self, stmt, NULL, error);
@@ -1545,9 +1803,12 @@ fu_history_add_security_attribute(FuHistory *self,
  * @limit: maximum number of attributes to return, or 0 for no limit
  * @error: (nullable): optional return location for an error
  *
- * Gets the security attributes in the history database.
+ * Gets the security attributes in the history database, newest first.
  * Attributes with the same stores JSON data will be deduplicated as required.
  *
+ * As the rows are read using the timestamp index, only the rows required to satisfy @limit are
+ * read from the database.
+ *
  * Returns: (element-type #FuSecurityAttrs) (transfer container): attrs
  *
  * Since: 1.7.1
@@ -1557,10 +1818,11 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 {
 	g_autoptr(GPtrArray) array = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
 #ifdef HAVE_SQLITE
-	g_autoptr(sqlite3_stmt) stmt = NULL;
+	sqlite3_stmt *stmt;
+	g_autoptr(FuHistoryStmt) stmt_cached = NULL;
 	gint rc;
 	guint old_hash = 0;
-	g_autoptr(GRWLockReaderLocker) locker = NULL;
+	g_autoptr(FuHistoryLocker) locker = NULL;
 
 	g_return_val_if_fail(FU_IS_HISTORY(self), NULL);
 
@@ -1571,15 +1833,12 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 	}
 
 	/* get all the devices */
-	locker = g_rw_lock_reader_locker_new(&self->db_mutex);
+	locker = fu_history_locker_new(self, FALSE);
 	g_return_val_if_fail(locker != NULL, NULL);
-	rc = sqlite3_prepare_v2(self->db,
-				"SELECT timestamp, hsi_details FROM hsi_history "
-				"ORDER BY timestamp DESC;",
-				-1,
-				&stmt,
-				NULL);
-	if (rc != SQLITE_OK) {
+	stmt_cached = fu_history_stmt_acquire(self,
+					      "SELECT timestamp, hsi_details FROM hsi_history "
+					      "ORDER BY timestamp DESC, rowid DESC;");
+	if (stmt_cached == NULL) {
 		g_set_error(error,
 			    FWUPD_ERROR,
 			    FWUPD_ERROR_INTERNAL,
@@ -1587,6 +1846,7 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 			    sqlite3_errmsg(self->db));
 		return NULL;
 	}
+	stmt = stmt_cached->stmt;
 	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
 		const gchar *json;
 		guint hash;
@@ -1652,6 +1912,145 @@ fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error)
 	return g_steal_pointer(&array);
 }
 
+#ifdef HAVE_SQLITE
+static gboolean
+fu_history_get_pragma_u64(FuHistory *self, const gchar *sql, guint64 *value, GError **error)
+{
+	g_autoptr(sqlite3_stmt) stmt = NULL;
+	gint rc;
+
+	rc = sqlite3_prepare_v2(self->db, sql, -1, &stmt, NULL);
+	if (rc != SQLITE_OK) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INTERNAL,
+			    "Failed to prepare SQL for %s: %s",
+			    sql,
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	if (sqlite3_step(stmt) != SQLITE_ROW) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_READ,
+			    "failed to execute %s: %s",
+			    sql,
+			    sqlite3_errmsg(self->db));
+		return FALSE;
+	}
+	*value = sqlite3_column_int64(stmt, 0);
+	return TRUE;
+}
+
+static gboolean
+fu_history_vacuum(FuHistory *self, GError **error)
+{
+	guint64 freelist_count = 0;
+	guint64 page_count = 0;
+
+	/* only rewrite the file when a significant part of it is unused */
+	if (!fu_history_get_pragma_u64(self, "PRAGMA freelist_count;", &freelist_count, error))
+		return FALSE;
+	if (!fu_history_get_pragma_u64(self, "PRAGMA page_count;", &page_count, error))
+		return FALSE;
+	if (freelist_count * 4 < page_count)
+		return TRUE;
+	g_info("vacuuming history database with %u/%u free pages",
+	       (guint)freelist_count,
+	       (guint)page_count);
+	return fu_history_exec(self, "VACUUM;", error);
+}
+#endif
+
+/**
+ * fu_history_compact_security_attrs:
+ * @self: a #FuHistory
+ * @max_age: maximum age of the attributes to keep in seconds, or 0 for no limit
+ * @max_entries: maximum number of attributes to keep, or 0 for no limit
+ * @error: (nullable): optional return location for an error
+ *
+ * Deletes old security attributes from the history database, and reclaims the disk space
+ * if required. The most recent attributes are always kept.
+ *
+ * This must not be called with a transaction in progress.
+ *
+ * Returns: @TRUE if successful, @FALSE for failure
+ *
+ * Since: 2.0.0
+ **/
+gboolean
+fu_history_compact_security_attrs(FuHistory *self,
+				  guint64 max_age,
+				  guint max_entries,
+				  GError **error)
+{
+#ifdef HAVE_SQLITE
+	guint changes = 0;
+	g_autoptr(FuHistoryLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_HISTORY(self), FALSE);
+
+	/* lazy load */
+	if (!fu_history_load(self, error))
+		return FALSE;
+
+	locker = fu_history_locker_new(self, TRUE);
+	g_return_val_if_fail(locker != NULL, FALSE);
+	if (max_age > 0) {
+		sqlite3_stmt *stmt;
+		g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+		gint64 since = g_get_real_time() / G_USEC_PER_SEC - (gint64)max_age;
+
+		stmt_cached = fu_history_stmt_acquire(
+		    self,
+		    "DELETE FROM hsi_history WHERE timestamp < datetime(?1, 'unixepoch') "
+		    "AND rowid != (SELECT rowid FROM hsi_history "
+		    "ORDER BY timestamp DESC, rowid DESC LIMIT 1);");
+		if (stmt_cached == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "Failed to prepare SQL to expire security attrs: %s",
+				    sqlite3_errmsg(self->db));
+			return FALSE;
+		}
+		stmt = stmt_cached->stmt;
+		sqlite3_bind_int64(stmt, 1, since);
+		if (!fu_history_stmt_exec(self, stmt, NULL, error))
+			return FALSE;
+		changes += sqlite3_changes(self->db);
+	}
+	if (max_entries > 0) {
+		sqlite3_stmt *stmt;
+		g_autoptr(FuHistoryStmt) stmt_cached = NULL;
+
+		stmt_cached = fu_history_stmt_acquire(
+		    self,
+		    "DELETE FROM hsi_history WHERE rowid NOT IN "
+		    "(SELECT rowid FROM hsi_history ORDER BY timestamp DESC, rowid DESC LIMIT ?1);");
+		if (stmt_cached == NULL) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INTERNAL,
+				    "Failed to prepare SQL to limit security attrs: %s",
+				    sqlite3_errmsg(self->db));
+			return FALSE;
+		}
+		stmt = stmt_cached->stmt;
+		sqlite3_bind_int64(stmt, 1, max_entries);
+		if (!fu_history_stmt_exec(self, stmt, NULL, error))
+			return FALSE;
+		changes += sqlite3_changes(self->db);
+	}
+	if (changes == 0)
+		return TRUE;
+	g_debug("deleted %u old security attrs", changes);
+	return fu_history_vacuum(self, error);
+#else
+	return TRUE;
+#endif
+}
+
 static void
 fu_history_class_init(FuHistoryClass *klass)
 {
@@ -1664,6 +2063,11 @@ fu_history_init(FuHistory *self)
 {
 #ifdef HAVE_SQLITE
 	g_rw_lock_init(&self->db_mutex);
+	g_mutex_init(&self->stmts_mutex);
+	self->stmts = g_hash_table_new_full(g_str_hash,
+					    g_str_equal,
+					    NULL,
+					    (GDestroyNotify)sqlite3_finalize);
 #endif
 }
 
@@ -1673,10 +2077,10 @@ fu_history_finalize(GObject *object)
 #ifdef HAVE_SQLITE
 	FuHistory *self = FU_HISTORY(object);
 
+	fu_history_close(self);
+	g_hash_table_unref(self->stmts);
+	g_mutex_clear(&self->stmts_mutex);
 	g_rw_lock_clear(&self->db_mutex);
-
-	if (self->db != NULL)
-		sqlite3_close(self->db);
 #endif
 
 	G_OBJECT_CLASS(fu_history_parent_class)->finalize(object);
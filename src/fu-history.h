@@ -16,6 +16,13 @@ G_DECLARE_FINAL_TYPE(FuHistory, fu_history, FU, HISTORY, GObject)
 FuHistory *
 fu_history_new(void);
 
+gboolean
+fu_history_begin_transaction(FuHistory *self, GError **error) G_GNUC_NON_NULL(1);
+gboolean
+fu_history_commit_transaction(FuHistory *self, GError **error) G_GNUC_NON_NULL(1);
+void
+fu_history_rollback_transaction(FuHistory *self) G_GNUC_NON_NULL(1);
+
 gboolean
 fu_history_add_device(FuHistory *self, FuDevice *device, FuRelease *release, GError **error)
     G_GNUC_NON_NULL(1, 2, 3);
@@ -57,3 +64,8 @@ fu_history_add_security_attribute(FuHistory *self,
 				  GError **error) G_GNUC_NON_NULL(1, 2, 3);
 GPtrArray *
 fu_history_get_security_attrs(FuHistory *self, guint limit, GError **error) G_GNUC_NON_NULL(1);
+gboolean
+fu_history_compact_security_attrs(FuHistory *self,
+				  guint64 max_age,
+				  guint max_entries,
+				  GError **error) G_GNUC_NON_NULL(1);
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuMetrics"
+
+#include "config.h"
+
+#include "fu-metrics.h"
+
+/* upper bound of each histogram bucket in microseconds, with a final overflow bucket */
+static const guint64 fu_metrics_buckets[] = {100, 1000, 10000, 100000, 1000000, 10000000};
+
+#define FU_METRICS_BUCKETS (G_N_ELEMENTS(fu_metrics_buckets) + 1)
+
+typedef struct {
+	gchar *kind;
+	gchar *name;
+	guint64 count;
+	guint64 total; /* us */
+	guint64 max;   /* us */
+	guint64 buckets[FU_METRICS_BUCKETS];
+} FuMetricsItem;
+
+struct _FuMetrics {
+	GObject parent_instance;
+	GMutex mutex;
+	GHashTable *items; /* (element-type utf8 FuMetricsItem) */
+};
+
+G_DEFINE_TYPE(FuMetrics, fu_metrics, G_TYPE_OBJECT)
+
+static void
+fu_metrics_item_free(FuMetricsItem *item)
+{
+	g_free(item->kind);
+	g_free(item->name);
+	g_free(item);
+}
+
+/* safe to call from any thread, where duration is in microseconds */
+void
+fu_metrics_add(FuMetrics *self, const gchar *kind, const gchar *name, gint64 duration)
+{
+	FuMetricsItem *item;
+	guint64 duration_us = MAX(duration, 0);
+	guint idx = FU_METRICS_BUCKETS - 1;
+	g_autofree gchar *key = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_METRICS(self));
+
+	key = g_strdup_printf("%s:%s", kind, name);
+	locker = g_mutex_locker_new(&self->mutex);
+	item = g_hash_table_lookup(self->items, key);
+	if (item == NULL) {
+		item = g_new0(FuMetricsItem, 1);
+		item->kind = g_strdup(kind);
+		item->name = g_strdup(name);
+		g_hash_table_insert(self->items, g_steal_pointer(&key), item);
+	}
+	for (guint i = 0; i < G_N_ELEMENTS(fu_metrics_buckets); i++) {
+		if (duration_us <= fu_metrics_buckets[i]) {
+			idx = i;
+			break;
+		}
+	}
+	item->buckets[idx]++;
+	item->count++;
+	item->total += duration_us;
+	item->max = MAX(item->max, duration_us);
+}
+
+/* returns the total duration in microseconds, or 0 if never recorded */
+guint64
+fu_metrics_get_total(FuMetrics *self, const gchar *kind, const gchar *name)
+{
+	FuMetricsItem *item;
+	g_autofree gchar *key = NULL;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_METRICS(self), 0);
+
+	key = g_strdup_printf("%s:%s", kind, name);
+	locker = g_mutex_locker_new(&self->mutex);
+	item = g_hash_table_lookup(self->items, key);
+	if (item == NULL)
+		return 0;
+	return item->total;
+}
+
+static gint
+fu_metrics_item_sort_cb(gconstpointer a, gconstpointer b)
+{
+	const FuMetricsItem *item1 = *((FuMetricsItem **)a);
+	const FuMetricsItem *item2 = *((FuMetricsItem **)b);
+	gint rc = g_strcmp0(item1->kind, item2->kind);
+	if (rc != 0)
+		return rc;
+	return g_strcmp0(item1->name, item2->name);
+}
+
+GVariant *
+fu_metrics_to_variant(FuMetrics *self)
+{
+	GVariantBuilder builder;
+	g_autoptr(GList) items = NULL;
+	g_autoptr(GPtrArray) array = g_ptr_array_new();
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_METRICS(self), NULL);
+
+	locker = g_mutex_locker_new(&self->mutex);
+	items = g_hash_table_get_values(self->items);
+	for (GList *l = items; l != NULL; l = l->next)
+		g_ptr_array_add(array, l->data);
+	g_ptr_array_sort(array, fu_metrics_item_sort_cb);
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	for (guint i = 0; i < array->len; i++) {
+		FuMetricsItem *item = g_ptr_array_index(array, i);
+		GVariantBuilder builder_kv;
+		GVariantBuilder builder_bounds;
+
+		g_variant_builder_init(&builder_bounds, G_VARIANT_TYPE("at"));
+		for (guint j = 0; j < G_N_ELEMENTS(fu_metrics_buckets); j++)
+			g_variant_builder_add(&builder_bounds, "t", fu_metrics_buckets[j]);
+		g_variant_builder_init(&builder_kv, G_VARIANT_TYPE_VARDICT);
+		g_variant_builder_add(&builder_kv,
+				      "{sv}",
+				      "Kind",
+				      g_variant_new_string(item->kind));
+		g_variant_builder_add(&builder_kv,
+				      "{sv}",
+				      "Name",
+				      g_variant_new_string(item->name));
+		g_variant_builder_add(&builder_kv,
+				      "{sv}",
+				      "Count",
+				      g_variant_new_uint64(item->count));
+		g_variant_builder_add(&builder_kv,
+				      "{sv}",
+				      "Total",
+				      g_variant_new_uint64(item->total));
+		g_variant_builder_add(&builder_kv, "{sv}", "Max", g_variant_new_uint64(item->max));
+		g_variant_builder_add(&builder_kv,
+				      "{sv}",
+				      "BucketBounds",
+				      g_variant_builder_end(&builder_bounds));
+		g_variant_builder_add(&builder_kv,
+				      "{sv}",
+				      "Buckets",
+				      g_variant_new_fixed_array(G_VARIANT_TYPE_UINT64,
+								item->buckets,
+								FU_METRICS_BUCKETS,
+								sizeof(guint64)));
+		g_variant_builder_add_value(&builder, g_variant_builder_end(&builder_kv));
+	}
+	return g_variant_new("(aa{sv})", &builder);
+}
+
+static void
+fu_metrics_init(FuMetrics *self)
+{
+	g_mutex_init(&self->mutex);
+	self->items = g_hash_table_new_full(g_str_hash,
+					    g_str_equal,
+					    g_free,
+					    (GDestroyNotify)fu_metrics_item_free);
+}
+
+static void
+fu_metrics_finalize(GObject *obj)
+{
+	FuMetrics *self = FU_METRICS(obj);
+	g_mutex_clear(&self->mutex);
+	g_hash_table_unref(self->items);
+	G_OBJECT_CLASS(fu_metrics_parent_class)->finalize(obj);
+}
+
+static void
+fu_metrics_class_init(FuMetricsClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_metrics_finalize;
+}
+
+FuMetrics *
+fu_metrics_new(void)
+{
+	return FU_METRICS(g_object_new(FU_TYPE_METRICS, NULL));
+}
@@ -0,0 +1,23 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+
+#define FU_TYPE_METRICS (fu_metrics_get_type())
+G_DECLARE_FINAL_TYPE(FuMetrics, fu_metrics, FU, METRICS, GObject)
+
+FuMetrics *
+fu_metrics_new(void);
+void
+fu_metrics_add(FuMetrics *self, const gchar *kind, const gchar *name, gint64 duration)
+    G_GNUC_NON_NULL(1, 2, 3);
+guint64
+fu_metrics_get_total(FuMetrics *self, const gchar *kind, const gchar *name)
+    G_GNUC_NON_NULL(1, 2, 3);
+GVariant *
+fu_metrics_to_variant(FuMetrics *self) G_GNUC_NON_NULL(1);
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define G_LOG_DOMAIN "FuProfiler"
+
+#include "config.h"
+
+#ifdef HAVE_MALLOC_H
+#include <malloc.h>
+#endif
+#include <time.h>
+
+#include "fwupd-common-private.h"
+
+#include "fu-profiler.h"
+
+typedef struct {
+	gchar *category;
+	gchar *name;
+	guint64 tid;
+	gint64 start;	 /* us, since the profiler was created */
+	gint64 duration; /* us, or -1 if not ended */
+	gint64 cpu;	 /* us, of the thread that began the span, or -1 if unknown */
+	gint64 heap;	 /* bytes, of the whole process, or 0 if unknown */
+} FuProfilerSpan;
+
+struct _FuProfiler {
+	GObject parent_instance;
+	GMutex mutex;
+	gint64 created;	  /* us */
+	GPtrArray *spans; /* (element-type FuProfilerSpan) */
+	gboolean stopped;
+};
+
+G_DEFINE_TYPE(FuProfiler, fu_profiler, G_TYPE_OBJECT)
+
+static void
+fu_profiler_span_free(FuProfilerSpan *span)
+{
+	g_free(span->category);
+	g_free(span->name);
+	g_free(span);
+}
+
+/* in microseconds, or -1 if unsupported on this platform */
+static gint64
+fu_profiler_get_thread_cpu_time(void)
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+	struct timespec ts = {0};
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+		return -1;
+	return ((gint64)ts.tv_sec * G_USEC_PER_SEC) + (ts.tv_nsec / 1000);
+#else
+	return -1;
+#endif
+}
+
+/* in bytes, or 0 if unsupported on this platform */
+static gint64
+fu_profiler_get_heap_size(void)
+{
+#ifdef HAVE_MALLINFO2
+	struct mallinfo2 mi = mallinfo2();
+	return (gint64)mi.uordblks;
+#else
+	return 0;
+#endif
+}
+
+static guint64
+fu_profiler_get_thread_id(void)
+{
+	return (guint64)(guintptr)g_thread_self();
+}
+
+/**
+ * fu_profiler_begin:
+ * @self: a #FuProfiler
+ * @category: a category, e.g. `plugin`
+ * @name: a name, e.g. `dell:coldplug`
+ *
+ * Starts a span, which must be ended in the same thread using fu_profiler_end().
+ *
+ * This is safe to call from any thread.
+ *
+ * Returns: a span ID, or 0 if the profiler has been stopped
+ **/
+guint
+fu_profiler_begin(FuProfiler *self, const gchar *category, const gchar *name)
+{
+	FuProfilerSpan *span;
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_val_if_fail(FU_IS_PROFILER(self), 0);
+
+	locker = g_mutex_locker_new(&self->mutex);
+	if (self->stopped)
+		return 0;
+	span = g_new0(FuProfilerSpan, 1);
+	span->category = g_strdup(category);
+	span->name = g_strdup(name);
+	span->tid = fu_profiler_get_thread_id();
+	span->duration = -1;
+	span->cpu = fu_profiler_get_thread_cpu_time();
+	span->heap = fu_profiler_get_heap_size();
+	span->start = g_get_monotonic_time() - self->created;
+	g_ptr_array_add(self->spans, span);
+	return self->spans->len;
+}
+
+/**
+ * fu_profiler_end:
+ * @self: a #FuProfiler
+ * @span: a span ID returned from fu_profiler_begin()
+ *
+ * Ends a span. Ending the span with ID 0 does nothing.
+ *
+ * This is safe to call from any thread.
+ **/
+void
+fu_profiler_end(FuProfiler *self, guint span)
+{
+	FuProfilerSpan *item;
+	gint64 now = g_get_monotonic_time();
+	gint64 cpu = fu_profiler_get_thread_cpu_time();
+	gint64 heap = fu_profiler_get_heap_size();
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_PROFILER(self));
+
+	if (span == 0)
+		return;
+	locker = g_mutex_locker_new(&self->mutex);
+	g_return_if_fail(span <= self->spans->len);
+	item = g_ptr_array_index(self->spans, span - 1);
+	item->duration = now - self->created - item->start;
+	item->cpu = item->cpu >= 0 && cpu >= 0 ? cpu - item->cpu : -1;
+	item->heap = heap - item->heap;
+}
+
+/**
+ * fu_profiler_stop:
+ * @self: a #FuProfiler
+ *
+ * Stops recording any new spans, typically when startup has completed.
+ **/
+void
+fu_profiler_stop(FuProfiler *self)
+{
+	g_autoptr(GMutexLocker) locker = NULL;
+	g_return_if_fail(FU_IS_PROFILER(self));
+	locker = g_mutex_locker_new(&self->mutex);
+	self->stopped = TRUE;
+}
+
+/**
+ * fu_profiler_add_json:
+ * @self: a #FuProfiler
+ * @builder: a #JsonBuilder
+ *
+ * Adds each ended span to an array, with all times in microseconds.
+ **/
+void
+fu_profiler_add_json(FuProfiler *self, JsonBuilder *builder)
+{
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_PROFILER(self));
+	g_return_if_fail(JSON_IS_BUILDER(builder));
+
+	locker = g_mutex_locker_new(&self->mutex);
+	json_builder_set_member_name(builder, "Spans");
+	json_builder_begin_array(builder);
+	for (guint i = 0; i < self->spans->len; i++) {
+		FuProfilerSpan *span = g_ptr_array_index(self->spans, i);
+		if (span->duration < 0)
+			continue;
+		json_builder_begin_object(builder);
+		fwupd_common_json_add_string(builder, "Category", span->category);
+		fwupd_common_json_add_string(builder, "Name", span->name);
+		fwupd_common_json_add_int(builder, "ThreadId", span->tid);
+		fwupd_common_json_add_int(builder, "Start", span->start);
+		fwupd_common_json_add_int(builder, "Duration", span->duration);
+		if (span->cpu >= 0)
+			fwupd_common_json_add_int(builder, "Cpu", span->cpu);
+		if (span->heap != 0) {
+			json_builder_set_member_name(builder, "HeapDelta");
+			json_builder_add_int_value(builder, span->heap);
+		}
+		json_builder_end_object(builder);
+	}
+	json_builder_end_array(builder);
+}
+
+/**
+ * fu_profiler_add_trace_event_json:
+ * @self: a #FuProfiler
+ * @builder: a #JsonBuilder
+ *
+ * Adds each ended span as a complete event in the Chrome trace-event format, which can be
+ * loaded into chrome://tracing or https://ui.perfetto.dev/ to show a timeline.
+ **/
+void
+fu_profiler_add_trace_event_json(FuProfiler *self, JsonBuilder *builder)
+{
+	g_autoptr(GMutexLocker) locker = NULL;
+
+	g_return_if_fail(FU_IS_PROFILER(self));
+	g_return_if_fail(JSON_IS_BUILDER(builder));
+
+	locker = g_mutex_locker_new(&self->mutex);
+	json_builder_set_member_name(builder, "traceEvents");
+	json_builder_begin_array(builder);
+	for (guint i = 0; i < self->spans->len; i++) {
+		FuProfilerSpan *span = g_ptr_array_index(self->spans, i);
+		if (span->duration < 0)
+			continue;
+		json_builder_begin_object(builder);
+		fwupd_common_json_add_string(builder, "name", span->name);
+		fwupd_common_json_add_string(builder, "cat", span->category);
+		fwupd_common_json_add_string(builder, "ph", "X");
+		fwupd_common_json_add_int(builder, "ts", span->start);
+		fwupd_common_json_add_int(builder, "dur", span->duration);
+		fwupd_common_json_add_int(builder, "pid", 1);
+		fwupd_common_json_add_int(builder, "tid", span->tid);
+		json_builder_set_member_name(builder, "args");
+		json_builder_begin_object(builder);
+		if (span->cpu >= 0)
+			fwupd_common_json_add_int(builder, "cpu_us", span->cpu);
+		if (span->heap != 0) {
+			json_builder_set_member_name(builder, "heap_delta");
+			json_builder_add_int_value(builder, span->heap);
+		}
+		json_builder_end_object(builder);
+		json_builder_end_object(builder);
+	}
+	json_builder_end_array(builder);
+	fwupd_common_json_add_string(builder, "displayTimeUnit", "ms");
+}
+
+/**
+ * fu_profiler_to_string:
+ * @self: a #FuProfiler
+ * @format: (nullable): either `json` or `trace-event`, defaulting to `json`
+ * @error: (nullable): optional return location for an error
+ *
+ * Exports all the ended spans.
+ *
+ * Returns: a JSON string, or %NULL on error
+ **/
+gchar *
+fu_profiler_to_string(FuProfiler *self, const gchar *format, GError **error)
+{
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+	g_autoptr(JsonGenerator) json_generator = NULL;
+	g_autoptr(JsonNode) json_root = NULL;
+
+	g_return_val_if_fail(FU_IS_PROFILER(self), NULL);
+	g_return_val_if_fail(error == NULL || *error == NULL, NULL);
+
+	json_builder_begin_object(builder);
+	if (format == NULL || g_strcmp0(format, "json") == 0) {
+		fu_profiler_add_json(self, builder);
+	} else if (g_strcmp0(format, "trace-event") == 0) {
+		fu_profiler_add_trace_event_json(self, builder);
+	} else {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_ARGS,
+			    "format %s not supported, expected 'json' or 'trace-event'",
+			    format);
+		return NULL;
+	}
+	json_builder_end_object(builder);
+
+	json_root = json_builder_get_root(builder);
+	json_generator = json_generator_new();
+	json_generator_set_pretty(json_generator, TRUE);
+	json_generator_set_root(json_generator, json_root);
+	return json_generator_to_data(json_generator, NULL);
+}
+
+static void
+fu_profiler_init(FuProfiler *self)
+{
+	g_mutex_init(&self->mutex);
+	self->created = g_get_monotonic_time();
+	self->spans = g_ptr_array_new_with_free_func((GDestroyNotify)fu_profiler_span_free);
+}
+
+static void
+fu_profiler_finalize(GObject *obj)
+{
+	FuProfiler *self = FU_PROFILER(obj);
+	g_mutex_clear(&self->mutex);
+	g_ptr_array_unref(self->spans);
+	G_OBJECT_CLASS(fu_profiler_parent_class)->finalize(obj);
+}
+
+static void
+fu_profiler_class_init(FuProfilerClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS(klass);
+	object_class->finalize = fu_profiler_finalize;
+}
+
+FuProfiler *
+fu_profiler_new(void)
+{
+	return FU_PROFILER(g_object_new(FU_TYPE_PROFILER, NULL));
+}
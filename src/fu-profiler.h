@@ -0,0 +1,29 @@
+/*
+ * Copyright 2024 Richard Hughes <richard@hughsie.com>
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#pragma once
+
+#include <fwupdplugin.h>
+#include <json-glib/json-glib.h>
+
+#define FU_TYPE_PROFILER (fu_profiler_get_type())
+G_DECLARE_FINAL_TYPE(FuProfiler, fu_profiler, FU, PROFILER, GObject)
+
+FuProfiler *
+fu_profiler_new(void);
+guint
+fu_profiler_begin(FuProfiler *self, const gchar *category, const gchar *name)
+    G_GNUC_NON_NULL(1, 2, 3);
+void
+fu_profiler_end(FuProfiler *self, guint span) G_GNUC_NON_NULL(1);
+void
+fu_profiler_stop(FuProfiler *self) G_GNUC_NON_NULL(1);
+void
+fu_profiler_add_json(FuProfiler *self, JsonBuilder *builder) G_GNUC_NON_NULL(1, 2);
+void
+fu_profiler_add_trace_event_json(FuProfiler *self, JsonBuilder *builder) G_GNUC_NON_NULL(1, 2);
+gchar *
+fu_profiler_to_string(FuProfiler *self, const gchar *format, GError **error) G_GNUC_NON_NULL(1);
@@ -32,12 +32,15 @@
 #include "fu-engine.h"
 #include "fu-history.h"
 #include "fu-idle.h"
+#include "fu-metrics.h"
 #include "fu-plugin-list.h"
 #include "fu-plugin-private.h"
+#include "fu-profiler.h"
 #include "fu-release-common.h"
 #include "fu-remote-list.h"
 #include "fu-remote.h"
 #include "fu-security-attr-common.h"
+#include "fu-security-attrs-private.h"
 #include "fu-smbios-private.h"
 #include "fu-spawn.h"
 #include "fu-usb-backend.h"
@@ -225,6 +228,103 @@ fu_idle_func(void)
 	g_assert_false(fu_idle_has_inhibit(idle, FU_IDLE_INHIBIT_SIGNALS));
 }
 
+static void
+fu_metrics_func(void)
+{
+	guint64 count = 0;
+	guint64 max = 0;
+	guint64 total = 0;
+	const gchar *name = NULL;
+	g_autoptr(FuMetrics) metrics = fu_metrics_new();
+	g_autoptr(GVariant) array = NULL;
+	g_autoptr(GVariant) buckets = NULL;
+	g_autoptr(GVariant) item = NULL;
+	g_autoptr(GVariant) val = NULL;
+	const guint64 *buckets_data;
+	gsize buckets_len = 0;
+
+	fu_metrics_add(metrics, "dbus", "GetDevices", 50);
+	fu_metrics_add(metrics, "dbus", "GetDevices", 5000);
+	fu_metrics_add(metrics, "plugin", "dell:coldplug", 20000000);
+	fu_metrics_add(metrics, "dbus", "GetDevices", -1);
+
+	val = g_variant_ref_sink(fu_metrics_to_variant(metrics));
+	array = g_variant_get_child_value(val, 0);
+	g_assert_cmpint(g_variant_n_children(array), ==, 2);
+
+	/* sorted by kind then name */
+	item = g_variant_get_child_value(array, 0);
+	g_assert_true(g_variant_lookup(item, "Name", "&s", &name));
+	g_assert_cmpstr(name, ==, "GetDevices");
+	g_assert_true(g_variant_lookup(item, "Count", "t", &count));
+	g_assert_cmpint(count, ==, 3);
+	g_assert_true(g_variant_lookup(item, "Total", "t", &total));
+	g_assert_cmpint(total, ==, 5050);
+	g_assert_true(g_variant_lookup(item, "Max", "t", &max));
+	g_assert_cmpint(max, ==, 5000);
+	buckets = g_variant_lookup_value(item, "Buckets", G_VARIANT_TYPE("at"));
+	g_assert_nonnull(buckets);
+	buckets_data = g_variant_get_fixed_array(buckets, &buckets_len, sizeof(guint64));
+	g_assert_cmpint(buckets_len, ==, 7);
+	g_assert_cmpint(buckets_data[0], ==, 2);
+	g_assert_cmpint(buckets_data[2], ==, 1);
+
+	/* direct lookup */
+	g_assert_cmpint(fu_metrics_get_total(metrics, "dbus", "GetDevices"), ==, 5050);
+	g_assert_cmpint(fu_metrics_get_total(metrics, "dbus", "Install"), ==, 0);
+}
+
+static void
+fu_profiler_func(void)
+{
+	JsonArray *json_spans;
+	JsonObject *json_obj;
+	JsonObject *json_span;
+	guint span1;
+	guint span2;
+	g_autofree gchar *str = NULL;
+	g_autoptr(FuProfiler) profiler = fu_profiler_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	/* nested spans, with one never ended */
+	span1 = fu_profiler_begin(profiler, "engine", "load:plugins");
+	span2 = fu_profiler_begin(profiler, "plugin", "dell:coldplug");
+	fu_profiler_end(profiler, span2);
+	fu_profiler_end(profiler, span1);
+	(void)fu_profiler_begin(profiler, "plugin", "uefi:coldplug");
+
+	/* nothing is recorded after stopping */
+	fu_profiler_stop(profiler);
+	g_assert_cmpint(fu_profiler_begin(profiler, "plugin", "dell:ready"), ==, 0);
+	fu_profiler_end(profiler, 0);
+
+	str = fu_profiler_to_string(profiler, NULL, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(str);
+	g_assert_true(json_parser_load_from_data(parser, str, -1, &error));
+	g_assert_no_error(error);
+	json_obj = json_node_get_object(json_parser_get_root(parser));
+	json_spans = json_object_get_array_member(json_obj, "Spans");
+	g_assert_cmpint(json_array_get_length(json_spans), ==, 2);
+	json_span = json_array_get_object_element(json_spans, 1);
+	g_assert_cmpstr(json_object_get_string_member(json_span, "Category"), ==, "plugin");
+	g_assert_cmpstr(json_object_get_string_member(json_span, "Name"), ==, "dell:coldplug");
+	g_assert_cmpint(json_object_get_int_member(json_span, "Duration"), >=, 0);
+
+	/* chrome trace-event */
+	g_free(str);
+	str = fu_profiler_to_string(profiler, "trace-event", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(strstr(str, "traceEvents"));
+
+	/* unknown */
+	g_free(str);
+	str = fu_profiler_to_string(profiler, "xml", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_INVALID_ARGS);
+	g_assert_null(str);
+}
+
 static void
 fu_engine_generate_md_func(gconstpointer user_data)
 {
@@ -1794,6 +1894,112 @@ fu_engine_device_md_set_flags_func(gconstpointer user_data)
 	    fu_device_has_internal_flag(device, FU_DEVICE_INTERNAL_FLAG_SAVE_INTO_BACKUP_REMOTE));
 }
 
+static void
+fu_engine_plugin_manifest_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autoptr(FuBackend) backend =
+	    g_object_new(FU_TYPE_BACKEND, "name", "usb", "context", self->ctx, NULL);
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device_tmp = NULL;
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuPlugin) plugin_cpu = fu_plugin_new(self->ctx);
+	g_autoptr(FuPlugin) plugin_nocpu = fu_plugin_new(self->ctx);
+	g_autoptr(FuPlugin) plugin_udev = fu_plugin_new(self->ctx);
+	g_autoptr(FuPlugin) plugin_usb = fu_plugin_new(self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+
+	/* any one of the values can match */
+	fu_plugin_set_name(plugin_cpu, "cpu_match");
+	fu_plugin_add_rule(plugin_cpu, FU_PLUGIN_RULE_REQUIRES_CPU, "acme");
+	fu_plugin_add_rule(plugin_cpu,
+			   FU_PLUGIN_RULE_REQUIRES_CPU,
+			   fu_cpu_vendor_to_string(fu_cpu_get_vendor()));
+	fu_engine_add_plugin(engine, plugin_cpu);
+	fu_plugin_set_name(plugin_nocpu, "cpu_mismatch");
+	fu_plugin_add_rule(plugin_nocpu, FU_PLUGIN_RULE_REQUIRES_CPU, "acme");
+	fu_engine_add_plugin(engine, plugin_nocpu);
+
+	/* only started when a USB device is added */
+	fu_plugin_set_name(plugin_usb, "usb_only");
+	fu_plugin_add_rule(plugin_usb, FU_PLUGIN_RULE_DEVICE_BACKEND, "usb");
+	fu_engine_add_plugin(engine, plugin_usb);
+	fu_plugin_set_name(plugin_udev, "udev_only");
+	fu_plugin_add_rule(plugin_udev, FU_PLUGIN_RULE_DEVICE_BACKEND, "udev");
+	fu_engine_add_plugin(engine, plugin_udev);
+	fu_engine_add_backend(engine, backend);
+
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_NO_CACHE, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_false(fu_plugin_has_flag(plugin_cpu, FWUPD_PLUGIN_FLAG_DISABLED));
+	g_assert_true(fu_plugin_has_flag(plugin_nocpu, FWUPD_PLUGIN_FLAG_DISABLED));
+	g_assert_true(fu_plugin_has_flag(plugin_nocpu, FWUPD_PLUGIN_FLAG_NO_HARDWARE));
+
+	/* deferred, but not reported as disabled */
+	g_assert_false(fu_plugin_has_flag(plugin_usb, FWUPD_PLUGIN_FLAG_DISABLED));
+	g_assert_false(fu_plugin_has_flag(plugin_usb, FWUPD_PLUGIN_FLAG_NO_HARDWARE));
+	g_assert_false(fu_plugin_has_flag(plugin_usb, FWUPD_PLUGIN_FLAG_READY));
+
+	/* a USB device starts only the plugin that handles the USB backend */
+	fu_device_set_id(device, "usb-only-device");
+	fu_device_add_guid(device, "2d47f29b-83a2-4f31-a2e8-63474f4d4c2e");
+	fu_device_add_possible_plugin(device, "usb_only");
+	fu_device_add_possible_plugin(device, "udev_only");
+	fu_device_set_specialized_gtype(device, FU_TYPE_DEVICE);
+	fu_backend_device_added(backend, device);
+	g_assert_false(fu_plugin_has_flag(plugin_usb, FWUPD_PLUGIN_FLAG_DISABLED));
+	g_assert_false(fu_plugin_has_flag(plugin_usb, FWUPD_PLUGIN_FLAG_NO_HARDWARE));
+	g_assert_true(fu_plugin_has_flag(plugin_usb, FWUPD_PLUGIN_FLAG_READY));
+	g_assert_false(fu_plugin_has_flag(plugin_udev, FWUPD_PLUGIN_FLAG_DISABLED));
+	g_assert_false(fu_plugin_has_flag(plugin_udev, FWUPD_PLUGIN_FLAG_READY));
+
+	/* the started plugin created the device */
+	device_tmp = fu_engine_get_device(engine, fu_device_get_id(device), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(device_tmp);
+	g_assert_cmpstr(fu_device_get_plugin(device_tmp), ==, "usb_only");
+}
+
+static void
+fu_engine_metadata_prune_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	const gchar *fn_legacy = "/tmp/fwupd-self-test/var/cache/fwupd/metadata.xmlb";
+	const gchar *fn_local = "/tmp/fwupd-self-test/var/cache/fwupd/local.xmlb";
+	const gchar *fn_local_legacy = "/tmp/fwupd-self-test/var/cache/fwupd/metadata/local.xmlb";
+	const gchar *fn_stale = "/tmp/fwupd-self-test/var/cache/fwupd/metadata/removed.xmlb";
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+
+	/* silos from an older version, and one from a remote that was removed */
+	fu_self_test_mkroot();
+	ret = fu_path_mkdir_parent(fn_stale, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn_legacy, "xmlb", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn_local_legacy, "xmlb", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = g_file_set_contents(fn_stale, "xmlb", -1, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	ret = fu_engine_load(engine, FU_ENGINE_LOAD_FLAG_REMOTES, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_true(g_file_test(fn_local, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(fn_legacy, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(fn_local_legacy, G_FILE_TEST_EXISTS));
+	g_assert_false(g_file_test(fn_stale, G_FILE_TEST_EXISTS));
+}
+
 static void
 fu_engine_require_hwid_func(gconstpointer user_data)
 {
@@ -2345,6 +2551,101 @@ fu_engine_install_duration_func(gconstpointer user_data)
 	g_assert_cmpint(fwupd_release_get_install_duration(rel), ==, 120);
 }
 
+static void
+fu_engine_release_failures_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+	g_autoptr(FuEngine) engine = fu_engine_new(self->ctx);
+	g_autoptr(FuEngineRequest) request = fu_engine_request_new();
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) releases = NULL;
+	g_autoptr(GPtrArray) releases2 = NULL;
+	g_autoptr(XbNode) component = NULL;
+	g_autoptr(XbSilo) silo_empty = xb_silo_new();
+
+	/* ensure empty tree */
+	fu_self_test_mkroot();
+
+	/* no metadata in daemon */
+	fu_engine_set_silo(engine, silo_empty);
+
+	/* write the main file */
+	ret = g_file_set_contents(
+	    "/tmp/fwupd-self-test/stable.xml",
+	    "<components>"
+	    "  <component type=\"firmware\">"
+	    "    <id>test</id>"
+	    "    <provides>"
+	    "      <firmware type=\"flashed\">aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee</firmware>"
+	    "    </provides>"
+	    "    <requires>"
+	    "      <firmware compare=\"ge\" version=\"1.2.3\"/>"
+	    "    </requires>"
+	    "    <releases>"
+	    "      <release version=\"1.2.4\" date=\"2017-09-15\">"
+	    "        <location>https://test.org/foo.cab</location>"
+	    "        <checksum filename=\"foo.cab\" target=\"container\" "
+	    "type=\"md5\">deadbeefdeadbeefdeadbeefdeadbeef</checksum>"
+	    "        <checksum filename=\"firmware.bin\" target=\"content\" "
+	    "type=\"md5\">deadbeefdeadbeefdeadbeefdeadbeef</checksum>"
+	    "      </release>"
+	    "    </releases>"
+	    "  </component>"
+	    "</components>",
+	    -1,
+	    &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	ret = fu_engine_load(engine,
+			     FU_ENGINE_LOAD_FLAG_REMOTES | FU_ENGINE_LOAD_FLAG_NO_CACHE,
+			     progress,
+			     &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+
+	/* the version is too old for the requirement */
+	fu_device_set_version_format(device, FWUPD_VERSION_FORMAT_TRIPLET);
+	fu_device_set_version(device, "1.2.2");
+	fu_device_set_id(device, "test_device");
+	fu_device_add_vendor_id(device, "USB:FFFF");
+	fu_device_add_protocol(device, "com.acme");
+	fu_device_add_guid(device, "11111111-2222-3333-4444-555555555555");
+	fu_device_add_guid(device, "aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee");
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UPDATABLE);
+	fu_device_add_flag(device, FWUPD_DEVICE_FLAG_UNSIGNED_PAYLOAD);
+	fu_engine_add_device(engine, device);
+
+	/* found using the index, even though the first GUID does not match */
+	component = fu_engine_get_component_by_guids(engine, device);
+	g_assert_nonnull(component);
+	g_assert_cmpstr(xb_node_query_text(component, "id", NULL), ==, "test");
+
+	/* the requirement fails */
+	releases = fu_engine_get_releases(engine, request, fu_device_get_id(device), &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO);
+	g_assert_null(releases);
+	g_clear_error(&error);
+
+	/* the version does not emit a device change, so the cached failure is used and the
+	 * release is not loaded again -- even though it would now pass */
+	fu_device_set_version(device, "1.2.3");
+	releases = fu_engine_get_releases(engine, request, fu_device_get_id(device), &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOTHING_TO_DO);
+	g_assert_null(releases);
+	g_clear_error(&error);
+
+	/* any device change means the requirements have to be checked again */
+	fu_device_set_update_message(device, "Unplug the device");
+	releases2 = fu_engine_get_releases(engine, request, fu_device_get_id(device), &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(releases2);
+	g_assert_cmpint(releases2->len, ==, 1);
+}
+
 static void
 fu_engine_release_dedupe_func(gconstpointer user_data)
 {
@@ -3301,6 +3602,130 @@ fu_device_list_no_auto_remove_children_func(gconstpointer user_data)
 	g_assert_cmpint(active3->len, ==, 0);
 }
 
+static void
+fu_device_list_index_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	g_autoptr(FuDevice) device1 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device2 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) device3 = fu_device_new(self->ctx);
+	g_autoptr(FuDevice) donor = fu_device_new(self->ctx);
+	g_autoptr(FuDeviceList) device_list = fu_device_list_new();
+	g_autoptr(FuDevice) device_tmp1 = NULL;
+	g_autoptr(FuDevice) device_tmp2 = NULL;
+	g_autoptr(FuDevice) device_tmp3 = NULL;
+	g_autoptr(FuDevice) device_tmp4 = NULL;
+	g_autoptr(FuDevice) device_tmp5 = NULL;
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) active = NULL;
+
+	fu_device_set_id(device1, "device1");
+	fu_device_add_counterpart_guid(device1, "foo");
+	fu_device_set_physical_id(device1, "usb:01:00");
+	fu_device_list_add(device_list, device1);
+	fu_device_set_id(device2, "device2");
+	fu_device_add_counterpart_guid(device2, "foo");
+	fu_device_list_add(device_list, device2);
+
+	/* the first-added device wins */
+	device_tmp1 = fu_device_list_get_by_guid(device_list, "foo", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(device_tmp1);
+	g_assert_true(device_tmp1 == device1);
+
+	/* GUID added after the device was added to the list */
+	fu_device_add_counterpart_guid(device2, "bar");
+	device_tmp2 = fu_device_list_get_by_guid(device_list, "bar", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(device_tmp2);
+	g_assert_true(device_tmp2 == device2);
+
+	/* GUID added by incorporating another device */
+	fu_device_add_counterpart_guid(donor, "baz");
+	fu_device_incorporate(device2, donor);
+	device_tmp5 = fu_device_list_get_by_guid(device_list, "baz", &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(device_tmp5);
+	g_assert_true(device_tmp5 == device2);
+
+	/* GUID of a removed device */
+	fu_device_list_remove(device_list, device2);
+	device_tmp3 = fu_device_list_get_by_guid(device_list, "bar", &error);
+	g_assert_error(error, FWUPD_ERROR, FWUPD_ERROR_NOT_FOUND);
+	g_assert_null(device_tmp3);
+	g_clear_error(&error);
+
+	/* physical ID changed after the device was added, so the new device replaces it */
+	fu_device_set_remove_delay(device1, 100);
+	fu_device_set_physical_id(device1, "usb:01:01");
+	fu_device_list_remove(device_list, device1);
+	fu_device_set_id(device3, "device3");
+	fu_device_set_physical_id(device3, "usb:01:01");
+	fu_device_list_add(device_list, device3);
+	active = fu_device_list_get_active(device_list);
+	g_assert_cmpint(active->len, ==, 1);
+	device_tmp4 = fu_device_list_get_old(device_list, device3);
+	g_assert_true(device_tmp4 == device1);
+}
+
+static void
+fu_device_list_performance_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	g_autoptr(FuDeviceList) device_list = fu_device_list_new();
+	g_autoptr(GPtrArray) devices = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_autoptr(GTimer) timer = g_timer_new();
+
+	/* enumerate lots of synthetic devices, each with a few GUIDs */
+	for (guint i = 0; i < 2000; i++) {
+		g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+		g_autofree gchar *device_id = g_strdup_printf("device%04u", i);
+		g_autofree gchar *physical_id = g_strdup_printf("usb:%02x:%02x", i / 0x100, i % 0x100);
+		fu_device_set_id(device, device_id);
+		fu_device_set_physical_id(device, physical_id);
+		for (guint j = 0; j < 5; j++) {
+			g_autofree gchar *instance_id =
+			    g_strdup_printf("USB\\VID_%04X&PID_%04X&REV_%04X", i, j, i + j);
+			fu_device_add_counterpart_guid(device, instance_id);
+		}
+		g_ptr_array_add(devices, g_steal_pointer(&device));
+	}
+	g_timer_reset(timer);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		fu_device_list_add(device_list, device);
+	}
+	g_print("add=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* look up the last GUID of every device */
+	g_timer_reset(timer);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		GPtrArray *guids = fu_device_get_guids(device);
+		g_autoptr(FuDevice) device_tmp = NULL;
+		g_autoptr(GError) error = NULL;
+		device_tmp = fu_device_list_get_by_guid(device_list,
+							g_ptr_array_index(guids, guids->len - 1),
+							&error);
+		g_assert_no_error(error);
+		g_assert_true(device_tmp == device);
+	}
+	g_print("lookup=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	/* change event for every device */
+	g_timer_reset(timer);
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		fu_device_list_add(device_list, device);
+	}
+	g_print("change=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device = g_ptr_array_index(devices, i);
+		fu_device_list_remove(device_list, device);
+	}
+}
+
 static void
 fu_device_list_delay_func(gconstpointer user_data)
 {
@@ -4097,6 +4522,73 @@ fu_backend_usb_func(gconstpointer user_data)
 #endif
 }
 
+#ifdef HAVE_GUSB
+static gboolean
+fu_backend_usb_transfer_chunks_cb(FuUsbDevice *device,
+				  FuChunk *chk,
+				  gpointer user_data,
+				  GError **error)
+{
+	GString *str = (GString *)user_data;
+	g_string_append_len(str,
+			    (const gchar *)fu_chunk_get_data(chk),
+			    (gssize)fu_chunk_get_data_sz(chk));
+	return TRUE;
+}
+#endif
+
+static void
+fu_backend_usb_transfer_chunks_func(gconstpointer user_data)
+{
+#ifdef HAVE_GUSB
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	FuDevice *device_tmp;
+	g_autofree gchar *gusb_emulate_fn = NULL;
+	g_autoptr(FuBackend) backend = fu_usb_backend_new(self->ctx);
+	g_autoptr(FuChunkArray) chunks = NULL;
+	g_autoptr(FuProgress) progress = fu_progress_new(G_STRLOC);
+	g_autoptr(GBytes) blob = g_bytes_new_static("hello world!", 12);
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GString) str = g_string_new(NULL);
+
+	/* load the JSON into the backend */
+	ret = fu_backend_setup(backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	gusb_emulate_fn =
+	    g_test_build_filename(G_TEST_DIST, "tests", "usb-devices-transfer.json", NULL);
+	fu_backend_usb_load_file(backend, gusb_emulate_fn);
+	ret = fu_backend_coldplug(backend, progress, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	devices = fu_backend_get_devices(backend);
+	g_assert_cmpint(devices->len, ==, 1);
+	device_tmp = g_ptr_array_index(devices, 0);
+	g_assert_true(fu_device_has_flag(device_tmp, FWUPD_DEVICE_FLAG_EMULATED));
+
+	/* the emulation replays each chunk in order even when asking for a deep queue */
+	fu_progress_reset(progress);
+	chunks = fu_chunk_array_new_from_bytes(blob, 0x0, 4);
+	ret = fu_usb_device_bulk_transfer_chunks(FU_USB_DEVICE(device_tmp),
+						 0x01,
+						 chunks,
+						 4,
+						 1000,
+						 fu_backend_usb_transfer_chunks_cb,
+						 str,
+						 progress,
+						 &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_assert_cmpstr(str->str, ==, "hello world!");
+	g_assert_cmpint(fu_progress_get_percentage(progress), ==, 100);
+#else
+	g_test_skip("No GUsb support");
+#endif
+}
+
 static void
 fu_backend_usb_invalid_func(gconstpointer user_data)
 {
@@ -4451,6 +4943,211 @@ fu_history_func(gconstpointer user_data)
 	g_assert_cmpstr(g_ptr_array_index(approved_firmware, 1), ==, "bar");
 }
 
+static void
+fu_history_security_attrs_func(gconstpointer user_data)
+{
+	gboolean ret;
+	g_autofree gchar *dirname = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	g_autofree gchar *filename = g_build_filename(dirname, "pending.db", NULL);
+	g_autoptr(FuHistory) history = NULL;
+	g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) attrs_all = NULL;
+	g_autoptr(GPtrArray) attrs_compact = NULL;
+	g_autoptr(GPtrArray) attrs_limit = NULL;
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* start with an empty database */
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	(void)g_unlink(filename);
+	history = fu_history_new();
+
+	/* add a different set of attrs each time */
+	for (guint i = 0; i < 5; i++) {
+		g_autofree gchar *appstream_id = g_strdup_printf("org.fwupd.hsi.self-test%u", i);
+		g_autofree gchar *json = NULL;
+		g_autoptr(FwupdSecurityAttr) attr = fwupd_security_attr_new(appstream_id);
+		fu_security_attrs_append(attrs, attr);
+		json = fu_security_attrs_to_json_string(attrs, &error);
+		g_assert_no_error(error);
+		g_assert_nonnull(json);
+		ret = fu_history_add_security_attribute(history, json, "HSI:0", &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+
+	/* all, newest first */
+	attrs_all = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_all);
+	g_assert_cmpint(attrs_all->len, ==, 5);
+
+	/* limited */
+	attrs_limit = fu_history_get_security_attrs(history, 2, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_limit);
+	g_assert_cmpint(attrs_limit->len, ==, 2);
+	g_assert_true(fu_security_attrs_equal(g_ptr_array_index(attrs_limit, 0), attrs));
+
+	/* nothing is old enough to expire, but only keep the newest three */
+	ret = fu_history_compact_security_attrs(history, 24 * 60 * 60, 3, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	attrs_compact = fu_history_get_security_attrs(history, 0, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_compact);
+	g_assert_cmpint(attrs_compact->len, ==, 3);
+	g_assert_true(fu_security_attrs_equal(g_ptr_array_index(attrs_compact, 0), attrs));
+}
+
+static void
+fu_history_transaction_func(gconstpointer user_data)
+{
+	gboolean ret;
+	g_autofree gchar *dirname = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autoptr(FuHistory) history = fu_history_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) checksums = NULL;
+	g_autoptr(GPtrArray) checksums2 = NULL;
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* start with an empty database */
+	dirname = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	filename = g_build_filename(dirname, "pending.db", NULL);
+	(void)g_unlink(filename);
+
+	/* changes are discarded when rolled back, including a nested transaction */
+	ret = fu_history_begin_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_add_blocked_firmware(history, "foo", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_begin_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_add_blocked_firmware(history, "bar", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_commit_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	fu_history_rollback_transaction(history);
+	checksums = fu_history_get_blocked_firmware(history, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(checksums);
+	g_assert_cmpint(checksums->len, ==, 0);
+
+	/* and written when committed */
+	ret = fu_history_begin_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_add_blocked_firmware(history, "baz", &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	ret = fu_history_commit_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	checksums2 = fu_history_get_blocked_firmware(history, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(checksums2);
+	g_assert_cmpint(checksums2->len, ==, 1);
+	g_assert_cmpstr(g_ptr_array_index(checksums2, 0), ==, "baz");
+}
+
+static void
+fu_history_performance_func(gconstpointer user_data)
+{
+	FuTest *self = (FuTest *)user_data;
+	gboolean ret;
+	g_autofree gchar *dirname = fu_path_from_kind(FU_PATH_KIND_LOCALSTATEDIR_PKG);
+	g_autofree gchar *filename = g_build_filename(dirname, "pending.db", NULL);
+	g_autofree gchar *json = NULL;
+	g_autoptr(FuHistory) history = NULL;
+	g_autoptr(FuRelease) release = fu_release_new();
+	g_autoptr(FuSecurityAttrs) attrs = fu_security_attrs_new();
+	g_autoptr(GError) error = NULL;
+	g_autoptr(GPtrArray) attrs_array = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GTimer) timer = g_timer_new();
+
+#ifndef HAVE_SQLITE
+	g_test_skip("no sqlite support");
+	return;
+#endif
+
+	/* start with an empty database */
+	if (!g_file_test(dirname, G_FILE_TEST_IS_DIR))
+		return;
+	(void)g_unlink(filename);
+	history = fu_history_new();
+	fu_release_set_filename(release, "/var/lib/dave.cap");
+	fu_release_set_version(release, "3.0.2");
+
+	/* add lots of devices, as done when installing a large composite update */
+	g_timer_reset(timer);
+	ret = fu_history_begin_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	for (guint i = 0; i < 10000; i++) {
+		g_autoptr(FuDevice) device = fu_device_new(self->ctx);
+		g_autofree gchar *device_id = g_strdup_printf("device%05u", i);
+		fu_device_set_id(device, device_id);
+		fu_device_set_name(device, "ColorHug");
+		fu_device_set_version(device, "3.0.1");
+		fu_device_set_update_state(device, FWUPD_UPDATE_STATE_PENDING);
+		ret = fu_history_add_device(history, device, release, &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+	ret = fu_history_commit_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("history=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	devices = fu_history_get_devices(history, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(devices);
+	g_assert_cmpint(devices->len, ==, 10000);
+
+	/* add lots of HSI results, as done once per boot */
+	json = fu_security_attrs_to_json_string(attrs, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(json);
+	g_timer_reset(timer);
+	ret = fu_history_begin_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	for (guint i = 0; i < 10000; i++) {
+		ret = fu_history_add_security_attribute(history, json, "HSI:0", &error);
+		g_assert_no_error(error);
+		g_assert_true(ret);
+	}
+	ret = fu_history_commit_transaction(history, &error);
+	g_assert_no_error(error);
+	g_assert_true(ret);
+	g_print("hsi_history=%.3fms ", g_timer_elapsed(timer, NULL) * 1000.f);
+	attrs_array = fu_history_get_security_attrs(history, 1, &error);
+	g_assert_no_error(error);
+	g_assert_nonnull(attrs_array);
+	g_assert_cmpint(attrs_array->len, ==, 1);
+
+	/* do not leave this for the other tests */
+	g_clear_object(&history);
+	(void)g_unlink(filename);
+}
+
 static GBytes *
 _build_cab(gboolean compressed, ...)
 {
@@ -6440,6 +7137,8 @@ main(int argc, char **argv)
 		g_test_add_data_func("/fwupd/console", self, fu_console_func);
 	}
 	g_test_add_func("/fwupd/idle", fu_idle_func);
+	g_test_add_func("/fwupd/metrics", fu_metrics_func);
+	g_test_add_func("/fwupd/profiler", fu_profiler_func);
 	g_test_add_func("/fwupd/client-list", fu_client_list_func);
 	g_test_add_func("/fwupd/remote{download}", fu_remote_download_func);
 	g_test_add_func("/fwupd/remote{no-path}", fu_remote_nopath_func);
@@ -6450,12 +7149,16 @@ main(int argc, char **argv)
 	g_test_add_func("/fwupd/unix-seekable-input-stream", fu_unix_seekable_input_stream_func);
 	g_test_add_data_func("/fwupd/backend{usb}", self, fu_backend_usb_func);
 	g_test_add_data_func("/fwupd/backend{usb-invalid}", self, fu_backend_usb_invalid_func);
+	g_test_add_data_func("/fwupd/backend{usb-transfer-chunks}",
+			     self,
+			     fu_backend_usb_transfer_chunks_func);
 	g_test_add_data_func("/fwupd/plugin{module}", self, fu_plugin_module_func);
 	g_test_add_data_func("/fwupd/memcpy", self, fu_memcpy_func);
 	g_test_add_func("/fwupd/cabinet", fu_common_cabinet_func);
 	g_test_add_data_func("/fwupd/security-attr", self, fu_security_attr_func);
 	g_test_add_data_func("/fwupd/device-list", self, fu_device_list_func);
 	g_test_add_data_func("/fwupd/device-list{delay}", self, fu_device_list_delay_func);
+	g_test_add_data_func("/fwupd/device-list{index}", self, fu_device_list_index_func);
 	g_test_add_data_func("/fwupd/device-list{explicit-order}",
 			     self,
 			     fu_device_list_explicit_order_func);
@@ -6507,11 +7210,20 @@ main(int argc, char **argv)
 		g_test_add_data_func("/fwupd/device-list{replug-auto}",
 				     self,
 				     fu_device_list_replug_auto_func);
+		g_test_add_data_func("/fwupd/device-list{performance}",
+				     self,
+				     fu_device_list_performance_func);
 	}
 	g_test_add_data_func("/fwupd/device-list{replug-user}",
 			     self,
 			     fu_device_list_replug_user_func);
 	g_test_add_data_func("/fwupd/engine{require-hwid}", self, fu_engine_require_hwid_func);
+	g_test_add_data_func("/fwupd/engine{metadata-prune}",
+			     self,
+			     fu_engine_metadata_prune_func);
+	g_test_add_data_func("/fwupd/engine{plugin-manifest}",
+			     self,
+			     fu_engine_plugin_manifest_func);
 	g_test_add_data_func("/fwupd/engine{requires-reboot}",
 			     self,
 			     fu_engine_install_needs_reboot);
@@ -6585,6 +7297,9 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/engine{install-duration}",
 			     self,
 			     fu_engine_install_duration_func);
+	g_test_add_data_func("/fwupd/engine{release-failures}",
+			     self,
+			     fu_engine_release_failures_func);
 	g_test_add_data_func("/fwupd/engine{release-dedupe}", self, fu_engine_release_dedupe_func);
 	g_test_add_data_func("/fwupd/engine{generate-md}", self, fu_engine_generate_md_func);
 	g_test_add_data_func("/fwupd/engine{requirements-other-device}",
@@ -6597,6 +7312,13 @@ main(int argc, char **argv)
 	g_test_add_data_func("/fwupd/history", self, fu_history_func);
 	g_test_add_data_func("/fwupd/history{migrate-v1}", self, fu_history_migrate_v1_func);
 	g_test_add_data_func("/fwupd/history{migrate-v2}", self, fu_history_migrate_v2_func);
+	g_test_add_data_func("/fwupd/history{security-attrs}", self, fu_history_security_attrs_func);
+	g_test_add_data_func("/fwupd/history{transaction}", self, fu_history_transaction_func);
+	if (g_test_slow()) {
+		g_test_add_data_func("/fwupd/history{performance}",
+				     self,
+				     fu_history_performance_func);
+	}
 	g_test_add_data_func("/fwupd/plugin-list", self, fu_plugin_list_func);
 	g_test_add_data_func("/fwupd/plugin-list{depsolve}", self, fu_plugin_list_depsolve_func);
 	if (g_test_slow()) {
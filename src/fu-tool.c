@@ -19,7 +19,14 @@
 #include <jcat.h>
 #include <locale.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#ifdef HAVE_MALLOC_H
+#include <malloc.h>
+#endif
+#ifdef HAVE_RESOURCE_H
+#include <sys/resource.h>
+#endif
 
 #include "fwupd-bios-setting-private.h"
 #include "fwupd-client-private.h"
@@ -1275,15 +1282,90 @@ fu_util_download_if_required(FuUtilPrivate *priv, const gchar *perhapsfn, GError
 	return g_steal_pointer(&filename);
 }
 
+/* returns the releases in @cabinet that are suitable for @devices_possible, sorted by priority */
+static GPtrArray *
+fu_util_install_get_releases(FuUtilPrivate *priv,
+			     FuCabinet *cabinet,
+			     GPtrArray *devices_possible,
+			     GError **error)
+{
+	g_autoptr(GPtrArray) components = NULL;
+	g_autoptr(GPtrArray) errors = NULL;
+	g_autoptr(GPtrArray) releases = NULL;
+
+	components = fu_cabinet_get_components(cabinet, error);
+	if (components == NULL)
+		return NULL;
+
+	/* for each component in the silo */
+	errors = g_ptr_array_new_with_free_func((GDestroyNotify)g_error_free);
+	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	for (guint i = 0; i < components->len; i++) {
+		XbNode *component = g_ptr_array_index(components, i);
+
+		/* do any devices pass the requirements */
+		for (guint j = 0; j < devices_possible->len; j++) {
+			FuDevice *device = g_ptr_array_index(devices_possible, j);
+			g_autoptr(FuRelease) release = fu_release_new();
+			g_autoptr(GError) error_local = NULL;
+
+			/* is this component valid for the device */
+			fu_release_set_device(release, device);
+			fu_release_set_request(release, priv->request);
+			if (!fu_release_load(release,
+					     cabinet,
+					     component,
+					     NULL,
+					     priv->flags,
+					     &error_local)) {
+				g_debug("loading release failed on %s:%s failed: %s",
+					fu_device_get_id(device),
+					xb_node_query_text(component, "id", NULL),
+					error_local->message);
+				g_ptr_array_add(errors, g_steal_pointer(&error_local));
+				continue;
+			}
+			if (!fu_engine_requirements_check(priv->engine,
+							  release,
+							  priv->flags,
+							  &error_local)) {
+				g_debug("requirement on %s:%s failed: %s",
+					fu_device_get_id(device),
+					xb_node_query_text(component, "id", NULL),
+					error_local->message);
+				g_ptr_array_add(errors, g_steal_pointer(&error_local));
+				continue;
+			}
+
+			/* if component should have an update message from CAB */
+			fu_device_incorporate_from_component(device, component);
+
+			/* success */
+			g_ptr_array_add(releases, g_steal_pointer(&release));
+		}
+	}
+
+	/* order the install tasks by the device priority */
+	g_ptr_array_sort(releases, fu_util_release_sort_cb);
+
+	/* nothing suitable */
+	if (releases->len == 0) {
+		GError *error_tmp = fu_engine_error_array_get_best(errors);
+		g_propagate_error(error, error_tmp);
+		return NULL;
+	}
+
+	/* success */
+	return g_steal_pointer(&releases);
+}
+
 static gboolean
 fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 {
 	g_autofree gchar *filename = NULL;
 	g_autoptr(FuCabinet) cabinet = NULL;
 	g_autoptr(GInputStream) stream = NULL;
-	g_autoptr(GPtrArray) components = NULL;
 	g_autoptr(GPtrArray) devices_possible = NULL;
-	g_autoptr(GPtrArray) errors = NULL;
 	g_autoptr(GPtrArray) releases = NULL;
 
 	/* progress */
@@ -1344,67 +1426,11 @@ fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 	cabinet = fu_engine_build_cabinet_from_stream(priv->engine, stream, error);
 	if (cabinet == NULL)
 		return FALSE;
-	components = fu_cabinet_get_components(cabinet, error);
-	if (components == NULL)
-		return FALSE;
 
-	/* for each component in the silo */
-	errors = g_ptr_array_new_with_free_func((GDestroyNotify)g_error_free);
-	releases = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
-	for (guint i = 0; i < components->len; i++) {
-		XbNode *component = g_ptr_array_index(components, i);
-
-		/* do any devices pass the requirements */
-		for (guint j = 0; j < devices_possible->len; j++) {
-			FuDevice *device = g_ptr_array_index(devices_possible, j);
-			g_autoptr(FuRelease) release = fu_release_new();
-			g_autoptr(GError) error_local = NULL;
-
-			/* is this component valid for the device */
-			fu_release_set_device(release, device);
-			fu_release_set_request(release, priv->request);
-			if (!fu_release_load(release,
-					     cabinet,
-					     component,
-					     NULL,
-					     priv->flags,
-					     &error_local)) {
-				g_debug("loading release failed on %s:%s failed: %s",
-					fu_device_get_id(device),
-					xb_node_query_text(component, "id", NULL),
-					error_local->message);
-				g_ptr_array_add(errors, g_steal_pointer(&error_local));
-				continue;
-			}
-			if (!fu_engine_requirements_check(priv->engine,
-							  release,
-							  priv->flags,
-							  &error_local)) {
-				g_debug("requirement on %s:%s failed: %s",
-					fu_device_get_id(device),
-					xb_node_query_text(component, "id", NULL),
-					error_local->message);
-				g_ptr_array_add(errors, g_steal_pointer(&error_local));
-				continue;
-			}
-
-			/* if component should have an update message from CAB */
-			fu_device_incorporate_from_component(device, component);
-
-			/* success */
-			g_ptr_array_add(releases, g_steal_pointer(&release));
-		}
-	}
-
-	/* order the install tasks by the device priority */
-	g_ptr_array_sort(releases, fu_util_release_sort_cb);
-
-	/* nothing suitable */
-	if (releases->len == 0) {
-		GError *error_tmp = fu_engine_error_array_get_best(errors);
-		g_propagate_error(error, error_tmp);
+	/* find the releases that can be installed */
+	releases = fu_util_install_get_releases(priv, cabinet, devices_possible, error);
+	if (releases == NULL)
 		return FALSE;
-	}
 
 	priv->current_operation = FU_UTIL_OPERATION_INSTALL;
 	g_signal_connect(FU_ENGINE(priv->engine),
@@ -1435,6 +1461,325 @@ fu_util_install(FuUtilPrivate *priv, gchar **values, GError **error)
 	return fu_util_prompt_complete(priv->console, priv->completion_flags, TRUE, error);
 }
 
+/* count the USB transfers that are replayed by the install, i.e. in every phase except setup */
+static gboolean
+fu_util_emulation_benchmark_count_cb(FuArchive *archive,
+				     const gchar *filename,
+				     GBytes *bytes,
+				     gpointer user_data,
+				     GError **error)
+{
+	guint *transfers = (guint *)user_data;
+	JsonArray *json_devices;
+	JsonNode *json_root;
+	JsonObject *json_obj;
+	g_autoptr(JsonParser) parser = json_parser_new();
+
+	if (g_strcmp0(filename, "setup.json") == 0)
+		return TRUE;
+	if (!json_parser_load_from_data(parser,
+					g_bytes_get_data(bytes, NULL),
+					g_bytes_get_size(bytes),
+					error)) {
+		g_prefix_error(error, "failed to parse %s: ", filename);
+		return FALSE;
+	}
+	json_root = json_parser_get_root(parser);
+	if (json_root == NULL || !JSON_NODE_HOLDS_OBJECT(json_root)) {
+		g_set_error(error,
+			    FWUPD_ERROR,
+			    FWUPD_ERROR_INVALID_FILE,
+			    "%s invalid as not an object",
+			    filename);
+		return FALSE;
+	}
+	json_obj = json_node_get_object(json_root);
+	if (!json_object_has_member(json_obj, "UsbDevices"))
+		return TRUE;
+	json_devices = json_object_get_array_member(json_obj, "UsbDevices");
+	for (guint i = 0; i < json_array_get_length(json_devices); i++) {
+		JsonObject *json_device = json_array_get_object_element(json_devices, i);
+		JsonArray *json_events;
+
+		if (!json_object_has_member(json_device, "UsbEvents"))
+			continue;
+		json_events = json_object_get_array_member(json_device, "UsbEvents");
+		for (guint j = 0; j < json_array_get_length(json_events); j++) {
+			JsonObject *json_event = json_array_get_object_element(json_events, j);
+			const gchar *id;
+
+			id = json_object_get_string_member_with_default(json_event, "Id", NULL);
+			if (id == NULL)
+				continue;
+			if (g_str_has_prefix(id, "BulkTransfer:") ||
+			    g_str_has_prefix(id, "InterruptTransfer:") ||
+			    g_str_has_prefix(id, "ControlTransfer:"))
+				(*transfers)++;
+		}
+	}
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_util_emulation_benchmark_step(FuUtilPrivate *priv,
+				 JsonObject *json_obj,
+				 JsonBuilder *builder,
+				 GError **error)
+{
+	FuDevice *device = NULL;
+	FuMetrics *metrics = fu_engine_get_metrics(priv->engine);
+	const gchar *emulation_url;
+	const gchar *url;
+	gdouble elapsed;
+	gdouble write_elapsed;
+	guint64 write_total;
+	guint transfers = 0;
+	gsize bytes = 0;
+	g_autofree gchar *emulation_filename = NULL;
+	g_autofree gchar *filename = NULL;
+	g_autofree gchar *metric_name = NULL;
+	g_autoptr(FuArchive) archive = NULL;
+	g_autoptr(FuCabinet) cabinet = NULL;
+	g_autoptr(GBytes) emulation_data = NULL;
+	g_autoptr(GInputStream) stream = NULL;
+	g_autoptr(GPtrArray) devices = NULL;
+	g_autoptr(GPtrArray) devices_possible = NULL;
+	g_autoptr(GPtrArray) releases = NULL;
+	g_autoptr(GTimer) timer = NULL;
+#ifdef HAVE_RESOURCE_H
+	struct rusage usage1 = {0};
+	struct rusage usage2 = {0};
+#endif
+#ifdef HAVE_MALLINFO2
+	struct mallinfo2 mi1;
+	struct mallinfo2 mi2;
+#endif
+
+	/* download both files if required */
+	url = json_object_get_string_member(json_obj, "url");
+	emulation_url = json_object_get_string_member(json_obj, "emulation-url");
+	json_builder_set_member_name(builder, "Url");
+	json_builder_add_string_value(builder, url);
+	filename = fu_util_download_if_required(priv, url, error);
+	if (filename == NULL) {
+		g_prefix_error(error, "failed to download %s: ", url);
+		return FALSE;
+	}
+	emulation_filename = fu_util_download_if_required(priv, emulation_url, error);
+	if (emulation_filename == NULL) {
+		g_prefix_error(error, "failed to download %s: ", emulation_url);
+		return FALSE;
+	}
+	emulation_data = fu_bytes_get_contents(emulation_filename, error);
+	if (emulation_data == NULL)
+		return FALSE;
+	archive = fu_archive_new(emulation_data, FU_ARCHIVE_FLAG_NONE, error);
+	if (archive == NULL)
+		return FALSE;
+	if (!fu_archive_iterate(archive, fu_util_emulation_benchmark_count_cb, &transfers, error))
+		return FALSE;
+
+	/* replay the setup phase */
+	if (!fu_engine_emulation_load(priv->engine, emulation_data, error)) {
+		g_prefix_error(error,
+			       "failed to load emulation, perhaps use "
+			       "'fwupdtool modify-config fwupd AllowEmulation true': ");
+		return FALSE;
+	}
+	devices = fu_engine_get_devices(priv->engine, error);
+	if (devices == NULL)
+		return FALSE;
+	for (guint i = 0; i < devices->len; i++) {
+		FuDevice *device_tmp = g_ptr_array_index(devices, i);
+		if (fu_device_has_flag(device_tmp, FWUPD_DEVICE_FLAG_EMULATED) &&
+		    fu_device_has_flag(device_tmp, FWUPD_DEVICE_FLAG_UPDATABLE)) {
+			device = device_tmp;
+			break;
+		}
+	}
+	if (device == NULL) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_NOT_FOUND,
+				    "no emulated device was added");
+		return FALSE;
+	}
+	json_builder_set_member_name(builder, "Plugin");
+	json_builder_add_string_value(builder, fu_device_get_plugin(device));
+	json_builder_set_member_name(builder, "Device");
+	json_builder_add_string_value(builder, fu_device_get_name(device));
+
+	/* parse the archive outside of the measured section */
+	stream = fu_input_stream_from_path(filename, error);
+	if (stream == NULL)
+		return FALSE;
+	cabinet = fu_engine_build_cabinet_from_stream(priv->engine, stream, error);
+	if (cabinet == NULL)
+		return FALSE;
+	devices_possible = g_ptr_array_new_with_free_func((GDestroyNotify)g_object_unref);
+	g_ptr_array_add(devices_possible, g_object_ref(device));
+	releases = fu_util_install_get_releases(priv, cabinet, devices_possible, error);
+	if (releases == NULL)
+		return FALSE;
+
+	/* the payload size that is actually handed to the plugin */
+	for (guint i = 0; i < releases->len; i++) {
+		FuRelease *release = g_ptr_array_index(releases, i);
+		gsize bufsz = 0;
+		if (!fu_input_stream_size(fu_release_get_stream(release), &bufsz, error))
+			return FALSE;
+		bytes += bufsz;
+	}
+
+	/* install, and measure */
+	metric_name = g_strdup_printf("%s:write-firmware", fu_device_get_plugin(device));
+	write_total = fu_metrics_get_total(metrics, "plugin", metric_name);
+	fu_progress_reset(priv->progress);
+#ifdef HAVE_RESOURCE_H
+	getrusage(RUSAGE_SELF, &usage1);
+#endif
+#ifdef HAVE_MALLINFO2
+	mi1 = mallinfo2();
+#endif
+	timer = g_timer_new();
+	if (!fu_engine_install_releases(priv->engine,
+					priv->request,
+					releases,
+					cabinet,
+					priv->progress,
+					priv->flags,
+					error))
+		return FALSE;
+	elapsed = g_timer_elapsed(timer, NULL);
+#ifdef HAVE_MALLINFO2
+	mi2 = mallinfo2();
+#endif
+#ifdef HAVE_RESOURCE_H
+	getrusage(RUSAGE_SELF, &usage2);
+#endif
+	write_elapsed =
+	    (fu_metrics_get_total(metrics, "plugin", metric_name) - write_total) / 1000000.f;
+
+	/* results */
+	json_builder_set_member_name(builder, "ElapsedMs");
+	json_builder_add_double_value(builder, elapsed * 1000.f);
+	json_builder_set_member_name(builder, "WriteMs");
+	json_builder_add_double_value(builder, write_elapsed * 1000.f);
+	json_builder_set_member_name(builder, "Bytes");
+	json_builder_add_int_value(builder, bytes);
+	json_builder_set_member_name(builder, "BytesPerSecond");
+	json_builder_add_double_value(builder, write_elapsed > 0 ? bytes / write_elapsed : 0);
+	json_builder_set_member_name(builder, "Transfers");
+	json_builder_add_int_value(builder, transfers);
+	json_builder_set_member_name(builder, "PacketsPerSecond");
+	json_builder_add_double_value(builder, elapsed > 0 ? transfers / elapsed : 0);
+#ifdef HAVE_RESOURCE_H
+	json_builder_set_member_name(builder, "CpuUserMs");
+	json_builder_add_double_value(
+	    builder,
+	    (usage2.ru_utime.tv_sec - usage1.ru_utime.tv_sec) * 1000.f +
+		(usage2.ru_utime.tv_usec - usage1.ru_utime.tv_usec) / 1000.f);
+	json_builder_set_member_name(builder, "CpuSystemMs");
+	json_builder_add_double_value(
+	    builder,
+	    (usage2.ru_stime.tv_sec - usage1.ru_stime.tv_sec) * 1000.f +
+		(usage2.ru_stime.tv_usec - usage1.ru_stime.tv_usec) / 1000.f);
+	json_builder_set_member_name(builder, "MaxRssKb");
+	json_builder_add_int_value(builder, usage2.ru_maxrss);
+#endif
+#ifdef HAVE_MALLINFO2
+	json_builder_set_member_name(builder, "HeapDelta");
+	json_builder_add_int_value(builder, (gint64)mi2.uordblks - (gint64)mi1.uordblks);
+#endif
+
+	/* success */
+	return TRUE;
+}
+
+static gboolean
+fu_util_emulation_benchmark(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	g_autoptr(JsonBuilder) builder = json_builder_new();
+
+	/* check args */
+	if (g_strv_length(values) == 0) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_ARGS,
+				    "Invalid arguments, expected at least one device test JSON file");
+		return FALSE;
+	}
+
+	/* the results are only useful as JSON */
+	priv->as_json = TRUE;
+	priv->flags |= FWUPD_INSTALL_FLAG_ALLOW_OLDER;
+	priv->flags |= FWUPD_INSTALL_FLAG_ALLOW_REINSTALL;
+	if (!fu_util_start_engine(priv,
+				  FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_REMOTES,
+				  priv->progress,
+				  error))
+		return FALSE;
+
+	json_builder_begin_object(builder);
+	json_builder_set_member_name(builder, "Benchmarks");
+	json_builder_begin_array(builder);
+	for (guint i = 0; values[i] != NULL; i++) {
+		JsonArray *json_steps;
+		JsonNode *json_root;
+		JsonObject *json_obj;
+		const gchar *name;
+		g_autoptr(JsonParser) parser = json_parser_new();
+
+		if (!json_parser_load_from_file(parser, values[i], error))
+			return FALSE;
+		json_root = json_parser_get_root(parser);
+		if (json_root == NULL || !JSON_NODE_HOLDS_OBJECT(json_root)) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "%s invalid as not an object",
+				    values[i]);
+			return FALSE;
+		}
+		json_obj = json_node_get_object(json_root);
+		if (!json_object_has_member(json_obj, "steps")) {
+			g_set_error(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_FILE,
+				    "%s invalid as has no 'steps'",
+				    values[i]);
+			return FALSE;
+		}
+		name = json_object_get_string_member_with_default(json_obj, "name", values[i]);
+		json_steps = json_object_get_array_member(json_obj, "steps");
+		for (guint j = 0; j < json_array_get_length(json_steps); j++) {
+			JsonObject *json_step = json_array_get_object_element(json_steps, j);
+			g_autoptr(GError) error_local = NULL;
+
+			/* only steps with recorded data can be benchmarked */
+			if (!json_object_has_member(json_step, "url") ||
+			    !json_object_has_member(json_step, "emulation-url"))
+				continue;
+			json_builder_begin_object(builder);
+			json_builder_set_member_name(builder, "Name");
+			json_builder_add_string_value(builder, name);
+			if (!fu_util_emulation_benchmark_step(priv,
+							      json_step,
+							      builder,
+							      &error_local)) {
+				json_builder_set_member_name(builder, "Error");
+				json_builder_add_string_value(builder, error_local->message);
+			}
+			json_builder_end_object(builder);
+		}
+	}
+	json_builder_end_array(builder);
+	json_builder_end_object(builder);
+	return fu_util_print_builder(priv->console, builder, error);
+}
+
 static gboolean
 fu_util_install_release(FuUtilPrivate *priv, FwupdRelease *rel, GError **error)
 {
@@ -2634,8 +2979,8 @@ fu_util_firmware_parse(FuUtilPrivate *priv, gchar **values, GError **error)
 		return FALSE;
 	}
 
-	/* load file */
-	stream = fu_input_stream_from_path(values[0], error);
+	/* load file, mapping it so that the images can be views rather than copies */
+	stream = fu_input_stream_from_path_mapped(values[0], error);
 	if (stream == NULL)
 		return FALSE;
 
@@ -2655,16 +3000,18 @@ fu_util_firmware_parse(FuUtilPrivate *priv, gchar **values, GError **error)
 	} else if (g_strcmp0(values[1], "auto") == 0) {
 		g_autoptr(GPtrArray) gtype_ids = fu_context_get_firmware_gtype_ids(ctx);
 		g_autoptr(GPtrArray) firmware_auto_types = g_ptr_array_new_with_free_func(g_free);
+		g_autoptr(GArray) gtypes = g_array_new(FALSE, FALSE, sizeof(GType));
+		g_autoptr(GArray) gtypes_ranked = NULL;
+		g_autoptr(GHashTable) gtype_id_by_gtype =
+		    g_hash_table_new(g_direct_hash, g_direct_equal);
+
 		for (guint i = 0; i < gtype_ids->len; i++) {
 			const gchar *gtype_id = g_ptr_array_index(gtype_ids, i);
 			GType gtype_tmp;
-			g_autofree gchar *firmware_str = NULL;
 			g_autoptr(FuFirmware) firmware_tmp = NULL;
-			g_autoptr(GError) error_local = NULL;
 
 			if (g_strcmp0(gtype_id, "raw") == 0)
 				continue;
-			g_debug("parsing as %s", gtype_id);
 			gtype_tmp = fu_context_get_firmware_gtype_by_id(ctx, gtype_id);
 			if (gtype_tmp == G_TYPE_INVALID) {
 				g_set_error(error,
@@ -2677,6 +3024,31 @@ fu_util_firmware_parse(FuUtilPrivate *priv, gchar **values, GError **error)
 			firmware_tmp = g_object_new(gtype_tmp, NULL);
 			if (fu_firmware_has_flag(firmware_tmp, FU_FIRMWARE_FLAG_NO_AUTO_DETECTION))
 				continue;
+			if (g_hash_table_contains(gtype_id_by_gtype, GSIZE_TO_POINTER(gtype_tmp)))
+				continue;
+			g_array_append_val(gtypes, gtype_tmp);
+			g_hash_table_insert(gtype_id_by_gtype,
+					    GSIZE_TO_POINTER(gtype_tmp),
+					    (gpointer)gtype_id);
+		}
+
+		/* only parse with the types that could possibly match */
+		gtypes_ranked = fu_firmware_detect_gtypes(stream,
+							  0x0,
+							  FWUPD_INSTALL_FLAG_NO_SEARCH,
+							  gtypes,
+							  error);
+		if (gtypes_ranked == NULL)
+			return FALSE;
+		for (guint i = 0; i < gtypes_ranked->len; i++) {
+			GType gtype_tmp = g_array_index(gtypes_ranked, GType, i);
+			const gchar *gtype_id =
+			    g_hash_table_lookup(gtype_id_by_gtype, GSIZE_TO_POINTER(gtype_tmp));
+			g_autofree gchar *firmware_str = NULL;
+			g_autoptr(FuFirmware) firmware_tmp = g_object_new(gtype_tmp, NULL);
+			g_autoptr(GError) error_local = NULL;
+
+			g_debug("parsing as %s", gtype_id);
 			if (!fu_firmware_parse_stream(firmware_tmp,
 						      stream,
 						      0x0,
@@ -3445,6 +3817,33 @@ fu_util_get_remotes(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_util_startup_profile(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	g_autofree gchar *str = NULL;
+
+	/* check args */
+	if (g_strv_length(values) > 1) {
+		g_set_error_literal(error,
+				    FWUPD_ERROR,
+				    FWUPD_ERROR_INVALID_ARGS,
+				    "Invalid arguments, expected [json|trace-event]");
+		return FALSE;
+	}
+
+	/* profile the same phases as the daemon */
+	if (!fu_util_start_engine(priv,
+				  FU_ENGINE_LOAD_FLAG_COLDPLUG | FU_ENGINE_LOAD_FLAG_REMOTES,
+				  priv->progress,
+				  error))
+		return FALSE;
+	str = fu_profiler_to_string(fu_engine_get_profiler(priv->engine), values[0], error);
+	if (str == NULL)
+		return FALSE;
+	fu_console_print_literal(priv->console, str);
+	return TRUE;
+}
+
 static gboolean
 fu_util_security(FuUtilPrivate *priv, gchar **values, GError **error)
 {
@@ -4558,12 +4957,26 @@ main(int argc, char *argv[])
 			      /* TRANSLATORS: command description */
 			      _("List the available firmware GTypes"),
 			      fu_util_get_firmware_gtypes);
+	fu_util_cmd_array_add(cmd_array,
+			      "emulation-benchmark",
+			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
+			      _("FILENAME [FILENAME...]"),
+			      /* TRANSLATORS: command description */
+			      _("Measure the write performance of emulated devices"),
+			      fu_util_emulation_benchmark);
 	fu_util_cmd_array_add(cmd_array,
 			      "get-remotes",
 			      NULL,
 			      /* TRANSLATORS: command description */
 			      _("Gets the configured remotes"),
 			      fu_util_get_remotes);
+	fu_util_cmd_array_add(cmd_array,
+			      "startup-profile",
+			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */
+			      _("[FORMAT]"),
+			      /* TRANSLATORS: command description */
+			      _("Show how long each part of starting the engine took"),
+			      fu_util_startup_profile);
 	fu_util_cmd_array_add(cmd_array,
 			      "refresh",
 			      NULL,
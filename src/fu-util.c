@@ -670,6 +670,60 @@ fu_util_get_plugins(FuUtilPrivate *priv, gchar **values, GError **error)
 	return TRUE;
 }
 
+static gboolean
+fu_util_get_metrics(FuUtilPrivate *priv, gchar **values, GError **error)
+{
+	GVariant *value = NULL;
+	GVariantIter iter;
+	g_autoptr(GVariant) metrics = NULL;
+
+	/* get results from daemon */
+	metrics = fwupd_client_get_metrics(priv->client, priv->cancellable, error);
+	if (metrics == NULL)
+		return FALSE;
+	if (priv->as_json) {
+		g_autoptr(JsonBuilder) builder = json_builder_new();
+		json_builder_begin_object(builder);
+		json_builder_set_member_name(builder, "Metrics");
+		json_builder_add_value(builder, json_gvariant_serialize(metrics));
+		json_builder_end_object(builder);
+		return fu_util_print_builder(priv->console, builder, error);
+	}
+
+	/* print */
+	g_variant_iter_init(&iter, metrics);
+	while (g_variant_iter_next(&iter, "@a{sv}", &value)) {
+		const gchar *kind = NULL;
+		const gchar *name = NULL;
+		guint64 count = 0;
+		guint64 total = 0;
+		guint64 max = 0;
+
+		g_variant_lookup(value, "Kind", "&s", &kind);
+		g_variant_lookup(value, "Name", "&s", &name);
+		g_variant_lookup(value, "Count", "t", &count);
+		g_variant_lookup(value, "Total", "t", &total);
+		g_variant_lookup(value, "Max", "t", &max);
+		if (kind != NULL && name != NULL && count > 0) {
+			fu_console_print(priv->console,
+					 "%-8s %-48s %8" G_GUINT64_FORMAT " %10.2fms %10.2fms",
+					 kind,
+					 name,
+					 count,
+					 (gdouble)total / (gdouble)count / 1000.f,
+					 (gdouble)max / 1000.f);
+		}
+		g_variant_unref(value);
+	}
+	if (g_variant_n_children(metrics) == 0) {
+		/* TRANSLATORS: nothing found */
+		fu_console_print_literal(priv->console, _("No metrics recorded"));
+	}
+
+	/* success */
+	return TRUE;
+}
+
 static gchar *
 fu_util_download_if_required(FuUtilPrivate *priv, const gchar *perhapsfn, GError **error)
 {
@@ -5287,6 +5341,12 @@ main(int argc, char *argv[])
 			      /* TRANSLATORS: command description */
 			      _("Get all enabled plugins registered with the system"),
 			      fu_util_get_plugins);
+	fu_util_cmd_array_add(cmd_array,
+			      "get-metrics",
+			      NULL,
+			      /* TRANSLATORS: command description */
+			      _("Show call counts and latency for the daemon"),
+			      fu_util_get_metrics);
 	fu_util_cmd_array_add(cmd_array,
 			      "download",
 			      /* TRANSLATORS: command argument: uppercase, spaces->dashes */